@@ -90,6 +90,9 @@ else()
         )
         message("-- UnicodeCvt - iconv")
     else()
-        message("-- UnicodeCvt - none")
+        list(APPEND LIBRAGEPHOTO_DEFINES
+            UNICODE_BUILTIN
+        )
+        message("-- UnicodeCvt - builtin")
     endif()
 endif()
@@ -0,0 +1,231 @@
+/*****************************************************************************
+* libragephoto RAGE Photo Parser
+* Copyright (C) 2021-2025 Syping
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* This software is provided as-is, no warranties are given to you, we are not
+* responsible for anything with use of the software, you are self responsible.
+*****************************************************************************/
+
+#include "RagePhoto.h"
+#include "RagePhotoUnicode.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef BENCHMARK_CODECVT
+#include <codecvt>
+#include <locale>
+#endif
+
+#ifdef BENCHMARK_ICONV
+#include <iconv.h>
+#endif
+
+static const char *benchmarkHeader = "PHOTO - 10/17/26 12:00:00";
+static volatile size_t benchmarkSink;
+
+/* Returns the best time of a few runs in nanoseconds per iteration */
+template<typename Function>
+static double measure(size_t iterations, Function function)
+{
+    double best = 0;
+    for (int run = 0; run < 5; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            function();
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        if (run == 0 || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+static std::string createPhoto(uint32_t photoFormat)
+{
+    ragephoto_t instance = ragephoto_open();
+    ragephoto_setphotoformat(instance, photoFormat);
+    // Pseudo random JPEG data, only the SOI marker is checked by the parser
+    std::string jpeg(300000, '\0');
+    uint32_t seed = 0x12345678;
+    for (char &byte : jpeg) {
+        seed = seed * UINT32_C(1664525) + UINT32_C(1013904223);
+        byte = static_cast<char>(seed >> 24);
+    }
+    jpeg[0] = static_cast<char>(0xFF);
+    jpeg[1] = static_cast<char>(0xD8);
+    const uint32_t jpegBuffer = photoFormat == RAGEPHOTO_FORMAT_GTA5 ? ragephoto_defpbuf_gta5() : ragephoto_defpbuf_rdr2();
+    ragephoto_setphotojpeg(instance, jpeg.data(), static_cast<uint32_t>(jpeg.size()), jpegBuffer);
+    ragephoto_setphotojson(instance, "{\"area\":\"SANAND\",\"loc\":{\"x\":-1072.5,\"y\":-2714.8,\"z\":13.8},\"sign\":0}", 3072);
+    ragephoto_setphototitle(instance, "Benchmark", 256);
+    ragephoto_setphotodesc(instance, "", 256);
+    ragephoto_setphotoheader2(instance, benchmarkHeader, 0x12345678, 0x9ABC);
+    std::string photo(ragephoto_getsavesize(instance), '\0');
+    if (!ragephoto_save(instance, &photo[0]))
+        photo.clear();
+    ragephoto_close(instance);
+    return photo;
+}
+
+static void benchmarkUnicode(size_t iterations)
+{
+    // The GTA V/RDR 2 header is 128 UTF-16LE code units
+    char utf16[256] = {};
+    const size_t utf16_size = convertUtf8ToUtf16Le(benchmarkHeader, strlen(benchmarkHeader), utf16, sizeof(utf16));
+    std::printf("Header decode + encode (ns per header):\n");
+
+    const double builtin = measure(iterations, [&]() {
+        char header[385];
+        char encoded[256];
+        const size_t header_length = convertUtf16LeToUtf8(utf16, 128, header, sizeof(header));
+        benchmarkSink = convertUtf8ToUtf16Le(header, header_length, encoded, sizeof(encoded));
+    });
+    std::printf("  builtin: %.1f\n", builtin);
+
+#ifdef BENCHMARK_ICONV
+    // Opens a descriptor per conversion as the library does
+    const double iconv_ns = measure(iterations, [&]() {
+        char input[256];
+        char header[256];
+        char encoded[256];
+        memcpy(input, utf16, sizeof(input));
+        iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
+        size_t src_s = 256;
+        size_t dst_s = sizeof(header);
+        char *src = input;
+        char *dst = header;
+        iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+        iconv_close(iconv_in);
+        iconv_t iconv_out = iconv_open("UTF-16LE", "UTF-8");
+        src_s = strlen(header);
+        dst_s = sizeof(encoded);
+        src = header;
+        dst = encoded;
+        iconv(iconv_out, &src, &src_s, &dst, &dst_s);
+        iconv_close(iconv_out);
+        benchmarkSink = dst_s;
+    });
+    std::printf("  iconv: %.1f\n", iconv_ns);
+#endif
+
+#ifdef BENCHMARK_CODECVT
+    std::u16string utf16_string(utf16_size / sizeof(char16_t), u'\0');
+    memcpy(&utf16_string[0], utf16, utf16_size);
+    const double codecvt = measure(iterations, [&]() {
+        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>,char16_t> convert;
+        const std::string header = convert.to_bytes(utf16_string);
+        benchmarkSink = convert.from_bytes(header).size();
+    });
+    std::printf("  codecvt: %.1f\n", codecvt);
+#else
+    (void)utf16_size;
+#endif
+}
+
+static void benchmarkLayout(const char *name, const std::string &photo, size_t iterations)
+{
+    ragephoto_t instance = ragephoto_open();
+    std::string saved(photo.size(), '\0');
+    const double view = measure(iterations, [&]() {
+        RagePhotoView rp_view;
+        benchmarkSink = ragephotoview_load(&rp_view, photo.data(), photo.size());
+    });
+    const double meta = measure(iterations, [&]() {
+        benchmarkSink = ragephoto_loadmeta(instance, photo.data(), photo.size());
+    });
+    const double load = measure(iterations / 10, [&]() {
+        benchmarkSink = ragephoto_load(instance, photo.data(), photo.size());
+    });
+    const double save = measure(iterations / 10, [&]() {
+        benchmarkSink = ragephoto_save(instance, &saved[0]);
+    });
+    std::printf("  %s: view %.1f, metadata %.1f, load %.1f, save %.1f\n", name, view, meta, load, save);
+    ragephoto_close(instance);
+}
+
+static void benchmarkBatch(const std::vector<std::string> &photos, size_t count)
+{
+    std::vector<std::string> filenames;
+    for (size_t i = 0; i < count; i++) {
+        filenames.push_back("ragephoto-benchmark-" + std::to_string(i) + ".tmp");
+        FILE *file = std::fopen(filenames.back().c_str(), "wb");
+        if (!file) {
+            std::printf("Failed to write file: %s\n", filenames.back().c_str());
+            filenames.pop_back();
+            break;
+        }
+        const std::string &photo = photos[i % photos.size()];
+        std::fwrite(photo.data(), 1, photo.size(), file);
+        std::fclose(file);
+    }
+    std::vector<const char*> c_filenames;
+    std::vector<ragephoto_t> instances;
+    for (const std::string &filename : filenames) {
+        c_filenames.push_back(filename.c_str());
+        instances.push_back(ragephoto_open());
+    }
+
+    std::printf("Batch load of %zu files (files per second):\n", filenames.size());
+    const size_t maxThreads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    for (size_t threads = 1;; threads = threads * 2 < maxThreads ? threads * 2 : maxThreads) {
+        RagePhotoBatchOptions options = {};
+        options.threads = threads;
+        size_t loaded = 0;
+        const double ns = measure(1, [&]() {
+            loaded = ragephoto_loadmany(instances.data(), c_filenames.data(), instances.size(), &options);
+        });
+        std::printf("  threads %zu: %.0f (%zu loaded)\n", threads, instances.size() * 1e9 / ns, loaded);
+        if (threads == maxThreads)
+            break;
+    }
+
+    for (size_t i = 0; i < instances.size(); i++) {
+        ragephoto_close(instances[i]);
+        std::remove(c_filenames[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 3) {
+        std::printf("Usage: %s [files] [iterations]\n", argv[0]);
+        return 0;
+    }
+    const size_t files = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    if (files == 0 || iterations < 10) {
+        std::printf("Usage: %s [files] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> photos;
+    photos.push_back(createPhoto(RAGEPHOTO_FORMAT_GTA5));
+    photos.push_back(createPhoto(RAGEPHOTO_FORMAT_RDR2));
+    if (photos[0].empty() || photos[1].empty()) {
+        std::printf("Failed to create synthetic Photos\n");
+        return 1;
+    }
+    std::printf("libragephoto %s, GTA V Photo %zu bytes, RDR 2 Photo %zu bytes\n", ragephoto_version(), photos[0].size(), photos[1].size());
+
+    benchmarkUnicode(iterations);
+    std::printf("Layout table parse and serialize (ns per Photo):\n");
+    benchmarkLayout("GTA V", photos[0], iterations);
+    benchmarkLayout("RDR 2", photos[1], iterations);
+    benchmarkBatch(photos, files);
+
+    return 0;
+}
@@ -40,14 +40,271 @@
 #endif
 #endif
 
-#ifdef UNICODE_ICONV
+#if defined(RAGEPHOTO_THREADS) && !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#ifdef RAGEPHOTO_IO_URING
+#include "RagePhotoUring.h"
+#include <sys/stat.h>
+#define RAGEPHOTO_URING_DEPTH 32
+#define RAGEPHOTO_URING_READSIZE (size_t)0x40000000
+#endif
+
+#if defined(UNICODE_ICONV)
 #include <iconv.h>
+#elif defined(UNICODE_BUILTIN)
+#include "RagePhotoUnicode.h"
+#endif
+
+#include "RagePhotoJoaat.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#if defined(_POSIX_VERSION) && (_POSIX_VERSION >= 200112L)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#define RAGEPHOTO_MEMALIGN
+#define RAGEPHOTO_PREAD
+#endif
+#if defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define RAGEPHOTO_MMAP
+#endif
+#endif
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#define RAGEPHOTO_DIRECT_SAVE
 #endif
 
 /* RAGEPHOTO LIBRARY GLOBALS */
 int libraryflags = 0;
+RagePhotoSizeLimits sizelimits = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+RagePhotoAllocator libraryallocator = {NULL, NULL, NULL, NULL};
 const char* nullchar = "";
 
+/* RAGEPHOTO STORAGE TYPEDEF */
+typedef struct RagePhotoStorage {
+    size_t size;
+    // RagePhotoData objects sharing the storage, sections are copied before they are changed
+#if defined(_MSC_VER)
+    volatile long refs;
+#else
+    long refs;
+#endif
+} RagePhotoStorage;
+
+// Sections start after the aligned storage header, each section is aligned
+#define RAGEPHOTO_ALIGN_SIZE(size) (((size) + RAGEPHOTO_BUFFER_ALIGNMENT - 1) & ~(size_t)(RAGEPHOTO_BUFFER_ALIGNMENT - 1))
+#define RAGEPHOTO_STORAGE_OFFSET RAGEPHOTO_ALIGN_SIZE(sizeof(RagePhotoStorage))
+
+/* RAGEPHOTO PARSER REGISTRY TYPEDEF */
+typedef struct RagePhotoRegistrySlot {
+    RagePhotoFormatParser parser;
+    bool used;
+} RagePhotoRegistrySlot;
+
+typedef struct RagePhotoRegistry {
+    struct RagePhotoRegistry *previous;
+    size_t count;
+    size_t mask;
+    RagePhotoRegistrySlot slots[];
+} RagePhotoRegistry;
+
+/* RAGEPHOTO PARSER REGISTRY GLOBALS */
+// Published registries are immutable, replaced ones are freed by the next update when no lookup is running
+RagePhotoRegistry *parserregistry = NULL;
+#if defined(_MSC_VER)
+volatile long registryreaders = 0;
+#else
+long registryreaders = 0;
+#endif
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+SRWLOCK registrylock = SRWLOCK_INIT;
+#elif defined(RAGEPHOTO_THREADS)
+pthread_mutex_t registrylock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* RAGEPHOTO INSTANCE POOL GLOBALS */
+// Pooled instances are reset, their section buffers are kept for the next load
+ragephoto_t instancepool[16];
+size_t instancepoolsize = 0;
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+SRWLOCK poollock = SRWLOCK_INIT;
+#elif defined(RAGEPHOTO_THREADS)
+pthread_mutex_t poollock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* RAGEPHOTO BATCH TYPEDEF */
+typedef struct RagePhotoBatch {
+    ragephoto_t *instances;
+    const char **filenames;
+    size_t count;
+    size_t loaded;
+    size_t next;
+    bool metadata;
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    CRITICAL_SECTION mutex;
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_t mutex;
+#endif
+} RagePhotoBatch;
+
+#ifdef RAGEPHOTO_IO_URING
+/* RAGEPHOTO IO_URING SLOT TYPEDEF */
+typedef struct RagePhotoUringSlot {
+    char *buffer;
+    size_t bufferSize;
+    size_t fileSize;
+    size_t readPos;
+    size_t index;
+    int fd;
+    bool busy;
+} RagePhotoUringSlot;
+#endif
+
+/* RAGEPHOTO PARSER STATES */
+enum RagePhotoParserState {
+    PARSER_STATE_FORMAT,
+    PARSER_STATE_HEADER,
+    PARSER_STATE_HEADERSUM,
+    PARSER_STATE_FORMATCHECK,
+    PARSER_STATE_HEADERSUM2,
+    PARSER_STATE_EOF,
+    PARSER_STATE_JSONOFFSET,
+    PARSER_STATE_TITLOFFSET,
+    PARSER_STATE_DESCOFFSET,
+    PARSER_STATE_JPEGMARKER,
+    PARSER_STATE_JPEGBUFFER,
+    PARSER_STATE_JPEGSIZE,
+    PARSER_STATE_JPEG,
+    PARSER_STATE_JPEGPADDING,
+    PARSER_STATE_JSONMARKER,
+    PARSER_STATE_JSONBUFFER,
+    PARSER_STATE_JSON,
+    PARSER_STATE_TITLMARKER,
+    PARSER_STATE_TITLBUFFER,
+    PARSER_STATE_TITLE,
+    PARSER_STATE_DESCMARKER,
+    PARSER_STATE_DESCBUFFER,
+    PARSER_STATE_DESC,
+    PARSER_STATE_JENDMARKER,
+    PARSER_STATE_FINISHED,
+    PARSER_STATE_ERROR
+};
+
+/* RAGEPHOTO PARSER INCOMPLETE ERRORS (same order as parser states) */
+static const int32_t parserIncompleteError[] = {
+    RAGEPHOTO_ERROR_NOFORMATIDENTIFIER, // 1
+    RAGEPHOTO_ERROR_INCOMPLETEHEADER, // 3
+    RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, // 7
+    RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, // 7
+    RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, // 7
+    RAGEPHOTO_ERROR_INCOMPLETEEOF, // 8
+    RAGEPHOTO_ERROR_INCOMPLETEJSONOFFSET, // 9
+    RAGEPHOTO_ERROR_INCOMPLETETITLEOFFSET, // 10
+    RAGEPHOTO_ERROR_INCOMPLETEDESCOFFSET, // 11
+    RAGEPHOTO_ERROR_INCOMPLETEJPEGMARKER, // 12
+    RAGEPHOTO_ERROR_INCOMPLETEPHOTOBUFFER, // 14
+    RAGEPHOTO_ERROR_INCOMPLETEPHOTOSIZE, // 15
+    RAGEPHOTO_ERROR_PHOTOREADERROR, // 17
+    RAGEPHOTO_ERROR_INCOMPLETEJSONMARKER, // 18
+    RAGEPHOTO_ERROR_INCOMPLETEJSONMARKER, // 18
+    RAGEPHOTO_ERROR_INCOMPLETEJSONBUFFER, // 20
+    RAGEPHOTO_ERROR_JSONREADERROR, // 22
+    RAGEPHOTO_ERROR_INCOMPLETETITLEMARKER, // 23
+    RAGEPHOTO_ERROR_INCOMPLETETITLEBUFFER, // 25
+    RAGEPHOTO_ERROR_TITLEREADERROR, // 27
+    RAGEPHOTO_ERROR_INCOMPLETEDESCMARKER, // 28
+    RAGEPHOTO_ERROR_INCOMPLETEDESCBUFFER, // 30
+    RAGEPHOTO_ERROR_DESCREADERROR, // 32
+    RAGEPHOTO_ERROR_INCOMPLETEJENDMARKER // 33
+};
+
+/* RAGEPHOTO SECTION MARKERS (little endian) */
+#define RAGEPHOTO_MARKER_JPEG UINT32_C(0x4745504A)
+#define RAGEPHOTO_MARKER_JSON UINT32_C(0x4E4F534A)
+#define RAGEPHOTO_MARKER_TITL UINT32_C(0x4C544954)
+#define RAGEPHOTO_MARKER_DESC UINT32_C(0x43534544)
+#define RAGEPHOTO_MARKER_JEND UINT32_C(0x444E454A)
+
+/* RAGEPHOTO LAYOUT FIELDS */
+enum RagePhotoLayoutField {
+    LAYOUT_FIELD_HEADERSUM,
+    LAYOUT_FIELD_HEADERSUM2,
+    LAYOUT_FIELD_EOF,
+    LAYOUT_FIELD_JSONOFFSET,
+    LAYOUT_FIELD_TITLOFFSET,
+    LAYOUT_FIELD_DESCOFFSET,
+    LAYOUT_FIELD_JPEGBUFFER,
+    LAYOUT_FIELD_JPEGSIZE,
+    LAYOUT_FIELD_CONSTANT
+};
+
+/* RAGEPHOTO LAYOUT TYPEDEFS */
+typedef struct RagePhotoLayoutEntry {
+    uint32_t offset;
+    uint32_t field;
+    // Expected value of LAYOUT_FIELD_CONSTANT entries
+    uint32_t value;
+    // Error when the Photo ends within the entry
+    int32_t error;
+    // Error when a constant entry doesn't match
+    int32_t checkError;
+} RagePhotoLayoutEntry;
+
+typedef struct RagePhotoLayout {
+    const RagePhotoLayoutEntry *entries;
+    size_t count;
+    size_t size;
+} RagePhotoLayout;
+
+// Fixed fields following the format identifier and the 256 bytes UTF-16LE header
+static const RagePhotoLayoutEntry gta5LayoutEntries[] = {
+    {260, LAYOUT_FIELD_HEADERSUM, 0, RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, 0}, // 7
+    {264, LAYOUT_FIELD_EOF, 0, RAGEPHOTO_ERROR_INCOMPLETEEOF, 0}, // 8
+    {268, LAYOUT_FIELD_JSONOFFSET, 0, RAGEPHOTO_ERROR_INCOMPLETEJSONOFFSET, 0}, // 9
+    {272, LAYOUT_FIELD_TITLOFFSET, 0, RAGEPHOTO_ERROR_INCOMPLETETITLEOFFSET, 0}, // 10
+    {276, LAYOUT_FIELD_DESCOFFSET, 0, RAGEPHOTO_ERROR_INCOMPLETEDESCOFFSET, 0}, // 11
+    {280, LAYOUT_FIELD_CONSTANT, RAGEPHOTO_MARKER_JPEG, RAGEPHOTO_ERROR_INCOMPLETEJPEGMARKER, RAGEPHOTO_ERROR_INCORRECTJPEGMARKER}, // 12, 13
+    {284, LAYOUT_FIELD_JPEGBUFFER, 0, RAGEPHOTO_ERROR_INCOMPLETEPHOTOBUFFER, 0}, // 14
+    {288, LAYOUT_FIELD_JPEGSIZE, 0, RAGEPHOTO_ERROR_INCOMPLETEPHOTOSIZE, 0} // 15
+};
+
+static const RagePhotoLayoutEntry rdr2LayoutEntries[] = {
+    {260, LAYOUT_FIELD_HEADERSUM, 0, RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, 0}, // 7
+    {264, LAYOUT_FIELD_CONSTANT, 0, RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT}, // 7, 2
+    {268, LAYOUT_FIELD_HEADERSUM2, 0, RAGEPHOTO_ERROR_INCOMPLETECHECKSUM, 0}, // 7
+    {272, LAYOUT_FIELD_EOF, 0, RAGEPHOTO_ERROR_INCOMPLETEEOF, 0}, // 8
+    {276, LAYOUT_FIELD_JSONOFFSET, 0, RAGEPHOTO_ERROR_INCOMPLETEJSONOFFSET, 0}, // 9
+    {280, LAYOUT_FIELD_TITLOFFSET, 0, RAGEPHOTO_ERROR_INCOMPLETETITLEOFFSET, 0}, // 10
+    {284, LAYOUT_FIELD_DESCOFFSET, 0, RAGEPHOTO_ERROR_INCOMPLETEDESCOFFSET, 0}, // 11
+    {288, LAYOUT_FIELD_CONSTANT, RAGEPHOTO_MARKER_JPEG, RAGEPHOTO_ERROR_INCOMPLETEJPEGMARKER, RAGEPHOTO_ERROR_INCORRECTJPEGMARKER}, // 12, 13
+    {292, LAYOUT_FIELD_JPEGBUFFER, 0, RAGEPHOTO_ERROR_INCOMPLETEPHOTOBUFFER, 0}, // 14
+    {296, LAYOUT_FIELD_JPEGSIZE, 0, RAGEPHOTO_ERROR_INCOMPLETEPHOTOSIZE, 0} // 15
+};
+
+static const RagePhotoLayout gta5Layout = {gta5LayoutEntries, sizeof(gta5LayoutEntries) / sizeof(RagePhotoLayoutEntry), 292};
+static const RagePhotoLayout rdr2Layout = {rdr2LayoutEntries, sizeof(rdr2LayoutEntries) / sizeof(RagePhotoLayoutEntry), 300};
+#define RAGEPHOTO_LAYOUT_MAXSIZE 300
+
+/* RAGEPHOTO SECTION ENTRY TYPEDEF */
+typedef struct RagePhotoSectionEntry {
+    char **data;
+    uint32_t *buffer;
+    uint32_t *capacity;
+    uint32_t limit;
+    uint32_t marker;
+    // Loading uses the incomplete marker error, saving the buffer tight error
+    int32_t error;
+} RagePhotoSectionEntry;
+
 /* BEGIN OF STATIC LIBRARY FUNCTIONS */
 static inline FILE* openFile(const char *filename, char accessMode)
 {
@@ -83,6 +340,99 @@ static inline FILE* openFile(const char *filename, char accessMode)
     return file;
 }
 
+static inline int seekFile(FILE *file, int64_t offset, int origin)
+{
+#if defined(_WIN64)
+    return _fseeki64(file, offset, origin);
+#elif (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)
+    return fseeko(file, (off_t)offset, origin);
+#else
+    return fseek(file, (long)offset, origin);
+#endif
+}
+
+static inline int64_t tellFile(FILE *file)
+{
+#if defined(_WIN64)
+    return _ftelli64(file);
+#elif (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)
+    return ftello(file);
+#else
+    return ftell(file);
+#endif
+}
+
+#ifdef RAGEPHOTO_MMAP
+static inline char* mapFile(const char *filename, size_t *size)
+{
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0 || (uintmax_t)fileStat.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+    int mapFlags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (libraryflags & RAGEPHOTO_FLAG_MMAP_POPULATE)
+        mapFlags |= MAP_POPULATE;
+#endif
+    void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, mapFlags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+#ifdef MADV_SEQUENTIAL
+    if (libraryflags & RAGEPHOTO_FLAG_MMAP_SEQUENTIAL)
+        madvise(data, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+#endif
+    *size = (size_t)fileStat.st_size;
+    return (char*)data;
+}
+#endif
+
+#if defined(_WIN32) || defined(RAGEPHOTO_PREAD)
+static inline int64_t fileSizeFd(int fd)
+{
+#ifdef _WIN32
+    return _filelengthi64(fd);
+#else
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode))
+        return -1;
+    return (int64_t)fileStat.st_size;
+#endif
+}
+
+/* Reads exactly size bytes at offset, pread leaves the file position untouched */
+static bool readFileAt(int fd, char *data, size_t size, int64_t offset)
+{
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) == -1)
+        return false;
+    while (size) {
+        const int readSize = _read(fd, data, (size > 0x40000000) ? 0x40000000 : (unsigned int)size);
+        if (readSize <= 0)
+            return false;
+        data += readSize;
+        size -= (size_t)readSize;
+    }
+#else
+    while (size) {
+        const ssize_t readSize = pread(fd, data, size, (off_t)offset);
+        if (readSize == -1 && errno == EINTR)
+            continue;
+        if (readSize <= 0)
+            return false;
+        data += readSize;
+        size -= (size_t)readSize;
+        offset += readSize;
+    }
+#endif
+    return true;
+}
+#endif
+
 static inline size_t readBuffer(const char *input, void *output, size_t *pos, size_t outputLen, size_t inputLen)
 {
     size_t readLen = 0;
@@ -122,43 +472,305 @@ static inline size_t zeroBuffer(char *output, size_t *pos, size_t outputLen, siz
     return zeroLen;
 }
 
-static inline bool writeDataChar(const char *input, char **output)
+/* Shared by all scatter-gather saves, only ever read */
+static char zeroPage[RAGEPHOTO_SAVEIOV_ZEROSIZE];
+
+/* Entries past count are only counted, the caller retries with enough entries */
+static inline void appendIov(RagePhotoIovec *iov, size_t count, size_t *index, char *data, size_t length)
+{
+    if (*index < count) {
+        iov[*index].iov_base = data;
+        iov[*index].iov_len = length;
+    }
+    *index = *index + 1;
+}
+
+static inline void appendZeroIov(RagePhotoIovec *iov, size_t count, size_t *index, size_t length)
+{
+    while (length) {
+        const size_t zeroLen = (length > RAGEPHOTO_SAVEIOV_ZEROSIZE) ? RAGEPHOTO_SAVEIOV_ZEROSIZE : length;
+        appendIov(iov, count, index, zeroPage, zeroLen);
+        length -= zeroLen;
+    }
+}
+
+#ifdef RAGEPHOTO_DIRECT_SAVE
+static bool writeFull(int fd, const char *data, size_t length, off_t offset)
+{
+    while (length) {
+        const ssize_t written = pwrite(fd, data, length, offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+        offset += written;
+    }
+    return true;
+}
+
+/* Zero page entries are seeked past and stay holes, data runs are reserved before writing them */
+static bool writeFileIov(int fd, const RagePhotoIovec *iov, size_t count)
+{
+    off_t offset = 0;
+    size_t i = 0;
+    while (i < count) {
+        if (iov[i].iov_base == zeroPage) {
+            offset += (off_t)iov[i].iov_len;
+            i++;
+            continue;
+        }
+        size_t runLen = 0;
+        for (size_t j = i; j < count && iov[j].iov_base != zeroPage; j++)
+            runLen += iov[j].iov_len;
+        // A failed reservation only loses the preallocation, the write reports real errors
+        if (runLen)
+            posix_fallocate(fd, offset, (off_t)runLen);
+        for (; i < count && iov[i].iov_base != zeroPage; i++) {
+            if (!writeFull(fd, (const char*)iov[i].iov_base, iov[i].iov_len, offset))
+                return false;
+            offset += (off_t)iov[i].iov_len;
+        }
+    }
+    // Trailing padding is never written, the size has to be set explicitly
+    return (ftruncate(fd, offset) == 0);
+}
+
+/* Syncs the directory of a renamed file, file systems without directory sync are accepted */
+static bool syncDirectory(char *filename)
+{
+    char *separator = strrchr(filename, '/');
+    if (separator == filename)
+        separator[1] = '\0';
+    else if (separator)
+        *separator = '\0';
+    const int fd = open(separator ? filename : ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1)
+        return true;
+    const bool synced = (fsync(fd) == 0 || errno == EINVAL);
+    close(fd);
+    return synced;
+}
+
+static bool saveFileDirect(const char *filename, const RagePhotoIovec *iov, size_t count)
+{
+    // Symbolic links are kept, the file they point to is replaced
+    char *target = NULL;
+    if (libraryflags & RAGEPHOTO_FLAG_ATOMIC_SAVE) {
+        target = realpath(filename, NULL);
+        if (!target) {
+            if (errno != ENOENT)
+                return false;
+            // New files are created in place, dangling links are written through below
+            struct stat lst;
+            if (lstat(filename, &lst) != 0) {
+                target = strdup(filename);
+                if (!target)
+                    return false;
+            }
+        }
+    }
+    if (!target) {
+        const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd == -1)
+            return false;
+        const bool written = writeFileIov(fd, iov, count);
+        return (close(fd) == 0) && written;
+    }
+    // The temporary file is created next to the target, rename only replaces within the same file system
+    const size_t tempSize = strlen(target) + 32;
+    char *tempname = (char*)malloc(tempSize);
+    if (!tempname) {
+        free(target);
+        return false;
+    }
+    int fd = -1;
+    for (unsigned int i = 0; fd == -1 && i < 100; i++) {
+        snprintf(tempname, tempSize, "%s.%ld.%u.tmp", target, (long)getpid(), i);
+        fd = open(tempname, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd == -1 && errno != EEXIST)
+            break;
+    }
+    if (fd == -1) {
+        free(tempname);
+        free(target);
+        return false;
+    }
+    struct stat st;
+    if (stat(target, &st) == 0)
+        fchmod(fd, st.st_mode & 07777);
+    bool written = writeFileIov(fd, iov, count) && (fdatasync(fd) == 0);
+    written = (close(fd) == 0) && written;
+    if (written)
+        written = (rename(tempname, target) == 0);
+    if (!written)
+        unlink(tempname);
+    else
+        written = syncDirectory(target);
+    free(tempname);
+    free(target);
+    return written;
+}
+#endif
+
+static inline const RagePhotoAllocator* dataAllocator(const RagePhotoData *rp_data)
+{
+    return rp_data->allocator ? rp_data->allocator : &libraryallocator;
+}
+
+static inline void* allocBuffer(const RagePhotoData *rp_data, size_t size)
+{
+    const RagePhotoAllocator *rp_allocator = dataAllocator(rp_data);
+    if (rp_allocator->funcMalloc)
+        return (rp_allocator->funcMalloc)(size, RAGEPHOTO_BUFFER_ALIGNMENT, rp_allocator->context);
+#ifdef RAGEPHOTO_MEMALIGN
+    // Aligned buffers stay compatible with free, adopted buffers only have to be allocated with malloc
+    void *data;
+    if (posix_memalign(&data, RAGEPHOTO_BUFFER_ALIGNMENT, size) != 0)
+        return NULL;
+    return data;
+#else
+    return malloc(size);
+#endif
+}
+
+static inline void freeBuffer(const RagePhotoData *rp_data, void *data)
+{
+    const RagePhotoAllocator *rp_allocator = dataAllocator(rp_data);
+    if (!rp_allocator->funcMalloc)
+        free(data);
+    else if (data && rp_allocator->funcFree)
+        (rp_allocator->funcFree)(data, rp_allocator->context);
+}
+
+/* Only used to shrink buffers, the first size bytes are kept */
+static inline void* reallocBuffer(const RagePhotoData *rp_data, void *data, size_t size)
+{
+    const RagePhotoAllocator *rp_allocator = dataAllocator(rp_data);
+#ifndef RAGEPHOTO_MEMALIGN
+    if (!rp_allocator->funcMalloc)
+        return realloc(data, size);
+#endif
+    // realloc doesn't keep the alignment, shrinking is done with a new buffer
+    if (rp_allocator->funcMalloc && rp_allocator->funcRealloc)
+        return (rp_allocator->funcRealloc)(data, size, RAGEPHOTO_BUFFER_ALIGNMENT, rp_allocator->context);
+    void *t_data = allocBuffer(rp_data, size);
+    if (t_data) {
+        memcpy(t_data, data, size);
+        freeBuffer(rp_data, data);
+    }
+    return t_data;
+}
+
+static inline bool writeDataCharl(RagePhotoData *rp_data, const char *input, size_t length, char **output, uint32_t *capacity)
 {
     if (input) {
-        const size_t src_s = strlen(input) + 1;
-        if (*output) {
-            const size_t dst_s = strlen(*output) + 1;
+        const size_t src_s = length + 1;
+        if (*output && *capacity >= src_s) {
+            memcpy(*output, input, length);
+            (*output)[length] = '\0';
+        }
+        else if (*output) {
+            // Only buffers of unknown capacity are measured
+            const size_t dst_s = *capacity ? *capacity : strlen(*output) + 1;
             if (dst_s > src_s) {
-                char *t_output = (char*)realloc(*output, src_s);
+                char *t_output = (char*)reallocBuffer(rp_data, *output, src_s);
                 if (!t_output)
                     return false;
                 *output = t_output;
-                memcpy(*output, input, src_s);
+                *capacity = (uint32_t)src_s;
+                memcpy(*output, input, length);
+                (*output)[length] = '\0';
             }
             else if (dst_s < src_s) {
-                char *t_output = (char*)malloc(src_s);
+                char *t_output = (char*)allocBuffer(rp_data, src_s);
                 if (!t_output)
                     return false;
-                free(*output);
+                freeBuffer(rp_data, *output);
                 *output = t_output;
-                memcpy(*output, input, src_s);
+                *capacity = (uint32_t)src_s;
+                memcpy(*output, input, length);
+                (*output)[length] = '\0';
             }
             else {
-                memcpy(*output, input, src_s);
+                *capacity = (uint32_t)src_s;
+                memcpy(*output, input, length);
+                (*output)[length] = '\0';
             }
         }
         else {
-            char *t_output = (char*)malloc(src_s);
+            char *t_output = (char*)allocBuffer(rp_data, src_s);
             if (!t_output)
                 return false;
             *output = t_output;
-            memcpy(*output, input, src_s);
+            *capacity = (uint32_t)src_s;
+            memcpy(*output, input, length);
+            (*output)[length] = '\0';
         }
     }
     else if (*output) {
-        free(*output);
+        freeBuffer(rp_data, *output);
         *output = NULL;
+        *capacity = 0;
+    }
+    return true;
+}
+
+static inline bool writeDataChar(RagePhotoData *rp_data, const char *input, char **output, uint32_t *capacity)
+{
+    return writeDataCharl(rp_data, input, input ? strlen(input) : 0, output, capacity);
+}
+
+/* Moves a buffer kept by ragephotodata_reset into an empty section */
+static inline void adoptData(RagePhotoData *rp_data, char **output, uint32_t *capacity)
+{
+    char **retained;
+    uint32_t *retainedCapacity;
+    if (output == &rp_data->jpeg) {
+        retained = &rp_data->jpegRetained;
+        retainedCapacity = &rp_data->jpegRetainedCapacity;
+    }
+    else if (output == &rp_data->description) {
+        retained = &rp_data->descRetained;
+        retainedCapacity = &rp_data->descRetainedCapacity;
+    }
+    else if (output == &rp_data->json) {
+        retained = &rp_data->jsonRetained;
+        retainedCapacity = &rp_data->jsonRetainedCapacity;
+    }
+    else if (output == &rp_data->header) {
+        retained = &rp_data->headerRetained;
+        retainedCapacity = &rp_data->headerRetainedCapacity;
     }
+    else if (output == &rp_data->title) {
+        retained = &rp_data->titlRetained;
+        retainedCapacity = &rp_data->titlRetainedCapacity;
+    }
+    else {
+        return;
+    }
+    if (!*retained)
+        return;
+    *output = *retained;
+    *capacity = *retainedCapacity;
+    *retained = NULL;
+    *retainedCapacity = 0;
+}
+
+static inline bool reserveData(RagePhotoData *rp_data, char **output, uint32_t *capacity, size_t size)
+{
+    if (!*output)
+        adoptData(rp_data, output, capacity);
+    if (*output && *capacity >= size)
+        return true;
+    char *t_output = (char*)allocBuffer(rp_data, size);
+    if (!t_output)
+        return false;
+    freeBuffer(rp_data, *output);
+    *output = t_output;
+    *capacity = (uint32_t)size;
     return true;
 }
 
@@ -178,98 +790,970 @@ static inline void uInt32ToCharLE(uint32_t x, char *y)
     y[3] = x >> 24;
 }
 
-static inline uint32_t joaatFromInitial(const char *data, size_t size, uint32_t init_val)
+static inline uint32_t signInitial(uint32_t photoFormat)
 {
-    uint32_t val = init_val;
-    for (size_t i = 0; i != size; i++) {
-        val += data[i];
-        val += val << 10;
-        val ^= val >> 6;
-    }
-    val += val << 3;
-    val ^= val >> 11;
-    val += val << 15;
-    return val;
+    return (photoFormat == RAGEPHOTO_FORMAT_RDR2) ? RAGEPHOTO_SIGNINITIAL_RDR2 : RAGEPHOTO_SIGNINITIAL_GTA5;
 }
-/* END OF STATIC LIBRARY FUNCTIONS */
 
-/* BEGIN OF RAGEPHOTO CLASS */
-ragephoto_t ragephoto_open()
+static inline size_t viewBuffer(const char *input, const char **output, size_t *pos, size_t outputLen, size_t inputLen)
 {
-    RagePhotoInstance *instance = (RagePhotoInstance*)malloc(sizeof(RagePhotoInstance));
-    if (!instance)
-        return NULL;
-    instance->data = (RagePhotoData*)malloc(sizeof(RagePhotoData));
-    if (!instance->data) {
-        free(instance);
-        return NULL;
-    }
-    memset(instance->data, 0, sizeof(RagePhotoData));
-    instance->parser = (RagePhotoFormatParser*)malloc(sizeof(RagePhotoFormatParser));
-    if (!instance->parser) {
-        free(instance->data);
-        free(instance);
-        return NULL;
+    size_t viewLen = 0;
+    if (*pos >= inputLen)
+        return 0;
+    viewLen = inputLen - *pos;
+    if (viewLen > outputLen)
+        viewLen = outputLen;
+    *output = &input[*pos];
+    *pos = *pos + viewLen;
+    return viewLen;
+}
+
+static inline uint32_t viewUInt32(const char *input, size_t *pos, size_t inputLen, bool *ok)
+{
+    uint32_t value = 0;
+    *ok = (readBuffer(input, &value, pos, 4, inputLen) == 4);
+#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
+    value = swapUInt32(value);
+#endif
+    return value;
+}
+
+static inline bool decodeHeader(const char *input, char *output, size_t outputLen)
+{
+    if (!input || !output || outputLen == 0)
+        return false;
+#if defined(UNICODE_BUILTIN)
+    return (convertUtf16LeToUtf8(input, 128, output, outputLen) < UNICODE_BUILTIN_TIGHT);
+#elif defined(UNICODE_ICONV) || defined(UNICODE_WINCVT)
+    char photoHeader[258];
+    memcpy(photoHeader, input, 256);
+    photoHeader[256] = '\0';
+    photoHeader[257] = '\0';
+    size_t photoHeader_length = 0;
+    while (photoHeader_length != 128 && (photoHeader[photoHeader_length * 2] || photoHeader[photoHeader_length * 2 + 1]))
+        photoHeader_length++;
+#if defined(UNICODE_ICONV)
+    iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
+    if (iconv_in == (iconv_t)-1)
+        return false;
+    size_t src_s = photoHeader_length * 2;
+    size_t dst_s = outputLen - 1;
+    char *src = photoHeader;
+    char *dst = output;
+    const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+    iconv_close(iconv_in);
+    if (ret == (size_t)-1)
+        return false;
+    *dst = '\0';
+    return true;
+#elif defined(UNICODE_WINCVT)
+    if (photoHeader_length == 0) {
+        output[0] = '\0';
+        return true;
     }
-    memset(instance->parser, 0, sizeof(RagePhotoFormatParser));
-    ragephotodata_setbufferdefault(instance->data);
-    return instance;
+    const int converted = WideCharToMultiByte(CP_UTF8, 0, (wchar_t*)photoHeader, (int)photoHeader_length, output, (int)(outputLen - 1), NULL, NULL);
+    if (converted == 0)
+        return false;
+    output[converted] = '\0';
+    return true;
+#endif
+#else
+    return false;
+#endif
 }
 
-void ragephoto_close(ragephoto_t instance)
+#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT) || defined(UNICODE_BUILTIN)
+static inline bool loadHeader(RagePhotoData *rp_data, char *photoHeader)
 {
-    free(instance->data->jpeg);
-    free(instance->data->description);
-    free(instance->data->json);
-    free(instance->data->header);
-    free(instance->data->title);
-    free(instance->data);
-    free(instance->parser);
-    free(instance);
+#if defined(UNICODE_ICONV)
+    iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
+    if (iconv_in == (iconv_t)-1) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
+        return false;
+    }
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, 256)) {
+        rp_data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
+        iconv_close(iconv_in);
+        return false;
+    }
+    size_t src_s = 256;
+    size_t dst_s = 256;
+    char *src = photoHeader;
+    char *dst = rp_data->header;
+    const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+    iconv_close(iconv_in);
+    if (ret == (size_t)-1) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        return false;
+    }
+#elif defined(UNICODE_WINCVT)
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, 256)) {
+        rp_data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
+        return false;
+    }
+    const int converted = WideCharToMultiByte(CP_UTF8, 0, (wchar_t*)photoHeader, -1, rp_data->header, 256, NULL, NULL);
+    if (converted == 0) {
+        freeBuffer(rp_data, rp_data->header);
+        rp_data->header = NULL;
+        rp_data->headerCapacity = 0;
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        return false;
+    }
+#elif defined(UNICODE_BUILTIN)
+    char header[385];
+    const size_t header_length = convertUtf16LeToUtf8(photoHeader, 128, header, sizeof(header));
+    if (header_length >= UNICODE_BUILTIN_TIGHT) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        return false;
+    }
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, header_length + 1)) {
+        rp_data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
+        return false;
+    }
+    memcpy(rp_data->header, header, header_length + 1);
+#endif
+    return true;
 }
 
-void ragephoto_addparser(ragephoto_t instance, RagePhotoFormatParser *rp_parser)
+static inline bool saveHeader(RagePhotoData *rp_data, char *photoHeader)
 {
-    if (rp_parser) {
-        RagePhotoFormatParser n_parser;
-        memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
-        if (!memcmp(&n_parser, rp_parser, sizeof(RagePhotoFormatParser)))
-            return;
-        size_t length;
-        for (length = 0; memcmp(&n_parser, &instance->parser[length], sizeof(RagePhotoFormatParser)); length++);
-        RagePhotoFormatParser *t_parser = (RagePhotoFormatParser*)realloc(instance->parser, (length + 2) * sizeof(RagePhotoFormatParser));
-        if (!t_parser)
-            return;
-        instance->parser = t_parser;
-        memcpy(&instance->parser[length], rp_parser, sizeof(RagePhotoFormatParser));
-        memset(&instance->parser[length + 1], 0, sizeof(RagePhotoFormatParser));
+    // Writes the 256 bytes of the UTF-16LE header, zero-filled after the converted header
+#if defined(UNICODE_ICONV)
+    iconv_t iconv_in = iconv_open("UTF-16LE", "UTF-8");
+    if (iconv_in == (iconv_t)-1) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
+        return false;
+    }
+    memset(photoHeader, 0, 256);
+    size_t src_s = strlen(rp_data->header);
+    size_t dst_s = 256;
+    char *src = rp_data->header;
+    char *dst = photoHeader;
+    const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+    iconv_close(iconv_in);
+    if (ret == (size_t)-1) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        return false;
+    }
+#elif defined(UNICODE_WINCVT)
+    memset(photoHeader, 0, 256);
+    const int converted = MultiByteToWideChar(CP_UTF8, 0, rp_data->header, (int)strlen(rp_data->header), (wchar_t*)photoHeader, 256 / sizeof(wchar_t));
+    if (converted == 0) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        return false;
+    }
+#elif defined(UNICODE_BUILTIN)
+    const size_t photoHeader_size = convertUtf8ToUtf16Le(rp_data->header, strlen(rp_data->header), photoHeader, 256);
+    if (photoHeader_size == UNICODE_BUILTIN_INVALID) {
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        return false;
+    }
+    else if (photoHeader_size == UNICODE_BUILTIN_TIGHT) {
+        rp_data->error = RAGEPHOTO_ERROR_HEADERBUFFERTIGHT; // 35
+        return false;
     }
+    memset(&photoHeader[photoHeader_size], 0, 256 - photoHeader_size);
+#endif
+    return true;
 }
+#endif
 
-void ragephotodata_clear(RagePhotoData *rp_data)
+static inline bool isStorageData(const RagePhotoData *rp_data, const char *data)
 {
-    free(rp_data->jpeg);
-    free(rp_data->description);
-    free(rp_data->json);
-    free(rp_data->header);
-    free(rp_data->title);
-    memset(rp_data, 0, sizeof(RagePhotoData));
-    ragephotodata_setbufferdefault(rp_data);
+    if (!rp_data->storage || !data)
+        return false;
+    const uintptr_t storage = (uintptr_t)rp_data->storage;
+    const uintptr_t address = (uintptr_t)data;
+    return (address >= storage && address < storage + ((const RagePhotoStorage*)rp_data->storage)->size);
 }
 
-void ragephoto_clear(ragephoto_t instance)
+static inline void detachStorageData(RagePhotoData *rp_data, char **data)
 {
-    ragephotodata_clear(instance->data);
+    if (isStorageData(rp_data, *data))
+        *data = NULL;
 }
 
-RagePhotoData* ragephoto_getphotodata(ragephoto_t instance)
+static inline void retainStorage(void *storage)
 {
-    return instance->data;
+    RagePhotoStorage *rp_storage = (RagePhotoStorage*)storage;
+#if defined(_MSC_VER)
+    InterlockedIncrement(&rp_storage->refs);
+#elif defined(__GNUC__)
+    __atomic_add_fetch(&rp_storage->refs, 1, __ATOMIC_RELAXED);
+#else
+    rp_storage->refs++;
+#endif
 }
 
-bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t length)
+/* Returns true when the last reference was released */
+static inline bool releaseStorage(void *storage)
+{
+    RagePhotoStorage *rp_storage = (RagePhotoStorage*)storage;
+#if defined(_MSC_VER)
+    return (InterlockedDecrement(&rp_storage->refs) == 0);
+#elif defined(__GNUC__)
+    return (__atomic_sub_fetch(&rp_storage->refs, 1, __ATOMIC_ACQ_REL) == 0);
+#else
+    return (--rp_storage->refs == 0);
+#endif
+}
+
+static inline bool isSharedStorage(void *storage)
+{
+    RagePhotoStorage *rp_storage = (RagePhotoStorage*)storage;
+#if defined(_MSC_VER)
+    return (InterlockedCompareExchange(&rp_storage->refs, 0, 0) > 1);
+#elif defined(__GNUC__)
+    return (__atomic_load_n(&rp_storage->refs, __ATOMIC_ACQUIRE) > 1);
+#else
+    return (rp_storage->refs > 1);
+#endif
+}
+
+static inline bool shareStorageData(const RagePhotoData *rp_data, const RagePhotoData *source, char *data, char **output)
+{
+    if (!rp_data->storage || rp_data->storage != source->storage || !isStorageData(source, data))
+        return false;
+    *output = data;
+    return true;
+}
+
+static inline void freeData(RagePhotoData *rp_data)
+{
+    if (!isStorageData(rp_data, rp_data->jpeg))
+        freeBuffer(rp_data, rp_data->jpeg);
+    if (!isStorageData(rp_data, rp_data->description))
+        freeBuffer(rp_data, rp_data->description);
+    if (!isStorageData(rp_data, rp_data->json))
+        freeBuffer(rp_data, rp_data->json);
+    if (!isStorageData(rp_data, rp_data->header))
+        freeBuffer(rp_data, rp_data->header);
+    if (!isStorageData(rp_data, rp_data->title))
+        freeBuffer(rp_data, rp_data->title);
+    freeBuffer(rp_data, rp_data->jpegRetained);
+    freeBuffer(rp_data, rp_data->descRetained);
+    freeBuffer(rp_data, rp_data->jsonRetained);
+    freeBuffer(rp_data, rp_data->headerRetained);
+    freeBuffer(rp_data, rp_data->titlRetained);
+    if (rp_data->storage && releaseStorage(rp_data->storage))
+        freeBuffer(rp_data, rp_data->storage);
+}
+
+/* Keeps the larger one of a section buffer and the buffer kept before, kept buffers are invisible to getters and save */
+static inline void retainData(const RagePhotoData *rp_data, char *data, uint32_t capacity, char *retained, uint32_t retainedCapacity, char **output, uint32_t *outputCapacity)
+{
+    if (!isStorageData(rp_data, data)) {
+        if (data && capacity > retainedCapacity) {
+            freeBuffer(rp_data, retained);
+            retained = data;
+            retainedCapacity = capacity;
+        }
+        else {
+            freeBuffer(rp_data, data);
+        }
+    }
+    *output = retained;
+    *outputCapacity = retainedCapacity;
+}
+
+/* Loads a view without computing the JPEG sign, defined with the RagePhoto View Class */
+static bool loadView(RagePhotoView *rp_view, const char *data, size_t length);
+
+static inline bool loadStorage(const char *data, size_t length, RagePhotoData *rp_data, bool loadJpeg)
+{
+    RagePhotoView rp_view;
+    if (!loadView(&rp_view, data, length))
+        return false;
+    // Sections exceeding the size limits are rejected by loadData with the matching error
+    if ((loadJpeg && rp_view.jpegSize > sizelimits.jpegSize) || rp_view.jsonBuffer > sizelimits.jsonBuffer ||
+            rp_view.titlBuffer > sizelimits.titlBuffer || rp_view.descBuffer > sizelimits.descBuffer)
+        return false;
+    char photoHeader[512];
+    if (!decodeHeader(rp_view.header, photoHeader, sizeof(photoHeader)))
+        return false;
+
+    const size_t headerSize = strlen(photoHeader) + 1;
+    const size_t jpegSize = loadJpeg ? rp_view.jpegSize : 0;
+    const size_t storageSize = RAGEPHOTO_STORAGE_OFFSET + RAGEPHOTO_ALIGN_SIZE(jpegSize) + RAGEPHOTO_ALIGN_SIZE(rp_view.jsonBuffer) +
+            RAGEPHOTO_ALIGN_SIZE(rp_view.titlBuffer) + RAGEPHOTO_ALIGN_SIZE(rp_view.descBuffer) + headerSize;
+    char *storage = (char*)rp_data->storage;
+    if ((libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY) && storage && ((RagePhotoStorage*)storage)->size >= storageSize && !isSharedStorage(storage)) {
+        // Keep the storage, section buffers outside of it are released
+        ragephotodata_reset(rp_data);
+        rp_data->storage = NULL;
+        ragephotodata_clear(rp_data);
+    }
+    else {
+        storage = (char*)allocBuffer(rp_data, storageSize);
+        if (!storage)
+            return false;
+        ragephotodata_clear(rp_data);
+        ((RagePhotoStorage*)storage)->size = storageSize;
+        ((RagePhotoStorage*)storage)->refs = 1;
+    }
+    rp_data->storage = storage;
+
+    char *section = storage + RAGEPHOTO_STORAGE_OFFSET;
+    if (loadJpeg) {
+        rp_data->jpeg = section;
+        if (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN) {
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFinish(joaatCopy(signInitial(rp_view.photoFormat), section, rp_view.jpeg, jpegSize)));
+            rp_data->signFormat = rp_view.photoFormat;
+        }
+        else {
+            memcpy(section, rp_view.jpeg, jpegSize);
+        }
+        section += RAGEPHOTO_ALIGN_SIZE(jpegSize);
+    }
+    rp_data->json = section;
+    memcpy(section, rp_view.json, rp_view.jsonBuffer);
+    section += RAGEPHOTO_ALIGN_SIZE(rp_view.jsonBuffer);
+    rp_data->title = section;
+    memcpy(section, rp_view.title, rp_view.titlBuffer);
+    section += RAGEPHOTO_ALIGN_SIZE(rp_view.titlBuffer);
+    rp_data->description = section;
+    memcpy(section, rp_view.description, rp_view.descBuffer);
+    section += RAGEPHOTO_ALIGN_SIZE(rp_view.descBuffer);
+    rp_data->header = section;
+    memcpy(section, photoHeader, headerSize);
+
+    rp_data->descBuffer = rp_view.descBuffer;
+    rp_data->descOffset = rp_view.descOffset;
+    rp_data->endOfFile = rp_view.endOfFile;
+    rp_data->headerSum = rp_view.headerSum;
+    rp_data->headerSum2 = rp_view.headerSum2;
+    rp_data->jpegBuffer = rp_view.jpegBuffer;
+    rp_data->jpegSize = rp_view.jpegSize;
+    rp_data->jsonBuffer = rp_view.jsonBuffer;
+    rp_data->jsonOffset = rp_view.jsonOffset;
+    rp_data->photoFormat = rp_view.photoFormat;
+    rp_data->titlBuffer = rp_view.titlBuffer;
+    rp_data->titlOffset = rp_view.titlOffset;
+    rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+    return true;
+}
+
+static inline uint32_t parserUInt32(const char *input)
+{
+    uint32_t value;
+    memcpy(&value, input, 4);
+#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
+    value = swapUInt32(value);
+#endif
+    return value;
+}
+
+static inline const RagePhotoLayout* photoLayout(uint32_t photoFormat)
+{
+    return (photoFormat == RAGEPHOTO_FORMAT_RDR2) ? &rdr2Layout : &gta5Layout;
+}
+
+static inline bool loadLayout(const RagePhotoLayout *layout, const char *data, size_t length, uint32_t *fields, int32_t *error)
+{
+    // Length is checked once, a truncated Photo fails at its first incomplete entry
+    size_t count = layout->count;
+    *error = RAGEPHOTO_ERROR_NOERROR; // 255
+    if (length < layout->size) {
+        for (count = 0; layout->entries[count].offset + 4 <= length; count++);
+        *error = layout->entries[count].error;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const RagePhotoLayoutEntry *entry = &layout->entries[i];
+        const uint32_t value = parserUInt32(&data[entry->offset]);
+        if (entry->field != LAYOUT_FIELD_CONSTANT)
+            fields[entry->field] = value;
+        else if (value != entry->value) {
+            *error = entry->checkError;
+            return false;
+        }
+    }
+    return (*error == RAGEPHOTO_ERROR_NOERROR);
+}
+
+static inline void saveLayout(const RagePhotoLayout *layout, const uint32_t *fields, char *output)
+{
+    for (size_t i = 0; i < layout->count; i++) {
+        const RagePhotoLayoutEntry *entry = &layout->entries[i];
+        uInt32ToCharLE((entry->field != LAYOUT_FIELD_CONSTANT) ? fields[entry->field] : entry->value, &output[entry->offset]);
+    }
+}
+
+static inline void saveFields(const RagePhotoData *rp_data, uint32_t *fields)
+{
+    fields[LAYOUT_FIELD_HEADERSUM] = rp_data->headerSum;
+    fields[LAYOUT_FIELD_HEADERSUM2] = rp_data->headerSum2;
+    fields[LAYOUT_FIELD_JSONOFFSET] = rp_data->jpegBuffer + UINT32_C(28);
+    fields[LAYOUT_FIELD_TITLOFFSET] = fields[LAYOUT_FIELD_JSONOFFSET] + rp_data->jsonBuffer + UINT32_C(8);
+    fields[LAYOUT_FIELD_DESCOFFSET] = fields[LAYOUT_FIELD_TITLOFFSET] + rp_data->titlBuffer + UINT32_C(8);
+    fields[LAYOUT_FIELD_EOF] = fields[LAYOUT_FIELD_DESCOFFSET] + rp_data->descBuffer + UINT32_C(12);
+    fields[LAYOUT_FIELD_JPEGBUFFER] = rp_data->jpegBuffer;
+    fields[LAYOUT_FIELD_JPEGSIZE] = rp_data->jpegSize;
+}
+
+static inline bool loadSectionHead(const char *data, size_t length, size_t *pos, uint32_t marker, int32_t error, uint32_t *buffer, int32_t *r_error)
+{
+    // Errors follow the incomplete marker error: incorrect marker, incomplete buffer
+    const size_t remaining = (*pos < length) ? length - *pos : 0;
+    if (remaining < 4) {
+        *r_error = error;
+        return false;
+    }
+    if (parserUInt32(&data[*pos]) != marker) {
+        *r_error = error + 1;
+        return false;
+    }
+    if (remaining < 8) {
+        *r_error = error + 2;
+        return false;
+    }
+    *buffer = parserUInt32(&data[*pos + 4]);
+    *pos += 8;
+    return true;
+}
+
+static inline char* parserTarget(RagePhotoParser *rp_stream)
+{
+    switch (rp_stream->state) {
+    case PARSER_STATE_JPEG:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_JPEG) ? rp_stream->data->jpeg : NULL;
+    case PARSER_STATE_JPEGPADDING:
+        return NULL;
+    case PARSER_STATE_JSON:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_JSON) ? rp_stream->data->json : NULL;
+    case PARSER_STATE_TITLE:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_TITLE) ? rp_stream->data->title : NULL;
+    case PARSER_STATE_DESC:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_DESC) ? rp_stream->data->description : NULL;
+    default:
+        return rp_stream->buffer;
+    }
+}
+
+static inline bool parserAllocate(RagePhotoData *rp_data, char **output, uint32_t *capacity, uint32_t size, uint32_t limit, bool required)
+{
+    if (!required)
+        return true;
+    if (size > limit)
+        return false;
+    return reserveData(rp_data, output, capacity, size);
+}
+
+static bool parserNext(RagePhotoParser *rp_stream)
+{
+    RagePhotoData *rp_data = rp_stream->data;
+    const uint8_t sections = rp_stream->sections;
+    const uint32_t value = parserUInt32(rp_stream->buffer);
+    uint8_t state = rp_stream->state + 1;
+    uint32_t fieldSize = 4;
+
+    switch (rp_stream->state) {
+    case PARSER_STATE_FORMAT:
+        rp_data->photoFormat = value;
+        if (rp_data->photoFormat != RAGEPHOTO_FORMAT_GTA5 && rp_data->photoFormat != RAGEPHOTO_FORMAT_RDR2) {
+            rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
+            return false;
+        }
+#if !defined(UNICODE_ICONV) && !defined(UNICODE_WINCVT) && !defined(UNICODE_BUILTIN)
+        printf("UTF-16LE decoding support missing\n");
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
+        return false;
+#endif
+        fieldSize = 256;
+        break;
+    case PARSER_STATE_HEADER:
+#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT) || defined(UNICODE_BUILTIN)
+        if (!loadHeader(rp_data, rp_stream->buffer))
+            return false;
+#endif
+        break;
+    case PARSER_STATE_HEADERSUM:
+        rp_data->headerSum = value;
+        if (rp_data->photoFormat != RAGEPHOTO_FORMAT_RDR2)
+            state = PARSER_STATE_EOF;
+        break;
+    case PARSER_STATE_FORMATCHECK:
+        if (value != 0) {
+            rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
+            return false;
+        }
+        break;
+    case PARSER_STATE_HEADERSUM2:
+        rp_data->headerSum2 = value;
+        break;
+    case PARSER_STATE_EOF:
+        rp_data->endOfFile = value;
+        break;
+    case PARSER_STATE_JSONOFFSET:
+        rp_data->jsonOffset = value;
+        break;
+    case PARSER_STATE_TITLOFFSET:
+        rp_data->titlOffset = value;
+        break;
+    case PARSER_STATE_DESCOFFSET:
+        rp_data->descOffset = value;
+        rp_stream->completed |= RAGEPHOTO_SECTION_HEADER;
+        break;
+    case PARSER_STATE_JPEGMARKER:
+        if (memcmp(rp_stream->buffer, "JPEG", 4)) {
+            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJPEGMARKER; // 13
+            return false;
+        }
+        break;
+    case PARSER_STATE_JPEGBUFFER:
+        rp_data->jpegBuffer = value;
+        break;
+    case PARSER_STATE_JPEGSIZE:
+        rp_data->jpegSize = value;
+        // The JPEG padding would underflow, load fails at the JSON marker for the same Photo
+        if (rp_data->jpegSize > rp_data->jpegBuffer) {
+            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJSONMARKER; // 18
+            return false;
+        }
+        if (!parserAllocate(rp_data, &rp_data->jpeg, &rp_data->jpegCapacity, rp_data->jpegSize, sizelimits.jpegSize, sections & RAGEPHOTO_SECTION_JPEG)) {
+            rp_data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
+            return false;
+        }
+        // The JOAAT state is kept in jpegSign until the JPEG is complete
+        if (rp_stream->signing)
+            rp_data->jpegSign = signInitial(rp_data->photoFormat);
+        fieldSize = rp_data->jpegSize;
+        break;
+    case PARSER_STATE_JPEG:
+        if (rp_stream->signing) {
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFinish((uint32_t)rp_data->jpegSign));
+            rp_data->signFormat = rp_data->photoFormat;
+        }
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_JPEG);
+        fieldSize = rp_data->jpegBuffer - rp_data->jpegSize;
+        break;
+    case PARSER_STATE_JPEGPADDING:
+        break;
+    case PARSER_STATE_JSONMARKER:
+        if (memcmp(rp_stream->buffer, "JSON", 4)) {
+            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJSONMARKER; // 19
+            return false;
+        }
+        break;
+    case PARSER_STATE_JSONBUFFER:
+        rp_data->jsonBuffer = value;
+        if (!parserAllocate(rp_data, &rp_data->json, &rp_data->jsonCapacity, rp_data->jsonBuffer, sizelimits.jsonBuffer, sections & RAGEPHOTO_SECTION_JSON)) {
+            rp_data->error = RAGEPHOTO_ERROR_JSONMALLOCERROR; // 21
+            return false;
+        }
+        fieldSize = rp_data->jsonBuffer;
+        break;
+    case PARSER_STATE_JSON:
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_JSON);
+        break;
+    case PARSER_STATE_TITLMARKER:
+        if (memcmp(rp_stream->buffer, "TITL", 4)) {
+            rp_data->error = RAGEPHOTO_ERROR_INCORRECTTITLEMARKER; // 24
+            return false;
+        }
+        break;
+    case PARSER_STATE_TITLBUFFER:
+        rp_data->titlBuffer = value;
+        if (!parserAllocate(rp_data, &rp_data->title, &rp_data->titlCapacity, rp_data->titlBuffer, sizelimits.titlBuffer, sections & RAGEPHOTO_SECTION_TITLE)) {
+            rp_data->error = RAGEPHOTO_ERROR_TITLEMALLOCERROR; // 26
+            return false;
+        }
+        fieldSize = rp_data->titlBuffer;
+        break;
+    case PARSER_STATE_TITLE:
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_TITLE);
+        break;
+    case PARSER_STATE_DESCMARKER:
+        if (memcmp(rp_stream->buffer, "DESC", 4)) {
+            rp_data->error = RAGEPHOTO_ERROR_INCORRECTDESCMARKER; // 29
+            return false;
+        }
+        break;
+    case PARSER_STATE_DESCBUFFER:
+        rp_data->descBuffer = value;
+        if (!parserAllocate(rp_data, &rp_data->description, &rp_data->descCapacity, rp_data->descBuffer, sizelimits.descBuffer, sections & RAGEPHOTO_SECTION_DESC)) {
+            rp_data->error = RAGEPHOTO_ERROR_DESCMALLOCERROR; // 31
+            return false;
+        }
+        fieldSize = rp_data->descBuffer;
+        break;
+    case PARSER_STATE_DESC:
+        break;
+    case PARSER_STATE_JENDMARKER:
+        if (memcmp(rp_stream->buffer, "JEND", 4)) {
+            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJENDMARKER; // 34
+            return false;
+        }
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_DESC);
+        break;
+    }
+
+    rp_stream->state = state;
+    rp_stream->fieldPos = 0;
+    rp_stream->fieldSize = fieldSize;
+    if ((rp_stream->completed & sections) == sections || state == PARSER_STATE_FINISHED) {
+        rp_stream->state = PARSER_STATE_FINISHED;
+        rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+    }
+    return true;
+}
+#ifdef RAGEPHOTO_THREADS
+static inline size_t hardwareThreads(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (size_t)processors : 1;
+#else
+    return 1;
+#endif
+}
+
+static inline void initBatch(RagePhotoBatch *batch)
 {
-#ifdef RAGEPHOTO_BENCHMARK
+#ifdef _WIN32
+    InitializeCriticalSection(&batch->mutex);
+#else
+    pthread_mutex_init(&batch->mutex, NULL);
+#endif
+}
+
+static inline void destroyBatch(RagePhotoBatch *batch)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(&batch->mutex);
+#else
+    pthread_mutex_destroy(&batch->mutex);
+#endif
+}
+
+static inline void lockBatch(RagePhotoBatch *batch)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&batch->mutex);
+#else
+    pthread_mutex_lock(&batch->mutex);
+#endif
+}
+
+static inline void unlockBatch(RagePhotoBatch *batch)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&batch->mutex);
+#else
+    pthread_mutex_unlock(&batch->mutex);
+#endif
+}
+#endif
+
+// Sequentially consistent, an update either sees a running lookup or the lookup sees the new registry
+static inline RagePhotoRegistry* loadRegistry(void)
+{
+#if defined(_MSC_VER)
+    return (RagePhotoRegistry*)InterlockedCompareExchangePointer((PVOID volatile*)&parserregistry, NULL, NULL);
+#elif defined(__GNUC__)
+    return __atomic_load_n(&parserregistry, __ATOMIC_SEQ_CST);
+#else
+    return parserregistry;
+#endif
+}
+
+static inline void storeRegistry(RagePhotoRegistry *rp_registry)
+{
+#if defined(_MSC_VER)
+    InterlockedExchangePointer((PVOID volatile*)&parserregistry, rp_registry);
+#elif defined(__GNUC__)
+    __atomic_store_n(&parserregistry, rp_registry, __ATOMIC_SEQ_CST);
+#else
+    parserregistry = rp_registry;
+#endif
+}
+
+static inline void enterRegistry(void)
+{
+#if defined(_MSC_VER)
+    InterlockedIncrement(&registryreaders);
+#elif defined(__GNUC__)
+    __atomic_add_fetch(&registryreaders, 1, __ATOMIC_SEQ_CST);
+#else
+    registryreaders++;
+#endif
+}
+
+static inline void leaveRegistry(void)
+{
+#if defined(_MSC_VER)
+    InterlockedDecrement(&registryreaders);
+#elif defined(__GNUC__)
+    __atomic_sub_fetch(&registryreaders, 1, __ATOMIC_RELEASE);
+#else
+    registryreaders--;
+#endif
+}
+
+static inline bool registryQuiescent(void)
+{
+#if defined(_MSC_VER)
+    return (InterlockedCompareExchange(&registryreaders, 0, 0) == 0);
+#elif defined(__GNUC__)
+    return (__atomic_load_n(&registryreaders, __ATOMIC_SEQ_CST) == 0);
+#else
+    return (registryreaders == 0);
+#endif
+}
+
+static inline size_t registrySlot(const RagePhotoRegistry *rp_registry, uint32_t photoFormat)
+{
+    uint32_t hash = photoFormat;
+    hash ^= hash >> 16;
+    hash *= UINT32_C(0x7FEB352D);
+    hash ^= hash >> 15;
+    size_t slot = hash & rp_registry->mask;
+    while (rp_registry->slots[slot].used && rp_registry->slots[slot].parser.photoFormat != photoFormat)
+        slot = (slot + 1) & rp_registry->mask;
+    return slot;
+}
+
+/* The parser is copied, the registry can be freed after the lookup */
+static inline bool registeredParser(uint32_t photoFormat, RagePhotoFormatParser *rp_parser)
+{
+    bool found = false;
+    enterRegistry();
+    const RagePhotoRegistry *rp_registry = loadRegistry();
+    if (rp_registry) {
+        const size_t slot = registrySlot(rp_registry, photoFormat);
+        if (rp_registry->slots[slot].used) {
+            *rp_parser = rp_registry->slots[slot].parser;
+            found = true;
+        }
+    }
+    leaveRegistry();
+    return found;
+}
+
+static bool updateRegistry(uint32_t photoFormat, const RagePhotoFormatParser *rp_parser)
+{
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    AcquireSRWLockExclusive(&registrylock);
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_lock(&registrylock);
+#endif
+    RagePhotoRegistry *o_registry = loadRegistry();
+    const bool registered = o_registry && o_registry->slots[registrySlot(o_registry, photoFormat)].used;
+    const size_t count = (o_registry ? o_registry->count : 0) - (registered ? 1 : 0) + (rp_parser ? 1 : 0);
+    size_t capacity = 8;
+    while (capacity < count * 2)
+        capacity <<= 1;
+
+    // The table is rebuilt with at least half of the slots free, probing always ends on a free slot
+    RagePhotoRegistry *n_registry = NULL;
+    if (rp_parser || registered)
+        n_registry = (RagePhotoRegistry*)calloc(1, sizeof(RagePhotoRegistry) + capacity * sizeof(RagePhotoRegistrySlot));
+    if (n_registry) {
+        n_registry->previous = o_registry;
+        n_registry->count = count;
+        n_registry->mask = capacity - 1;
+        if (o_registry) {
+            for (size_t i = 0; i <= o_registry->mask; i++) {
+                if (o_registry->slots[i].used && o_registry->slots[i].parser.photoFormat != photoFormat)
+                    n_registry->slots[registrySlot(n_registry, o_registry->slots[i].parser.photoFormat)] = o_registry->slots[i];
+            }
+        }
+        if (rp_parser) {
+            RagePhotoRegistrySlot *slot = &n_registry->slots[registrySlot(n_registry, photoFormat)];
+            slot->parser = *rp_parser;
+            slot->used = true;
+        }
+        storeRegistry(n_registry);
+        // Replaced registries are kept until no lookup can still read them
+        if (registryQuiescent()) {
+            RagePhotoRegistry *p_registry = n_registry->previous;
+            n_registry->previous = NULL;
+            while (p_registry) {
+                RagePhotoRegistry *t_registry = p_registry->previous;
+                free(p_registry);
+                p_registry = t_registry;
+            }
+        }
+    }
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    ReleaseSRWLockExclusive(&registrylock);
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_unlock(&registrylock);
+#endif
+    return (n_registry != NULL);
+}
+/* END OF STATIC LIBRARY FUNCTIONS */
+
+/* BEGIN OF RAGEPHOTO CLASS */
+ragephoto_t ragephoto_open()
+{
+    RagePhotoInstance *instance = (RagePhotoInstance*)malloc(sizeof(RagePhotoInstance));
+    if (!instance)
+        return NULL;
+    instance->data = (RagePhotoData*)malloc(sizeof(RagePhotoData));
+    if (!instance->data) {
+        free(instance);
+        return NULL;
+    }
+    memset(instance->data, 0, sizeof(RagePhotoData));
+    // The parser array is allocated with the first custom parser
+    instance->parser = NULL;
+    ragephotodata_setbufferdefault(instance->data);
+    return instance;
+}
+
+void ragephoto_close(ragephoto_t instance)
+{
+    freeData(instance->data);
+    free(instance->data);
+    free(instance->parser);
+    free(instance);
+}
+
+ragephoto_t ragephoto_acquire()
+{
+    ragephoto_t instance = NULL;
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    AcquireSRWLockExclusive(&poollock);
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_lock(&poollock);
+#endif
+    if (instancepoolsize != 0)
+        instance = instancepool[--instancepoolsize];
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    ReleaseSRWLockExclusive(&poollock);
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_unlock(&poollock);
+#endif
+    if (!instance)
+        instance = ragephoto_open();
+    return instance;
+}
+
+void ragephoto_release(ragephoto_t instance)
+{
+    // A custom allocator may not outlive the current owner, the instance isn't handed to the next one
+    if (instance->data->allocator) {
+        ragephoto_close(instance);
+        return;
+    }
+    ragephotodata_reset(instance->data);
+    free(instance->parser);
+    instance->parser = NULL;
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    AcquireSRWLockExclusive(&poollock);
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_lock(&poollock);
+#endif
+    if (instancepoolsize != sizeof(instancepool) / sizeof(ragephoto_t)) {
+        instancepool[instancepoolsize++] = instance;
+        instance = NULL;
+    }
+#if defined(RAGEPHOTO_THREADS) && defined(_WIN32)
+    ReleaseSRWLockExclusive(&poollock);
+#elif defined(RAGEPHOTO_THREADS)
+    pthread_mutex_unlock(&poollock);
+#endif
+    if (instance)
+        ragephoto_close(instance);
+}
+
+void ragephoto_addparser(ragephoto_t instance, RagePhotoFormatParser *rp_parser)
+{
+    if (rp_parser) {
+        RagePhotoFormatParser n_parser;
+        memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
+        if (!memcmp(&n_parser, rp_parser, sizeof(RagePhotoFormatParser)))
+            return;
+        size_t length = 0;
+        if (instance->parser)
+            for (; memcmp(&n_parser, &instance->parser[length], sizeof(RagePhotoFormatParser)); length++);
+        RagePhotoFormatParser *t_parser = (RagePhotoFormatParser*)realloc(instance->parser, (length + 2) * sizeof(RagePhotoFormatParser));
+        if (!t_parser)
+            return;
+        instance->parser = t_parser;
+        memcpy(&instance->parser[length], rp_parser, sizeof(RagePhotoFormatParser));
+        memset(&instance->parser[length + 1], 0, sizeof(RagePhotoFormatParser));
+    }
+}
+
+bool ragephoto_registerparser(const RagePhotoFormatParser *rp_parser)
+{
+    if (!rp_parser || (!rp_parser->funcLoad && !rp_parser->funcSave && !rp_parser->funcSavep && !rp_parser->funcSaveSz))
+        return false;
+    return updateRegistry(rp_parser->photoFormat, rp_parser);
+}
+
+bool ragephoto_unregisterparser(uint32_t photoFormat)
+{
+    return updateRegistry(photoFormat, NULL);
+}
+
+void ragephotodata_clear(RagePhotoData *rp_data)
+{
+    const RagePhotoAllocator *rp_allocator = rp_data->allocator;
+    freeData(rp_data);
+    memset(rp_data, 0, sizeof(RagePhotoData));
+    rp_data->allocator = rp_allocator;
+    ragephotodata_setbufferdefault(rp_data);
+}
+
+void ragephoto_clear(ragephoto_t instance)
+{
+    ragephotodata_clear(instance->data);
+}
+
+void ragephotodata_reset(RagePhotoData *rp_data)
+{
+    RagePhotoData n_data;
+    memset(&n_data, 0, sizeof(RagePhotoData));
+    retainData(rp_data, rp_data->jpeg, rp_data->jpegCapacity, rp_data->jpegRetained, rp_data->jpegRetainedCapacity, &n_data.jpegRetained, &n_data.jpegRetainedCapacity);
+    retainData(rp_data, rp_data->description, rp_data->descCapacity, rp_data->descRetained, rp_data->descRetainedCapacity, &n_data.descRetained, &n_data.descRetainedCapacity);
+    retainData(rp_data, rp_data->json, rp_data->jsonCapacity, rp_data->jsonRetained, rp_data->jsonRetainedCapacity, &n_data.jsonRetained, &n_data.jsonRetainedCapacity);
+    retainData(rp_data, rp_data->header, rp_data->headerCapacity, rp_data->headerRetained, rp_data->headerRetainedCapacity, &n_data.headerRetained, &n_data.headerRetainedCapacity);
+    retainData(rp_data, rp_data->title, rp_data->titlCapacity, rp_data->titlRetained, rp_data->titlRetainedCapacity, &n_data.titlRetained, &n_data.titlRetainedCapacity);
+    // Shared storage can't be reused, it stays with the other RagePhotoData objects
+    if (rp_data->storage && isSharedStorage(rp_data->storage)) {
+        if (releaseStorage(rp_data->storage))
+            freeBuffer(rp_data, rp_data->storage);
+    }
+    else {
+        n_data.storage = rp_data->storage;
+    }
+    n_data.allocator = rp_data->allocator;
+    memcpy(rp_data, &n_data, sizeof(RagePhotoData));
+    ragephotodata_setbufferdefault(rp_data);
+}
+
+void ragephoto_reset(ragephoto_t instance)
+{
+    ragephotodata_reset(instance->data);
+}
+
+RagePhotoData* ragephoto_getphotodata(ragephoto_t instance)
+{
+    return instance->data;
+}
+
+RagePhotoData* ragephoto_releasephotodata(ragephoto_t instance)
+{
+    RagePhotoData *n_data = (RagePhotoData*)malloc(sizeof(RagePhotoData));
+    if (!n_data)
+        return NULL;
+    memset(n_data, 0, sizeof(RagePhotoData));
+    n_data->allocator = instance->data->allocator;
+    ragephotodata_setbufferdefault(n_data);
+    RagePhotoData *rp_data = instance->data;
+    instance->data = n_data;
+    return rp_data;
+}
+
+static bool loadData(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t length, bool loadJpeg)
+{
+#ifdef RAGEPHOTO_BENCHMARK
 #ifdef _WIN32
     LARGE_INTEGER freq, benchmark_parse_start, benchmark_parse_end;
     QueryPerformanceFrequency(&freq);
@@ -281,7 +1765,10 @@ bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser
 #endif
 
     // Avoid data conflicts
-    ragephotodata_clear(rp_data);
+    if (libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY)
+        ragephotodata_reset(rp_data);
+    else
+        ragephotodata_clear(rp_data);
 
     size_t pos = 0;
     size_t size = readBuffer(data, &rp_data->photoFormat, &pos, 4, length);
@@ -294,381 +1781,700 @@ bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser
     }
 
     if (rp_data->photoFormat == RAGEPHOTO_FORMAT_GTA5 || rp_data->photoFormat == RAGEPHOTO_FORMAT_RDR2) {
-#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT)
-        char photoHeader[256];
-        size = readBuffer(data, photoHeader, &pos, 256, length);
-        if (size != 256) {
+#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT) || defined(UNICODE_BUILTIN)
+        if (length < 260) {
             rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEHEADER; // 3
             return false;
         }
+        char photoHeader[256];
+        memcpy(photoHeader, &data[4], 256);
 
-#if defined(UNICODE_ICONV)
-        iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
-        if (iconv_in == (iconv_t)-1) {
-            rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
+        if (!loadHeader(rp_data, photoHeader))
             return false;
-        }
-        rp_data->header = (char*)malloc(256);
-        if (!rp_data->header) {
-            rp_data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
-            iconv_close(iconv_in);
-            return false;
-        }
-        size_t src_s = sizeof(photoHeader);
-        size_t dst_s = 256;
-        char *src = photoHeader;
-        char *dst = rp_data->header;
-        const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
-        iconv_close(iconv_in);
-        if (ret == (size_t)-1) {
-            rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
-            return false;
-        }
-#elif defined(UNICODE_WINCVT)
-        rp_data->header = (char*)malloc(256);
-        if (!rp_data->header) {
-            rp_data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
-            return false;
-        }
-        const int converted = WideCharToMultiByte(CP_UTF8, 0, (wchar_t*)photoHeader, -1, rp_data->header, 256, NULL, NULL);
-        if (converted == 0) {
-            free(rp_data->header);
-            rp_data->header = NULL;
-            rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+
+        const RagePhotoLayout *layout = photoLayout(rp_data->photoFormat);
+        // Fields the Photo ends before keep their default values
+        uint32_t fields[LAYOUT_FIELD_CONSTANT] = {rp_data->headerSum, rp_data->headerSum2, rp_data->endOfFile, rp_data->jsonOffset,
+                                                  rp_data->titlOffset, rp_data->descOffset, rp_data->jpegBuffer, rp_data->jpegSize};
+        const bool isLayoutLoaded = loadLayout(layout, data, length, fields, &rp_data->error);
+        rp_data->headerSum = fields[LAYOUT_FIELD_HEADERSUM];
+        rp_data->headerSum2 = fields[LAYOUT_FIELD_HEADERSUM2];
+        rp_data->endOfFile = fields[LAYOUT_FIELD_EOF];
+        rp_data->jsonOffset = fields[LAYOUT_FIELD_JSONOFFSET];
+        rp_data->titlOffset = fields[LAYOUT_FIELD_TITLOFFSET];
+        rp_data->descOffset = fields[LAYOUT_FIELD_DESCOFFSET];
+        rp_data->jpegBuffer = fields[LAYOUT_FIELD_JPEGBUFFER];
+        rp_data->jpegSize = fields[LAYOUT_FIELD_JPEGSIZE];
+        if (!isLayoutLoaded)
             return false;
-        }
-#endif
+        pos = layout->size;
 
-        size = readBuffer(data, &rp_data->headerSum, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->headerSum = swapUInt32(rp_data->headerSum);
-#endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETECHECKSUM; // 7
+        if (loadJpeg) {
+            // Check the size limit and remaining input before allocating
+            if (rp_data->jpegSize > sizelimits.jpegSize) {
+                rp_data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
+                return false;
+            }
+            if (length - pos < rp_data->jpegSize) {
+                rp_data->error = RAGEPHOTO_ERROR_PHOTOREADERROR; // 17
+                return false;
+            }
+            if (!reserveData(rp_data, &rp_data->jpeg, &rp_data->jpegCapacity, rp_data->jpegSize)) {
+                rp_data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
+                return false;
+            }
+            memcpy(rp_data->jpeg, &data[pos], rp_data->jpegSize);
+            if (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN)
+                ragephotodata_getphotosignf(rp_data, rp_data->photoFormat);
+        }
+        else if (length - pos < rp_data->jpegSize) {
+            rp_data->error = RAGEPHOTO_ERROR_PHOTOREADERROR; // 17
             return false;
         }
+        pos += rp_data->jpegSize;
 
-        if (rp_data->photoFormat == RAGEPHOTO_FORMAT_RDR2) {
-            char formatCheckBuffer[4];
-            size = readBuffer(data, formatCheckBuffer, &pos, 4, length);
-            if (size != 4) {
-                rp_data->error = RAGEPHOTO_ERROR_INCOMPLETECHECKSUM; // 7
+        pos += rp_data->jpegBuffer - rp_data->jpegSize;
+        const RagePhotoSectionEntry sections[3] = {
+            {&rp_data->json, &rp_data->jsonBuffer, &rp_data->jsonCapacity, sizelimits.jsonBuffer, RAGEPHOTO_MARKER_JSON, RAGEPHOTO_ERROR_INCOMPLETEJSONMARKER}, // 18
+            {&rp_data->title, &rp_data->titlBuffer, &rp_data->titlCapacity, sizelimits.titlBuffer, RAGEPHOTO_MARKER_TITL, RAGEPHOTO_ERROR_INCOMPLETETITLEMARKER}, // 23
+            {&rp_data->description, &rp_data->descBuffer, &rp_data->descCapacity, sizelimits.descBuffer, RAGEPHOTO_MARKER_DESC, RAGEPHOTO_ERROR_INCOMPLETEDESCMARKER} // 28
+        };
+        for (size_t i = 0; i < 3; i++) {
+            const RagePhotoSectionEntry *section = &sections[i];
+            if (!loadSectionHead(data, length, &pos, section->marker, section->error, section->buffer, &rp_data->error))
+                return false;
+            const uint32_t buffer = *section->buffer;
+            // Malloc and read errors follow the incomplete buffer error
+            if (buffer > section->limit) {
+                rp_data->error = section->error + 3;
                 return false;
             }
-            char n_formatCheckBuffer[4];
-            memset(&n_formatCheckBuffer, 0, 4);
-            if (memcmp(formatCheckBuffer, n_formatCheckBuffer, 4)) {
-                rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
+            if (length - pos < buffer) {
+                rp_data->error = section->error + 4;
                 return false;
             }
-
-            size = readBuffer(data, &rp_data->headerSum2, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-            rp_data->headerSum2 = swapUInt32(rp_data->headerSum2);
-#endif
-            if (size != 4) {
-                rp_data->error = RAGEPHOTO_ERROR_INCOMPLETECHECKSUM; // 7
+            if (!reserveData(rp_data, section->data, section->capacity, buffer)) {
+                rp_data->error = section->error + 3;
                 return false;
             }
+            memcpy(*section->data, &data[pos], buffer);
+            pos += buffer;
         }
 
-        size = readBuffer(data, &rp_data->endOfFile, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->endOfFile = swapUInt32(rp_data->endOfFile);
-#endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEEOF; // 8
+        if (pos > length || length - pos < 4) {
+            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJENDMARKER; // 33
             return false;
         }
-
-        size = readBuffer(data, &rp_data->jsonOffset, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jsonOffset = swapUInt32(rp_data->jsonOffset);
-#endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJSONOFFSET; // 9
+        if (parserUInt32(&data[pos]) != RAGEPHOTO_MARKER_JEND) {
+            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJENDMARKER; // 34
             return false;
         }
-        size = readBuffer(data, &rp_data->titlOffset, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->titlOffset = swapUInt32(rp_data->titlOffset);
+
+#ifdef RAGEPHOTO_BENCHMARK
+#ifdef _WIN32
+        QueryPerformanceCounter(&benchmark_parse_end);
+        const uint64_t benchmark_ns = (benchmark_parse_end.QuadPart - benchmark_parse_start.QuadPart) * INT64_C(1000000000) / freq.QuadPart;
+#else
+        clock_gettime(CLOCK_MONOTONIC, &benchmark_parse_end);
+        const uint64_t benchmark_ns = (UINT64_C(1000000000) * benchmark_parse_end.tv_sec + benchmark_parse_end.tv_nsec) -
+                                      (UINT64_C(1000000000) * benchmark_parse_start.tv_sec + benchmark_parse_start.tv_nsec);
+#endif
+        printf("Benchmark: %" PRIu64 "ns\n", benchmark_ns);
 #endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETETITLEOFFSET; // 10
-            return false;
-        }
 
-        size = readBuffer(data, &rp_data->descOffset, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->descOffset = swapUInt32(rp_data->descOffset);
+#ifdef RAGEPHOTO_DEBUG
+        const uint32_t jsonOffset = rp_data->jpegBuffer + UINT32_C(28);
+        const uint32_t titlOffset = jsonOffset + rp_data->jsonBuffer + UINT32_C(8);
+        const uint32_t descOffset = titlOffset + rp_data->titlBuffer + UINT32_C(8);
+        const uint32_t endOfFile = descOffset + rp_data->descBuffer + UINT32_C(12);
+        printf("header: %s\n", rp_data->header);
+        printf("headerSum: %" PRIu32 "\n", rp_data->headerSum);
+        printf("headerSum2: %" PRIu32 "\n", rp_data->headerSum2);
+        printf("photoBuffer: %" PRIu32 "\n", rp_data->jpegBuffer);
+        printf("descBuffer: %" PRIu32 "\n", rp_data->descBuffer);
+        printf("descOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->descOffset, descOffset);
+        printf("description: %s\n", rp_data->description);
+        printf("jsonBuffer: %" PRIu32 "\n", rp_data->jsonBuffer);
+        printf("jsonOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->jsonOffset, jsonOffset);
+        printf("json: %s\n", rp_data->json);
+        printf("sign: %" PRIu64 "\n", ragephotodata_getphotosign(rp_data));
+        printf("titlBuffer: %" PRIu32 "\n", rp_data->titlBuffer);
+        printf("titlOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->titlOffset, titlOffset);
+        printf("title: %s\n", rp_data->title);
+        printf("eofOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->endOfFile, endOfFile);
+        printf("size: %zu / %zu\n", length, ragephotodata_getsavesize(rp_data, NULL));
 #endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEDESCOFFSET; // 11
-            return false;
+
+        rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+        return true;
+#else
+        printf("UTF-16LE decoding support missing\n");
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
+        return false;
+#endif
+    }
+    else {
+        if (libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY) {
+            // Custom parsers expect cleared data
+            const uint32_t photoFormat = rp_data->photoFormat;
+            ragephotodata_clear(rp_data);
+            rp_data->photoFormat = photoFormat;
         }
+        if (rp_parser) {
+            RagePhotoFormatParser n_parser;
+            memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
+            for (size_t i = 0; memcmp(&n_parser, &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
+                if (rp_data->photoFormat == rp_parser[i].photoFormat)
+                    if (rp_parser[i].funcLoad)
+                        return (rp_parser[i].funcLoad)(rp_data, data, length);
+            }
+        }
+        RagePhotoFormatParser r_parser;
+        if (registeredParser(rp_data->photoFormat, &r_parser) && r_parser.funcLoad)
+            return (r_parser.funcLoad)(rp_data, data, length);
+    }
+    rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
+    return false;
+}
 
-        char markerBuffer[4];
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJPEGMARKER; // 12
-            return false;
+bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t length)
+{
+    if ((libraryflags & RAGEPHOTO_FLAG_ARENA_STORAGE) && loadStorage(data, length, rp_data, true))
+        return true;
+    return loadData(rp_data, rp_parser, data, length, true);
+}
+
+bool ragephotodata_loadmeta(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t length)
+{
+    if ((libraryflags & RAGEPHOTO_FLAG_ARENA_STORAGE) && loadStorage(data, length, rp_data, false))
+        return true;
+    return loadData(rp_data, rp_parser, data, length, false);
+}
+
+bool ragephoto_load(ragephoto_t instance, const char *data, size_t size)
+{
+    return ragephotodata_load(instance->data, instance->parser, data, size);
+}
+
+bool ragephoto_loadmeta(ragephoto_t instance, const char *data, size_t size)
+{
+    return ragephotodata_loadmeta(instance->data, instance->parser, data, size);
+}
+
+static bool loadFileBuffer(ragephoto_t instance, const char *filename, char **buffer, size_t *bufferSize)
+{
+#ifdef RAGEPHOTO_MMAP
+    if (!(libraryflags & RAGEPHOTO_FLAG_DISABLE_MMAP)) {
+        size_t mapSize;
+        char *mapData = mapFile(filename, &mapSize);
+        if (mapData) {
+            const bool isLoaded = ragephotodata_load(instance->data, instance->parser, mapData, mapSize);
+            munmap(mapData, mapSize);
+            return isLoaded;
         }
-        if (memcmp(markerBuffer, "JPEG", 4)) {
-            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJPEGMARKER; // 13
+    }
+#endif
+    FILE *file = openFile(filename, 'r');
+    if (!file)
+        return false;
+    if (seekFile(file, 0, SEEK_END) == -1) {
+        fclose(file);
+        return false;
+    }
+    const int64_t fileSize = tellFile(file);
+    if (fileSize == -1 || (uint64_t)fileSize > SIZE_MAX) {
+        fclose(file);
+        return false;
+    }
+    if (seekFile(file, 0, SEEK_SET) == -1) {
+        fclose(file);
+        return false;
+    }
+    // The buffer only grows, batch loads reuse it for every file of a worker
+    if ((size_t)fileSize > *bufferSize) {
+        char *data = (char*)realloc(*buffer, (size_t)fileSize);
+        if (!data) {
+            fclose(file);
             return false;
         }
+        *buffer = data;
+        *bufferSize = (size_t)fileSize;
+    }
+    const size_t readSize = fread(*buffer, sizeof(char), (size_t)fileSize, file);
+    fclose(file);
+    if ((size_t)fileSize != readSize)
+        return false;
+    return ragephotodata_load(instance->data, instance->parser, *buffer, (size_t)fileSize);
+}
+
+bool ragephoto_loadfile(ragephoto_t instance, const char *filename)
+{
+    char *buffer = NULL;
+    size_t bufferSize = 0;
+    const bool isLoaded = loadFileBuffer(instance, filename, &buffer, &bufferSize);
+    free(buffer);
+    return isLoaded;
+}
 
-        size = readBuffer(data, &rp_data->jpegBuffer, &pos, 4, length);
+bool ragephoto_loadmetafd(ragephoto_t instance, int fd)
+{
+#if defined(_WIN32) || defined(RAGEPHOTO_PREAD)
+    const int64_t fileSize = fileSizeFd(fd);
+    if (fileSize == -1 || (uint64_t)fileSize > SIZE_MAX)
+        return false;
+
+    char photoHead[RAGEPHOTO_RDR2_HEADERSIZE + 28];
+    const size_t headSize = ((uint64_t)fileSize < sizeof(photoHead)) ? (size_t)fileSize : sizeof(photoHead);
+    if (!readFileAt(fd, photoHead, headSize, 0))
+        return false;
+    uint32_t photoFormat = 0;
+    if (headSize >= 4) {
+        memcpy(&photoFormat, photoHead, 4);
 #ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jpegBuffer = swapUInt32(rp_data->jpegBuffer);
+        photoFormat = swapUInt32(photoFormat);
 #endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEPHOTOBUFFER; // 14
+    }
+
+    if (photoFormat != RAGEPHOTO_FORMAT_GTA5 && photoFormat != RAGEPHOTO_FORMAT_RDR2) {
+        // Other formats have no known layout, fallback to reading the whole file
+        char *data = (char*)malloc((size_t)fileSize);
+        if (!data || !readFileAt(fd, data, (size_t)fileSize, 0)) {
+            free(data);
             return false;
         }
+        const bool isLoaded = ragephotodata_loadmeta(instance->data, instance->parser, data, (size_t)fileSize);
+        free(data);
+        return isLoaded;
+    }
+
+    const size_t jpegStart = (photoFormat == RAGEPHOTO_FORMAT_GTA5 ? RAGEPHOTO_GTA5_HEADERSIZE : RAGEPHOTO_RDR2_HEADERSIZE) + 28;
+    if (headSize < jpegStart)
+        return ragephotodata_loadmeta(instance->data, instance->parser, photoHead, headSize);
 
-        size = readBuffer(data, &rp_data->jpegSize, &pos, 4, length);
+    uint32_t endOfFile, jpegBuffer, jpegSize;
+    memcpy(&endOfFile, &photoHead[jpegStart - 28], 4);
+    memcpy(&jpegBuffer, &photoHead[jpegStart - 8], 4);
+    memcpy(&jpegSize, &photoHead[jpegStart - 4], 4);
 #ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jpegSize = swapUInt32(rp_data->jpegSize);
+    endOfFile = swapUInt32(endOfFile);
+    jpegBuffer = swapUInt32(jpegBuffer);
+    jpegSize = swapUInt32(jpegSize);
 #endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEPHOTOSIZE; // 15
-            return false;
-        }
+    if ((uint64_t)fileSize - jpegStart < jpegSize)
+        return ragephotodata_loadmeta(instance->data, instance->parser, photoHead, jpegStart);
+
+    // JSON, TITL, DESC and JEND follow the JPEG buffer, data after the End Of File offset isn't read
+    const uint64_t metaStart = (uint64_t)jpegStart + jpegBuffer;
+    const uint64_t eofOffset = (uint64_t)(jpegStart - 28) + endOfFile;
+    const uint64_t metaEnd = (eofOffset > metaStart && eofOffset < (uint64_t)fileSize) ? eofOffset : (uint64_t)fileSize;
+    size_t metaSize = 0;
+    if (jpegBuffer >= jpegSize && metaStart < metaEnd)
+        metaSize = (size_t)(metaEnd - metaStart);
+
+    // The JPEG sizes are zeroed so the loader continues directly with the JSON section
+    char *data = (char*)malloc(jpegStart + metaSize);
+    if (!data)
+        return false;
+    memcpy(data, photoHead, jpegStart);
+    memset(&data[jpegStart - 8], 0, 8);
+    if (metaSize && !readFileAt(fd, &data[jpegStart], metaSize, (int64_t)metaStart)) {
+        free(data);
+        return false;
+    }
 
-        rp_data->jpeg = (char*)malloc(rp_data->jpegSize);
-        if (!rp_data->jpeg) {
-            rp_data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
-            return false;
-        }
-        size = readBuffer(data, rp_data->jpeg, &pos, rp_data->jpegSize, length);
-        if (size != rp_data->jpegSize) {
-            free(rp_data->jpeg);
-            rp_data->jpeg = NULL;
-            rp_data->error = RAGEPHOTO_ERROR_PHOTOREADERROR; // 17
-            return false;
-        }
+    const bool isLoaded = ragephotodata_loadmeta(instance->data, instance->parser, data, jpegStart + metaSize);
+    free(data);
+    if (instance->data->error > RAGEPHOTO_ERROR_INCOMPLETEPHOTOSIZE) {
+        instance->data->jpegBuffer = jpegBuffer;
+        instance->data->jpegSize = jpegSize;
+    }
+    return isLoaded;
+#else
+    (void)instance;
+    (void)fd;
+    return false;
+#endif
+}
 
-        pos += rp_data->jpegBuffer - rp_data->jpegSize;
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJSONMARKER; // 18
-            return false;
-        }
-        if (memcmp(markerBuffer, "JSON", 4)) {
-            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJSONMARKER; // 19
-            return false;
-        }
+bool ragephoto_loadmetafile(ragephoto_t instance, const char *filename)
+{
+#if defined(_WIN32)
+    FILE *file = openFile(filename, 'r');
+    if (!file)
+        return false;
+    const bool isLoaded = ragephoto_loadmetafd(instance, _fileno(file));
+    fclose(file);
+    return isLoaded;
+#elif defined(RAGEPHOTO_PREAD)
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+        return false;
+    const bool isLoaded = ragephoto_loadmetafd(instance, fd);
+    close(fd);
+    return isLoaded;
+#else
+    // Without positioned reads the whole Photo is loaded
+    return ragephoto_loadfile(instance, filename);
+#endif
+}
+
+bool ragephoto_validate(const char *data, size_t size, RagePhotoValidation *rp_validation)
+{
+    memset(rp_validation, 0, sizeof(RagePhotoValidation));
+
+    RagePhotoView rp_view;
+    const bool isLoaded = loadView(&rp_view, data, size);
+    rp_validation->error = rp_view.error;
+    rp_validation->descBuffer = rp_view.descBuffer;
+    rp_validation->descOffset = rp_view.descOffset;
+    rp_validation->endOfFile = rp_view.endOfFile;
+    rp_validation->jpegBuffer = rp_view.jpegBuffer;
+    rp_validation->jpegSize = rp_view.jpegSize;
+    rp_validation->jsonBuffer = rp_view.jsonBuffer;
+    rp_validation->jsonOffset = rp_view.jsonOffset;
+    rp_validation->photoFormat = rp_view.photoFormat;
+    rp_validation->titlBuffer = rp_view.titlBuffer;
+    rp_validation->titlOffset = rp_view.titlOffset;
+    if (rp_view.jpeg)
+        rp_validation->jpegPos = (size_t)(rp_view.jpeg - data);
+    if (rp_view.json)
+        rp_validation->jsonPos = (size_t)(rp_view.json - data);
+    if (rp_view.title)
+        rp_validation->titlPos = (size_t)(rp_view.title - data);
+    if (rp_view.description)
+        rp_validation->descPos = (size_t)(rp_view.description - data);
+
+    // Error codes are ordered by position, every section before the failing one has been read
+#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT) || defined(UNICODE_BUILTIN)
+    char photoHeader[512];
+    if (rp_view.header && !decodeHeader(rp_view.header, photoHeader, sizeof(photoHeader)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_HEADERUNICODE;
+#endif
+    if (rp_view.error > RAGEPHOTO_ERROR_INCOMPLETEPHOTOSIZE && rp_view.jpegSize > rp_view.jpegBuffer)
+        rp_validation->issues |= RAGEPHOTO_ISSUE_JPEGSIZE;
+    if (rp_view.error > RAGEPHOTO_ERROR_PHOTOREADERROR &&
+            (rp_view.jpegSize < 2 || (unsigned char)rp_view.jpeg[0] != 0xFF || (unsigned char)rp_view.jpeg[1] != 0xD8))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_JPEGMARKER;
+    if (rp_view.error > RAGEPHOTO_ERROR_JSONREADERROR && (rp_view.jsonBuffer == 0 || !memchr(rp_view.json, 0, rp_view.jsonBuffer)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_JSONSTRING;
+    if (rp_view.error > RAGEPHOTO_ERROR_TITLEREADERROR && (rp_view.titlBuffer == 0 || !memchr(rp_view.title, 0, rp_view.titlBuffer)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_TITLESTRING;
+    if (rp_view.error > RAGEPHOTO_ERROR_DESCREADERROR && (rp_view.descBuffer == 0 || !memchr(rp_view.description, 0, rp_view.descBuffer)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_DESCSTRING;
+
+    if (isLoaded) {
+        const uint32_t jsonOffset = rp_view.jpegBuffer + UINT32_C(28);
+        const uint32_t titlOffset = jsonOffset + rp_view.jsonBuffer + UINT32_C(8);
+        const uint32_t descOffset = titlOffset + rp_view.titlBuffer + UINT32_C(8);
+        const uint32_t endOfFile = descOffset + rp_view.descBuffer + UINT32_C(12);
+        if (rp_view.jsonOffset != jsonOffset)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_JSONOFFSET;
+        if (rp_view.titlOffset != titlOffset)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_TITLEOFFSET;
+        if (rp_view.descOffset != descOffset)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_DESCOFFSET;
+        if (rp_view.endOfFile != endOfFile)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_ENDOFFILE;
+        rp_validation->photoSize = rp_validation->descPos + rp_view.descBuffer + 4;
+    }
 
-        size = readBuffer(data, &rp_data->jsonBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jsonBuffer = swapUInt32(rp_data->jsonBuffer);
+    return (isLoaded && rp_validation->issues == 0);
+}
+
+static inline size_t nextBatchIndex(RagePhotoBatch *batch)
+{
+#ifdef RAGEPHOTO_THREADS
+    lockBatch(batch);
 #endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJSONBUFFER; // 20
-            return false;
-        }
+    const size_t index = batch->next++;
+#ifdef RAGEPHOTO_THREADS
+    unlockBatch(batch);
+#endif
+    // Errors before the Photo is parsed are file access errors
+    if (index < batch->count)
+        batch->instances[index]->data->error = RAGEPHOTO_ERROR_UNINITIALISED; // 0
+    return index;
+}
 
-        rp_data->json = (char*)malloc(rp_data->jsonBuffer);
-        if (!rp_data->json) {
-            rp_data->error = RAGEPHOTO_ERROR_JSONMALLOCERROR; // 21
-            return false;
-        }
-        size = readBuffer(data, rp_data->json, &pos, rp_data->jsonBuffer, length);
-        if (size != rp_data->jsonBuffer) {
-            free(rp_data->json);
-            rp_data->json = NULL;
-            rp_data->error = RAGEPHOTO_ERROR_JSONREADERROR; // 22
+#ifdef RAGEPHOTO_IO_URING
+static bool prepareSlotUring(RagePhotoUringSlot *slot)
+{
+    struct stat fileStat;
+    if (fstat(slot->fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode) || (uintmax_t)fileStat.st_size > SIZE_MAX)
+        return false;
+    slot->fileSize = (size_t)fileStat.st_size;
+    slot->readPos = 0;
+    // The buffer only grows, the slot reuses it for every file
+    if (slot->fileSize > slot->bufferSize) {
+        char *buffer = (char*)realloc(slot->buffer, slot->fileSize);
+        if (!buffer)
             return false;
-        }
+        slot->buffer = buffer;
+        slot->bufferSize = slot->fileSize;
+    }
+    return true;
+}
 
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETETITLEMARKER; // 23
-            return false;
-        }
-        if (memcmp(markerBuffer, "TITL", 4)) {
-            rp_data->error = RAGEPHOTO_ERROR_INCORRECTTITLEMARKER; // 24
-            return false;
-        }
+static bool readSlotUring(RagePhotoUring *ring, RagePhotoUringSlot *slot, uint64_t slotIndex)
+{
+    struct io_uring_sqe *sqe = uringGetSqe(ring);
+    if (!sqe)
+        return false;
+    size_t length = slot->fileSize - slot->readPos;
+    if (length > RAGEPHOTO_URING_READSIZE)
+        length = RAGEPHOTO_URING_READSIZE;
+    uringPrepRead(sqe, slot->fd, &slot->buffer[slot->readPos], (uint32_t)length, slot->readPos, slotIndex);
+    return true;
+}
 
-        size = readBuffer(data, &rp_data->titlBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->titlBuffer = swapUInt32(rp_data->titlBuffer);
-#endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETETITLEBUFFER; // 25
-            return false;
-        }
+static void finishSlotUring(RagePhotoBatch *batch, RagePhotoUringSlot *slot, bool isRead, size_t *loaded)
+{
+    ragephoto_t instance = batch->instances[slot->index];
+    if (slot->fd != -1)
+        close(slot->fd);
+    // Failed and unsupported operations fall back to the blocking loader
+    const bool isLoaded = isRead ?
+                              ragephotodata_load(instance->data, instance->parser, slot->buffer, slot->fileSize) :
+                              loadFileBuffer(instance, batch->filenames[slot->index], &slot->buffer, &slot->bufferSize);
+    if (isLoaded)
+        (*loaded)++;
+    slot->busy = false;
+}
 
-        rp_data->title = (char*)malloc(rp_data->titlBuffer);
-        if (!rp_data->title) {
-            rp_data->error = RAGEPHOTO_ERROR_TITLEMALLOCERROR; // 26
-            return false;
+/* Collects the completions of requests the kernel already took, false when waiting for them fails */
+static bool drainSlotsUring(RagePhotoUring *ring, RagePhotoUringSlot *slots, size_t inFlight)
+{
+    // Entries left in the submission queue were never taken by the kernel
+    size_t pending = inFlight - uringUnconsumed(ring);
+    while (pending) {
+        uint64_t slotIndex;
+        int32_t result;
+        while (pending && uringPopCqe(ring, &slotIndex, &result)) {
+            RagePhotoUringSlot *slot = &slots[slotIndex];
+            // A late open still returns a descriptor, it's closed with the slot
+            if (slot->fd == -1 && result >= 0)
+                slot->fd = result;
+            pending--;
         }
-        size = readBuffer(data, rp_data->title, &pos, rp_data->titlBuffer, length);
-        if (size != rp_data->titlBuffer) {
-            free(rp_data->title);
-            rp_data->title = NULL;
-            rp_data->error = RAGEPHOTO_ERROR_TITLEREADERROR; // 27
+        if (pending && uringWait(ring, 1) == -1)
             return false;
-        }
+    }
+    return true;
+}
 
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEDESCMARKER; // 28
-            return false;
+static bool loadBatchUring(RagePhotoBatch *batch, size_t *loaded)
+{
+    RagePhotoUring ring;
+    if (!uringInit(&ring, RAGEPHOTO_URING_DEPTH))
+        return false;
+    RagePhotoUringSlot slots[RAGEPHOTO_URING_DEPTH];
+    memset(slots, 0, sizeof(slots));
+    size_t inFlight = 0;
+    bool failed = false;
+    bool queued = true;
+    for (;;) {
+        // Keep every slot busy with an open or read while files are left
+        for (size_t i = 0; queued && i < RAGEPHOTO_URING_DEPTH; i++) {
+            if (slots[i].busy)
+                continue;
+            const size_t index = nextBatchIndex(batch);
+            if (index >= batch->count) {
+                queued = false;
+                break;
+            }
+            slots[i].index = index;
+            slots[i].fd = -1;
+            slots[i].busy = true;
+            struct io_uring_sqe *sqe = uringGetSqe(&ring);
+            if (!sqe) {
+                finishSlotUring(batch, &slots[i], false, loaded);
+                continue;
+            }
+            uringPrepOpen(sqe, batch->filenames[index], i);
+            inFlight++;
         }
-        if (memcmp(markerBuffer, "DESC", 4)) {
-            rp_data->error = RAGEPHOTO_ERROR_INCORRECTDESCMARKER; // 29
-            return false;
+        if (inFlight == 0)
+            break;
+        if (uringSubmitAndWait(&ring, 1) == -1) {
+            failed = true;
+            if (!drainSlotsUring(&ring, slots, inFlight)) {
+                for (size_t i = 0; i < RAGEPHOTO_URING_DEPTH; i++) {
+                    // The kernel may still complete reads into the buffers of busy slots, they are leaked instead of reused
+                    if (slots[i].busy) {
+                        slots[i].buffer = NULL;
+                        slots[i].bufferSize = 0;
+                    }
+                }
+            }
+            break;
         }
-
-        size = readBuffer(data, &rp_data->descBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->descBuffer = swapUInt32(rp_data->descBuffer);
-#endif
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEDESCBUFFER; // 30
-            return false;
+        uint64_t slotIndex;
+        int32_t result;
+        while (uringPopCqe(&ring, &slotIndex, &result)) {
+            RagePhotoUringSlot *slot = &slots[slotIndex];
+            bool isRead = false;
+            if (slot->fd == -1) {
+                if (result >= 0) {
+                    slot->fd = result;
+                    if (prepareSlotUring(slot)) {
+                        if (slot->fileSize == 0)
+                            isRead = true;
+                        else if (readSlotUring(&ring, slot, slotIndex))
+                            continue;
+                    }
+                }
+            }
+            else if (result > 0) {
+                slot->readPos += (size_t)result;
+                if (slot->readPos == slot->fileSize)
+                    isRead = true;
+                else if (readSlotUring(&ring, slot, slotIndex))
+                    continue;
+            }
+            else if ((result == -EINTR || result == -EAGAIN) && readSlotUring(&ring, slot, slotIndex)) {
+                continue;
+            }
+            finishSlotUring(batch, slot, isRead, loaded);
+            inFlight--;
         }
+    }
+    uringClose(&ring);
+    for (size_t i = 0; i < RAGEPHOTO_URING_DEPTH; i++) {
+        // Only reached with busy slots when the ring fails, load them blocking
+        if (slots[i].busy)
+            finishSlotUring(batch, &slots[i], false, loaded);
+        free(slots[i].buffer);
+    }
+    // Files never queued are left to the blocking loader of the caller
+    return !failed;
+}
+#endif
 
-        rp_data->description = (char*)malloc(rp_data->descBuffer);
-        if (!rp_data->description) {
-            rp_data->error = RAGEPHOTO_ERROR_DESCMALLOCERROR; // 31
-            return false;
-        }
-        size = readBuffer(data, rp_data->description, &pos, rp_data->descBuffer, length);
-        if (size != rp_data->descBuffer) {
-            free(rp_data->description);
-            rp_data->description = NULL;
-            rp_data->error = RAGEPHOTO_ERROR_DESCREADERROR; // 32
-            return false;
+static void loadBatch(RagePhotoBatch *batch)
+{
+    size_t loaded = 0;
+#ifdef RAGEPHOTO_IO_URING
+    if (batch->metadata || (libraryflags & RAGEPHOTO_FLAG_DISABLE_IO_URING) || !loadBatchUring(batch, &loaded)) {
+#endif
+        char *buffer = NULL;
+        size_t bufferSize = 0;
+        size_t index;
+        while ((index = nextBatchIndex(batch)) < batch->count) {
+            ragephoto_t instance = batch->instances[index];
+            const bool isLoaded = batch->metadata ?
+                                      ragephoto_loadmetafile(instance, batch->filenames[index]) :
+                                      loadFileBuffer(instance, batch->filenames[index], &buffer, &bufferSize);
+            if (isLoaded)
+                loaded++;
         }
+        free(buffer);
+#ifdef RAGEPHOTO_IO_URING
+    }
+#endif
+#ifdef RAGEPHOTO_THREADS
+    lockBatch(batch);
+#endif
+    batch->loaded += loaded;
+#ifdef RAGEPHOTO_THREADS
+    unlockBatch(batch);
+#endif
+}
 
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEJENDMARKER; // 33
-            return false;
-        }
-        if (memcmp(markerBuffer, "JEND", 4)) {
-            rp_data->error = RAGEPHOTO_ERROR_INCORRECTJENDMARKER; // 34
-            return false;
-        }
+#ifdef RAGEPHOTO_THREADS
+#ifdef _WIN32
+static DWORD WINAPI loadBatchThread(LPVOID batch)
+{
+    loadBatch((RagePhotoBatch*)batch);
+    return 0;
+}
+#else
+static void* loadBatchThread(void *batch)
+{
+    loadBatch((RagePhotoBatch*)batch);
+    return NULL;
+}
+#endif
+#endif
 
+size_t ragephoto_loadmany(ragephoto_t *instances, const char **filenames, size_t count, const RagePhotoBatchOptions *options)
+{
 #ifdef RAGEPHOTO_BENCHMARK
 #ifdef _WIN32
-        QueryPerformanceCounter(&benchmark_parse_end);
-        const uint64_t benchmark_ns = (benchmark_parse_end.QuadPart - benchmark_parse_start.QuadPart) * INT64_C(1000000000) / freq.QuadPart;
+    LARGE_INTEGER freq, benchmark_batch_start, benchmark_batch_end;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&benchmark_batch_start);
 #else
-        clock_gettime(CLOCK_MONOTONIC, &benchmark_parse_end);
-        const uint64_t benchmark_ns = (UINT64_C(1000000000) * benchmark_parse_end.tv_sec + benchmark_parse_end.tv_nsec) -
-                                      (UINT64_C(1000000000) * benchmark_parse_start.tv_sec + benchmark_parse_start.tv_nsec);
+    struct timespec benchmark_batch_start, benchmark_batch_end;
+    clock_gettime(CLOCK_MONOTONIC, &benchmark_batch_start);
 #endif
-        printf("Benchmark: %" PRIu64 "ns\n", benchmark_ns);
 #endif
 
-#ifdef RAGEPHOTO_DEBUG
-        const uint32_t jsonOffset = rp_data->jpegBuffer + UINT32_C(28);
-        const uint32_t titlOffset = jsonOffset + rp_data->jsonBuffer + UINT32_C(8);
-        const uint32_t descOffset = titlOffset + rp_data->titlBuffer + UINT32_C(8);
-        const uint32_t endOfFile = descOffset + rp_data->descBuffer + UINT32_C(12);
-        printf("header: %s\n", rp_data->header);
-        printf("headerSum: %" PRIu32 "\n", rp_data->headerSum);
-        printf("headerSum2: %" PRIu32 "\n", rp_data->headerSum2);
-        printf("photoBuffer: %" PRIu32 "\n", rp_data->jpegBuffer);
-        printf("descBuffer: %" PRIu32 "\n", rp_data->descBuffer);
-        printf("descOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->descOffset, descOffset);
-        printf("description: %s\n", rp_data->description);
-        printf("jsonBuffer: %" PRIu32 "\n", rp_data->jsonBuffer);
-        printf("jsonOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->jsonOffset, jsonOffset);
-        printf("json: %s\n", rp_data->json);
-        printf("sign: %" PRIu64 "\n", ragephotodata_getphotosign(rp_data));
-        printf("titlBuffer: %" PRIu32 "\n", rp_data->titlBuffer);
-        printf("titlOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->titlOffset, titlOffset);
-        printf("title: %s\n", rp_data->title);
-        printf("eofOffset: %" PRIu32 " (%" PRIu32 ")\n", rp_data->endOfFile, endOfFile);
-        printf("size: %zu / %zu\n", length, ragephotodata_getsavesize(rp_data, NULL));
+    RagePhotoBatch batch;
+    memset(&batch, 0, sizeof(RagePhotoBatch));
+    batch.instances = instances;
+    batch.filenames = filenames;
+    batch.count = count;
+    batch.metadata = options ? options->metadata : false;
+
+    size_t threads = options ? options->threads : 0;
+#ifdef RAGEPHOTO_THREADS
+    if (threads == 0)
+        threads = hardwareThreads();
+#else
+    threads = 1;
 #endif
+    if (threads > count)
+        threads = count;
 
-        rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
-        return true;
+#ifdef RAGEPHOTO_THREADS
+    initBatch(&batch);
+    // The calling thread is the first worker
+    size_t started = 0;
+#ifdef _WIN32
+    HANDLE *workers = threads > 1 ? (HANDLE*)malloc(sizeof(HANDLE) * (threads - 1)) : NULL;
 #else
-        printf("UTF-16LE decoding support missing\n");
-        rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
-        return false;
+    pthread_t *workers = threads > 1 ? (pthread_t*)malloc(sizeof(pthread_t) * (threads - 1)) : NULL;
+#endif
+    if (workers) {
+        for (; started < threads - 1; started++) {
+#ifdef _WIN32
+            workers[started] = CreateThread(NULL, 0, loadBatchThread, &batch, 0, NULL);
+            if (!workers[started])
+                break;
+#else
+            if (pthread_create(&workers[started], NULL, loadBatchThread, &batch) != 0)
+                break;
 #endif
-    }
-    else if (rp_parser) {
-        RagePhotoFormatParser n_parser;
-        memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
-        for (size_t i = 0; memcmp(&n_parser, &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
-            if (rp_data->photoFormat == rp_parser[i].photoFormat)
-                if (rp_parser[i].funcLoad)
-                    return (rp_parser[i].funcLoad)(rp_data, data, length);
         }
     }
-    rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
-    return false;
-}
-
-bool ragephoto_load(ragephoto_t instance, const char *data, size_t size)
-{
-    return ragephotodata_load(instance->data, instance->parser, data, size);
-}
-
-bool ragephoto_loadfile(ragephoto_t instance, const char *filename)
-{
-    FILE *file = openFile(filename, 'r');
-    if (!file)
-        return false;
-#if defined(_WIN64)
-    int fseek_ret = _fseeki64(file, 0, SEEK_END);
-#elif (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)
-    int fseek_ret = fseeko(file, 0, SEEK_END);
+    loadBatch(&batch);
+    for (size_t i = 0; i < started; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
 #else
-    int fseek_ret = fseek(file, 0, SEEK_END);
+        pthread_join(workers[i], NULL);
 #endif
-    if (fseek_ret == -1) {
-        fclose(file);
-        return false;
     }
-#if defined(_WIN64)
-    const long long fileSize = _ftelli64(file);
-#elif (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)
-    const off_t fileSize = ftello(file);
+    free(workers);
+    destroyBatch(&batch);
 #else
-    const long fileSize = ftell(file);
+    loadBatch(&batch);
 #endif
-    if (fileSize == -1) {
-        fclose(file);
-        return false;
-    }
-#if defined(_WIN64)
-    fseek_ret = _fseeki64(file, 0, SEEK_SET);
-#elif (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)
-    fseek_ret = fseeko(file, 0, SEEK_SET);
+
+#ifdef RAGEPHOTO_BENCHMARK
+#ifdef _WIN32
+    QueryPerformanceCounter(&benchmark_batch_end);
+    const uint64_t benchmark_ns = (benchmark_batch_end.QuadPart - benchmark_batch_start.QuadPart) * INT64_C(1000000000) / freq.QuadPart;
 #else
-    fseek_ret = fseek(file, 0, SEEK_SET);
+    clock_gettime(CLOCK_MONOTONIC, &benchmark_batch_end);
+    const uint64_t benchmark_ns = (UINT64_C(1000000000) * benchmark_batch_end.tv_sec + benchmark_batch_end.tv_nsec) -
+                                  (UINT64_C(1000000000) * benchmark_batch_start.tv_sec + benchmark_batch_start.tv_nsec);
 #endif
-    if (fseek_ret == -1) {
-        fclose(file);
-        return false;
-    }
-    char *data = (char*)malloc(fileSize);
-    if (!data) {
-        fclose(file);
-        return false;
-    }
-    const size_t readSize = fread(data, sizeof(char), fileSize, file);
-    fclose(file);
-    if (fileSize != readSize) {
-        free(data);
-        return false;
-    }
-    bool isLoaded = ragephotodata_load(instance->data, instance->parser, data, fileSize);
-    free(data);
-    return isLoaded;
+    printf("Batch Benchmark: %" PRIu64 "ns (%zu files, %zu threads)\n", benchmark_ns, count, threads);
+#endif
+
+    return batch.loaded;
 }
 
 int32_t ragephoto_error(ragephoto_t instance)
@@ -691,10 +2497,16 @@ const char* ragephoto_getphotojpeg(ragephoto_t instance)
 uint64_t ragephotodata_getphotosignf(RagePhotoData *rp_data, uint32_t photoFormat)
 {
     if (rp_data->jpeg) {
-        if (photoFormat == RAGEPHOTO_FORMAT_GTA5)
-            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, RAGEPHOTO_SIGNINITIAL_GTA5));
+        if (rp_data->signFormat != 0 && rp_data->signFormat == photoFormat)
+            return rp_data->jpegSign;
+        else if (photoFormat == RAGEPHOTO_FORMAT_GTA5)
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, RAGEPHOTO_SIGNINITIAL_GTA5));
         else if (photoFormat == RAGEPHOTO_FORMAT_RDR2)
-            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, RAGEPHOTO_SIGNINITIAL_RDR2));
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, RAGEPHOTO_SIGNINITIAL_RDR2));
+        else
+            return 0;
+        rp_data->signFormat = photoFormat;
+        return rp_data->jpegSign;
     }
     return 0;
 }
@@ -724,6 +2536,56 @@ void ragephoto_getphotosignsf(ragephoto_t instance, char *data, size_t size, uin
     snprintf(data, size, "%" PRIu64, ragephoto_getphotosignf(instance, photoFormat));
 }
 
+void ragephotodata_getphotosignmany(RagePhotoData **rp_data, size_t count, uint64_t *signs)
+{
+    const char *data[JOAAT_CHUNK];
+    size_t size[JOAAT_CHUNK];
+    uint32_t init_val[JOAAT_CHUNK];
+    uint32_t hash[JOAAT_CHUNK];
+    size_t index[JOAAT_CHUNK];
+    for (size_t offset = 0; offset < count; offset += JOAAT_CHUNK) {
+        const size_t end = (count - offset > JOAAT_CHUNK) ? offset + JOAAT_CHUNK : count;
+        size_t jobs = 0;
+        for (size_t i = offset; i < end; i++) {
+            signs[i] = 0;
+            if (!rp_data[i] || !rp_data[i]->jpeg)
+                continue;
+            if (rp_data[i]->signFormat != 0 && rp_data[i]->signFormat == rp_data[i]->photoFormat) {
+                signs[i] = rp_data[i]->jpegSign;
+                continue;
+            }
+            if (rp_data[i]->photoFormat == RAGEPHOTO_FORMAT_GTA5)
+                init_val[jobs] = RAGEPHOTO_SIGNINITIAL_GTA5;
+            else if (rp_data[i]->photoFormat == RAGEPHOTO_FORMAT_RDR2)
+                init_val[jobs] = RAGEPHOTO_SIGNINITIAL_RDR2;
+            else
+                continue;
+            data[jobs] = rp_data[i]->jpeg;
+            size[jobs] = rp_data[i]->jpegSize;
+            index[jobs] = i;
+            jobs++;
+        }
+        joaatMany(data, size, init_val, hash, jobs);
+        for (size_t i = 0; i < jobs; i++) {
+            RagePhotoData *t_data = rp_data[index[i]];
+            t_data->jpegSign = (UINT64_C(0x100000000000000) | hash[i]);
+            t_data->signFormat = t_data->photoFormat;
+            signs[index[i]] = t_data->jpegSign;
+        }
+    }
+}
+
+void ragephoto_getphotosignmany(ragephoto_t *instances, size_t count, uint64_t *signs)
+{
+    RagePhotoData *rp_data[JOAAT_CHUNK];
+    for (size_t offset = 0; offset < count; offset += JOAAT_CHUNK) {
+        const size_t chunk = (count - offset > JOAAT_CHUNK) ? JOAAT_CHUNK : count - offset;
+        for (size_t i = 0; i < chunk; i++)
+            rp_data[i] = instances[offset + i] ? instances[offset + i]->data : NULL;
+        ragephotodata_getphotosignmany(rp_data, chunk, &signs[offset]);
+    }
+}
+
 uint32_t ragephoto_getphotosize(ragephoto_t instance)
 {
     if (instance->data->jpeg)
@@ -771,117 +2633,24 @@ bool ragephotodata_savef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parse
             rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEHEADER; // 3
             return false;
         }
-#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT)
-#if defined(UNICODE_ICONV)
-        iconv_t iconv_in = iconv_open("UTF-16LE", "UTF-8");
-        if (iconv_in == (iconv_t)-1) {
-            rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
-            return false;
-        }
-        char photoHeader[256];
-        memset(&photoHeader, 0, 256);
-        size_t src_s = strlen(rp_data->header);
-        size_t dst_s = sizeof(photoHeader);
-        char *src = rp_data->header;
-        char *dst = photoHeader;
-        const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
-        iconv_close(iconv_in);
-        if (ret == (size_t)-1) {
-            rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
-            return false;
-        }
-        const size_t photoHeader_size = 256;
-#elif defined(UNICODE_WINCVT)
+#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT) || defined(UNICODE_BUILTIN)
         char photoHeader[256];
-        memset(&photoHeader, 0, 256);
-        const int converted = MultiByteToWideChar(CP_UTF8, 0, rp_data->header, (int)strlen(rp_data->header), (wchar_t*)photoHeader, 256 / sizeof(wchar_t));
-        if (converted == 0) {
-            rp_data->error = RAGEPHOTO_ERROR_UNICODEHEADERERROR; // 6
+        if (!saveHeader(rp_data, photoHeader))
             return false;
-        }
-        const size_t photoHeader_size = 256;
-#endif
 
         const size_t length = ragephotodata_getsavesizef(rp_data, NULL, photoFormat);
         size_t pos = 0;
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&photoFormat, data, &pos, length, 4);
-#else
-        char uInt32Buffer[4];
-        uInt32ToCharLE(photoFormat, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        writeBuffer(photoHeader, data, &pos, length, photoHeader_size);
-        zeroBuffer(data, &pos, length, 256 - photoHeader_size);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->headerSum, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->headerSum, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        if (photoFormat == RAGEPHOTO_FORMAT_RDR2) {
-            zeroBuffer(data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-            writeBuffer(&rp_data->headerSum2, data, &pos, length, 4);
-#else
-            uInt32ToCharLE(rp_data->headerSum2, uInt32Buffer);
-            writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-        }
-
-        const uint32_t jsonOffset = rp_data->jpegBuffer + UINT32_C(28);
-        const uint32_t titlOffset = jsonOffset + rp_data->jsonBuffer + UINT32_C(8);
-        const uint32_t descOffset = titlOffset + rp_data->titlBuffer + UINT32_C(8);
-        const uint32_t endOfFile = descOffset + rp_data->descBuffer + UINT32_C(12);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&endOfFile, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(endOfFile, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&jsonOffset, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(jsonOffset, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&titlOffset, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(titlOffset, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&descOffset, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(descOffset, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        writeBuffer("JPEG", data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->jpegBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->jpegBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+        const RagePhotoLayout *layout = photoLayout(photoFormat);
+        uint32_t fields[LAYOUT_FIELD_CONSTANT];
+        saveFields(rp_data, fields);
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->jpegSize, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->jpegSize, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+        // The fixed header is assembled first and written at once
+        char layoutBuffer[RAGEPHOTO_LAYOUT_MAXSIZE];
+        uInt32ToCharLE(photoFormat, layoutBuffer);
+        memcpy(&layoutBuffer[4], photoHeader, 256);
+        saveLayout(layout, fields, layoutBuffer);
+        writeBuffer(layoutBuffer, data, &pos, length, layout->size);
 
         if (rp_data->jpeg) {
             if (rp_data->jpegSize > rp_data->jpegBuffer) {
@@ -895,70 +2664,29 @@ bool ragephotodata_savef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parse
             zeroBuffer(data, &pos, length, rp_data->jpegBuffer);
         }
 
-        writeBuffer("JSON", data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->jsonBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->jsonBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        if (rp_data->json) {
-            const size_t jsonString_size = strlen(rp_data->json) + 1;
-            if (jsonString_size > rp_data->jsonBuffer) {
-                rp_data->error = RAGEPHOTO_ERROR_JSONBUFFERTIGHT; // 37
-                return false;
-            }
-            writeBuffer(rp_data->json, data, &pos, length, jsonString_size);
-            zeroBuffer(data, &pos, length, rp_data->jsonBuffer - jsonString_size);
-        }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->jsonBuffer);
-        }
-
-        writeBuffer("TITL", data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->titlBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->titlBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        if (rp_data->title) {
-            const size_t titlString_size = strlen(rp_data->title) + 1;
-            if (titlString_size > rp_data->titlBuffer) {
-                rp_data->error = RAGEPHOTO_ERROR_TITLEBUFFERTIGHT; // 38
-                return false;
-            }
-            writeBuffer(rp_data->title, data, &pos, length, titlString_size);
-            zeroBuffer(data, &pos, length, rp_data->titlBuffer - titlString_size);
-        }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->titlBuffer);
-        }
-
-        writeBuffer("DESC", data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->descBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->descBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        if (rp_data->description) {
-            const size_t descString_size = strlen(rp_data->description) + 1;
-            if (descString_size > rp_data->descBuffer) {
-                rp_data->error = RAGEPHOTO_ERROR_DESCBUFFERTIGHT; // 39
-                return false;
+        const RagePhotoSectionEntry sections[3] = {
+            {&rp_data->json, &rp_data->jsonBuffer, NULL, 0, RAGEPHOTO_MARKER_JSON, RAGEPHOTO_ERROR_JSONBUFFERTIGHT}, // 37
+            {&rp_data->title, &rp_data->titlBuffer, NULL, 0, RAGEPHOTO_MARKER_TITL, RAGEPHOTO_ERROR_TITLEBUFFERTIGHT}, // 38
+            {&rp_data->description, &rp_data->descBuffer, NULL, 0, RAGEPHOTO_MARKER_DESC, RAGEPHOTO_ERROR_DESCBUFFERTIGHT} // 39
+        };
+        for (size_t i = 0; i < 3; i++) {
+            const RagePhotoSectionEntry *section = &sections[i];
+            char sectionHead[8];
+            uInt32ToCharLE(section->marker, &sectionHead[0]);
+            uInt32ToCharLE(*section->buffer, &sectionHead[4]);
+            writeBuffer(sectionHead, data, &pos, length, 8);
+            if (*section->data) {
+                const size_t string_size = strlen(*section->data) + 1;
+                if (string_size > *section->buffer) {
+                    rp_data->error = section->error;
+                    return false;
+                }
+                writeBuffer(*section->data, data, &pos, length, string_size);
+                zeroBuffer(data, &pos, length, *section->buffer - string_size);
+            }
+            else {
+                zeroBuffer(data, &pos, length, *section->buffer);
             }
-            writeBuffer(rp_data->description, data, &pos, length, descString_size);
-            zeroBuffer(data, &pos, length, rp_data->descBuffer - descString_size);
-        }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->descBuffer);
         }
 
         writeBuffer("JEND", data, &pos, length, 4);
@@ -984,14 +2712,19 @@ bool ragephotodata_savef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parse
         rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
         return true;
     }
-    else if (rp_parser) {
-        RagePhotoFormatParser n_parser;
-        memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
-        for (size_t i = 0; memcmp(&n_parser, &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
-            if (photoFormat == rp_parser[i].photoFormat)
-                if (rp_parser[i].funcSave)
-                    return (rp_parser[i].funcSave)(rp_data, data, photoFormat);
+    else {
+        if (rp_parser) {
+            RagePhotoFormatParser n_parser;
+            memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
+            for (size_t i = 0; memcmp(&n_parser, &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
+                if (photoFormat == rp_parser[i].photoFormat)
+                    if (rp_parser[i].funcSave)
+                        return (rp_parser[i].funcSave)(rp_data, data, photoFormat);
+            }
         }
+        RagePhotoFormatParser r_parser;
+        if (registeredParser(photoFormat, &r_parser) && r_parser.funcSave)
+            return (r_parser.funcSave)(rp_data, data, photoFormat);
     }
 
     rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
@@ -1013,25 +2746,159 @@ bool ragephoto_save(ragephoto_t instance, char *data)
     return ragephotodata_savef(instance->data, instance->parser, data, instance->data->photoFormat);
 }
 
-bool ragephoto_savefilef(ragephoto_t instance, const char *filename, uint32_t photoFormat)
+size_t ragephotodata_saveiovf(RagePhotoData *rp_data, RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat)
 {
-    const size_t fileSize = ragephotodata_getsavesizef(instance->data, instance->parser, photoFormat);
-    char *data = (char*)malloc(fileSize);
-    if (!data)
-        return false;
-    if (!ragephotodata_savef(instance->data, instance->parser, data, photoFormat)) {
-        free(data);
-        return false;
+    size_t index = 0;
+    if (photoFormat == RAGEPHOTO_FORMAT_GTA5 || photoFormat == RAGEPHOTO_FORMAT_RDR2) {
+        if (!rp_data->header) {
+            rp_data->error = RAGEPHOTO_ERROR_INCOMPLETEHEADER; // 3
+            return 0;
+        }
+#if defined(UNICODE_ICONV) || defined(UNICODE_WINCVT) || defined(UNICODE_BUILTIN)
+        // The buffer holds the fixed header, the three section heads and the JEND marker
+        const RagePhotoLayout *layout = photoLayout(photoFormat);
+        uInt32ToCharLE(photoFormat, buffer);
+        if (!saveHeader(rp_data, &buffer[4]))
+            return 0;
+        uint32_t fields[LAYOUT_FIELD_CONSTANT];
+        saveFields(rp_data, fields);
+        saveLayout(layout, fields, buffer);
+        appendIov(iov, count, &index, buffer, layout->size);
+
+        if (rp_data->jpeg) {
+            if (rp_data->jpegSize > rp_data->jpegBuffer) {
+                rp_data->error = RAGEPHOTO_ERROR_PHOTOBUFFERTIGHT; // 36
+                return 0;
+            }
+            appendIov(iov, count, &index, rp_data->jpeg, rp_data->jpegSize);
+            appendZeroIov(iov, count, &index, rp_data->jpegBuffer - rp_data->jpegSize);
+        }
+        else {
+            appendZeroIov(iov, count, &index, rp_data->jpegBuffer);
+        }
+
+        const RagePhotoSectionEntry sections[3] = {
+            {&rp_data->json, &rp_data->jsonBuffer, NULL, 0, RAGEPHOTO_MARKER_JSON, RAGEPHOTO_ERROR_JSONBUFFERTIGHT}, // 37
+            {&rp_data->title, &rp_data->titlBuffer, NULL, 0, RAGEPHOTO_MARKER_TITL, RAGEPHOTO_ERROR_TITLEBUFFERTIGHT}, // 38
+            {&rp_data->description, &rp_data->descBuffer, NULL, 0, RAGEPHOTO_MARKER_DESC, RAGEPHOTO_ERROR_DESCBUFFERTIGHT} // 39
+        };
+        char *sectionHead = &buffer[layout->size];
+        for (size_t i = 0; i < 3; i++) {
+            const RagePhotoSectionEntry *section = &sections[i];
+            uInt32ToCharLE(section->marker, &sectionHead[0]);
+            uInt32ToCharLE(*section->buffer, &sectionHead[4]);
+            appendIov(iov, count, &index, sectionHead, 8);
+            sectionHead += 8;
+            if (*section->data) {
+                const size_t string_size = strlen(*section->data) + 1;
+                if (string_size > *section->buffer) {
+                    rp_data->error = section->error;
+                    return 0;
+                }
+                appendIov(iov, count, &index, *section->data, string_size);
+                appendZeroIov(iov, count, &index, *section->buffer - string_size);
+            }
+            else {
+                appendZeroIov(iov, count, &index, *section->buffer);
+            }
+        }
+
+        memcpy(sectionHead, "JEND", 4);
+        appendIov(iov, count, &index, sectionHead, 4);
+
+        rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+        return index;
+#else
+        printf("UTF-16LE encoding support missing\n");
+        rp_data->error = RAGEPHOTO_ERROR_UNICODEINITERROR; // 4
+        return 0;
+#endif
+    }
+    else if (photoFormat == RAGEPHOTO_FORMAT_JPEG) {
+        if (!rp_data->jpeg) {
+            rp_data->error = RAGEPHOTO_ERROR_PHOTOREADERROR; // 17
+            return 0;
+        }
+        appendIov(iov, count, &index, rp_data->jpeg, rp_data->jpegSize);
+
+        rp_data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+        return index;
     }
+
+    rp_data->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
+    return 0;
+}
+
+size_t ragephotodata_saveiov(RagePhotoData *rp_data, RagePhotoIovec *iov, size_t count, char *buffer)
+{
+    return ragephotodata_saveiovf(rp_data, iov, count, buffer, rp_data->photoFormat);
+}
+
+size_t ragephoto_saveiovf(ragephoto_t instance, RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat)
+{
+    return ragephotodata_saveiovf(instance->data, iov, count, buffer, photoFormat);
+}
+
+size_t ragephoto_saveiov(ragephoto_t instance, RagePhotoIovec *iov, size_t count, char *buffer)
+{
+    return ragephotodata_saveiovf(instance->data, iov, count, buffer, instance->data->photoFormat);
+}
+
+static bool saveFileIov(const char *filename, const RagePhotoIovec *iov, size_t count)
+{
+#ifdef RAGEPHOTO_DIRECT_SAVE
+    if (!(libraryflags & RAGEPHOTO_FLAG_DISABLE_DIRECT_SAVE))
+        return saveFileDirect(filename, iov, count);
+#endif
     FILE *file = openFile(filename, 'w');
-    if (!file) {
-        free(data);
+    if (!file)
         return false;
-    }
-    const size_t writeSize = fwrite(data, sizeof(char), fileSize, file);
+    bool written = true;
+    for (size_t i = 0; i < count && written; i++)
+        written = (fwrite(iov[i].iov_base, sizeof(char), iov[i].iov_len, file) == iov[i].iov_len);
     fclose(file);
+    return written;
+}
+
+bool ragephoto_savefilef(ragephoto_t instance, const char *filename, uint32_t photoFormat)
+{
+    // GTA V, RDR 2 and JPEG Photos are written from their section buffers, other formats are saved to a buffer first
+    RagePhotoIovec iov_s[32];
+    RagePhotoIovec *iov = iov_s;
+    char buffer[RAGEPHOTO_SAVEIOV_BUFFERSIZE];
+    char *data = NULL;
+    size_t count;
+    if (photoFormat == RAGEPHOTO_FORMAT_GTA5 || photoFormat == RAGEPHOTO_FORMAT_RDR2 || photoFormat == RAGEPHOTO_FORMAT_JPEG) {
+        count = ragephotodata_saveiovf(instance->data, iov, 32, buffer, photoFormat);
+        if (count == 0)
+            return false;
+        if (count > 32) {
+            iov = (RagePhotoIovec*)malloc(count * sizeof(RagePhotoIovec));
+            if (!iov) {
+                instance->data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
+                return false;
+            }
+            ragephotodata_saveiovf(instance->data, iov, count, buffer, photoFormat);
+        }
+    }
+    else {
+        const size_t fileSize = ragephotodata_getsavesizef(instance->data, instance->parser, photoFormat);
+        data = (char*)malloc(fileSize);
+        if (!data)
+            return false;
+        if (!ragephotodata_savef(instance->data, instance->parser, data, photoFormat)) {
+            free(data);
+            return false;
+        }
+        iov[0].iov_base = data;
+        iov[0].iov_len = fileSize;
+        count = 1;
+    }
+    const bool written = saveFileIov(filename, iov, count);
+    if (iov != iov_s)
+        free(iov);
     free(data);
-    return fileSize == writeSize;
+    return written;
 }
 
 bool ragephoto_savefile(ragephoto_t instance, const char *filename)
@@ -1047,14 +2914,19 @@ size_t ragephotodata_getsavesizef(RagePhotoData *rp_data, RagePhotoFormatParser
         return (rp_data->jpegBuffer + rp_data->jsonBuffer + rp_data->titlBuffer + rp_data->descBuffer + RAGEPHOTO_RDR2_HEADERSIZE + UINT32_C(56));
     else if (photoFormat == RAGEPHOTO_FORMAT_JPEG)
         return (rp_data->jpegSize);
-    else if (rp_parser) {
-        RagePhotoFormatParser n_parser;
-        memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
-        for (size_t i = 0; memcmp(&n_parser, &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
-            if (photoFormat == rp_parser[i].photoFormat)
-                if (rp_parser[i].funcSaveSz)
-                    return (rp_parser[i].funcSaveSz)(rp_data, photoFormat);
+    else {
+        if (rp_parser) {
+            RagePhotoFormatParser n_parser;
+            memset(&n_parser, 0, sizeof(RagePhotoFormatParser));
+            for (size_t i = 0; memcmp(&n_parser, &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
+                if (photoFormat == rp_parser[i].photoFormat)
+                    if (rp_parser[i].funcSaveSz)
+                        return (rp_parser[i].funcSaveSz)(rp_data, photoFormat);
+            }
         }
+        RagePhotoFormatParser r_parser;
+        if (registeredParser(photoFormat, &r_parser) && r_parser.funcSaveSz)
+            return (r_parser.funcSaveSz)(rp_data, photoFormat);
     }
     return 0;
 }
@@ -1105,83 +2977,162 @@ void ragephoto_setlibraryflag(RagePhotoLibraryFlag flag, bool state)
     state ? (libraryflags |= flag) : (libraryflags &= ~flag);
 }
 
+void ragephoto_setsizelimits(const RagePhotoSizeLimits *limits)
+{
+    if (limits) {
+        sizelimits = *limits;
+        return;
+    }
+    sizelimits.descBuffer = UINT32_MAX;
+    sizelimits.jpegSize = UINT32_MAX;
+    sizelimits.jsonBuffer = UINT32_MAX;
+    sizelimits.titlBuffer = UINT32_MAX;
+}
+
+void ragephoto_getsizelimits(RagePhotoSizeLimits *limits)
+{
+    *limits = sizelimits;
+}
+
+void ragephoto_setlibraryallocator(const RagePhotoAllocator *allocator)
+{
+    if (allocator)
+        libraryallocator = *allocator;
+    else
+        memset(&libraryallocator, 0, sizeof(RagePhotoAllocator));
+}
+
+void ragephoto_setallocator(ragephoto_t instance, const RagePhotoAllocator *allocator)
+{
+    ragephotodata_clear(instance->data);
+    instance->data->allocator = allocator;
+}
+
 bool ragephoto_setphotodata(ragephoto_t instance, RagePhotoData *rp_data)
 {
     if (instance->data == rp_data)
         return true;
 
-    free(instance->data->jpeg);
-    free(instance->data->description);
-    free(instance->data->json);
-    free(instance->data->header);
-    free(instance->data->title);
+    freeData(instance->data);
     free(instance->data);
 
     instance->data = rp_data;
     return true;
 }
 
-bool ragephoto_setphotodatac(ragephoto_t instance, RagePhotoData *rp_data)
+/* Library state is only read from source when it belongs to an instance, other data objects only provide the sections */
+static bool copyData(RagePhotoData *rp_data, const RagePhotoData *source, bool isInstanceData)
 {
-    if (instance->data == rp_data)
-        return true;
+    ragephotodata_clear(rp_data);
+    rp_data->photoFormat = source->photoFormat;
 
-    ragephotodata_clear(instance->data);
-    instance->data->photoFormat = rp_data->photoFormat;
+    // Sections in storage are shared when both use the same allocator
+    if (isInstanceData && source->storage && dataAllocator(source) == dataAllocator(rp_data)) {
+        retainStorage(source->storage);
+        rp_data->storage = source->storage;
+    }
 
-    if (rp_data->header) {
-        const size_t headerSize = strlen(rp_data->header) + 1;
-        instance->data->header = (char*)malloc(headerSize);
-        if (!instance->data->header)
-            return false;
-        memcpy(instance->data->header, rp_data->header, headerSize);
-        instance->data->headerSum = rp_data->headerSum;
-        instance->data->headerSum2 = rp_data->headerSum2;
+    if (source->header) {
+        if (!shareStorageData(rp_data, source, source->header, &rp_data->header)) {
+            const size_t headerSize = strlen(source->header) + 1;
+            rp_data->header = (char*)allocBuffer(rp_data, headerSize);
+            if (!rp_data->header)
+                return false;
+            memcpy(rp_data->header, source->header, headerSize);
+            rp_data->headerCapacity = (uint32_t)headerSize;
+        }
+        rp_data->headerSum = source->headerSum;
+        rp_data->headerSum2 = source->headerSum2;
     }
 
-    if (rp_data->jpeg) {
-        instance->data->jpeg = (char*)malloc(rp_data->jpegSize);
-        if (!instance->data->jpeg)
-            return false;
-        memcpy(instance->data->jpeg, rp_data->jpeg, rp_data->jpegSize);
-        instance->data->jpegSize = rp_data->jpegSize;
-        instance->data->jpegBuffer = rp_data->jpegBuffer;
+    if (source->jpeg) {
+        if (!shareStorageData(rp_data, source, source->jpeg, &rp_data->jpeg)) {
+            rp_data->jpeg = (char*)allocBuffer(rp_data, source->jpegSize);
+            if (!rp_data->jpeg)
+                return false;
+            memcpy(rp_data->jpeg, source->jpeg, source->jpegSize);
+            rp_data->jpegCapacity = source->jpegSize;
+        }
+        rp_data->jpegSize = source->jpegSize;
+        rp_data->jpegBuffer = source->jpegBuffer;
+        if (isInstanceData) {
+            rp_data->jpegSign = source->jpegSign;
+            rp_data->signFormat = source->signFormat;
+        }
     }
 
-    if (rp_data->json) {
-        const size_t jsonSize = strlen(rp_data->json) + 1;
-        instance->data->json = (char*)malloc(jsonSize);
-        if (!instance->data->json)
-            return false;
-        memcpy(instance->data->json, rp_data->json, jsonSize);
-        instance->data->jsonBuffer = rp_data->jsonBuffer;
+    if (source->json) {
+        if (!shareStorageData(rp_data, source, source->json, &rp_data->json)) {
+            const size_t jsonSize = strlen(source->json) + 1;
+            rp_data->json = (char*)allocBuffer(rp_data, jsonSize);
+            if (!rp_data->json)
+                return false;
+            memcpy(rp_data->json, source->json, jsonSize);
+            rp_data->jsonCapacity = (uint32_t)jsonSize;
+        }
+        rp_data->jsonBuffer = source->jsonBuffer;
     }
 
-    if (rp_data->title) {
-        const size_t titleSize = strlen(rp_data->title) + 1;
-        instance->data->title = (char*)malloc(titleSize);
-        if (!instance->data->title)
-            return false;
-        memcpy(instance->data->title, rp_data->title, titleSize);
-        instance->data->titlBuffer = rp_data->titlBuffer;
+    if (source->title) {
+        if (!shareStorageData(rp_data, source, source->title, &rp_data->title)) {
+            const size_t titleSize = strlen(source->title) + 1;
+            rp_data->title = (char*)allocBuffer(rp_data, titleSize);
+            if (!rp_data->title)
+                return false;
+            memcpy(rp_data->title, source->title, titleSize);
+            rp_data->titlCapacity = (uint32_t)titleSize;
+        }
+        rp_data->titlBuffer = source->titlBuffer;
     }
 
-    if (rp_data->description) {
-        const size_t descriptionSize = strlen(rp_data->description) + 1;
-        instance->data->description = (char*)malloc(descriptionSize);
-        if (!instance->data->description)
-            return false;
-        memcpy(instance->data->description, rp_data->description, descriptionSize);
-        instance->data->descBuffer = rp_data->descBuffer;
+    if (source->description) {
+        if (!shareStorageData(rp_data, source, source->description, &rp_data->description)) {
+            const size_t descriptionSize = strlen(source->description) + 1;
+            rp_data->description = (char*)allocBuffer(rp_data, descriptionSize);
+            if (!rp_data->description)
+                return false;
+            memcpy(rp_data->description, source->description, descriptionSize);
+            rp_data->descCapacity = (uint32_t)descriptionSize;
+        }
+        rp_data->descBuffer = source->descBuffer;
     }
 
-    ragephotodata_setbufferoffsets(instance->data);
+    ragephotodata_setbufferoffsets(rp_data);
     return true;
 }
 
+bool ragephoto_setphotodatac(ragephoto_t instance, RagePhotoData *rp_data)
+{
+    if (instance->data == rp_data)
+        return true;
+    return copyData(instance->data, rp_data, false);
+}
+
+bool ragephoto_copyphotodata(ragephoto_t instance, ragephoto_t source)
+{
+    if (instance->data == source->data)
+        return true;
+    return copyData(instance->data, source->data, true);
+}
+
 void ragephoto_setphotodesc(ragephoto_t instance, const char *description, uint32_t bufferSize)
 {
-    if (!writeDataChar(description, &instance->data->description)) {
+    detachStorageData(instance->data, &instance->data->description);
+    if (!writeDataChar(instance->data, description, &instance->data->description, &instance->data->descCapacity)) {
+        instance->data->error = RAGEPHOTO_ERROR_DESCMALLOCERROR; // 31
+        return;
+    }
+    if (bufferSize != 0) {
+        instance->data->descBuffer = bufferSize;
+        ragephotodata_setbufferoffsets(instance->data);
+    }
+    instance->data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+}
+
+void ragephoto_setphotodescl(ragephoto_t instance, const char *description, size_t length, uint32_t bufferSize)
+{
+    detachStorageData(instance->data, &instance->data->description);
+    if (!writeDataCharl(instance->data, description, length, &instance->data->description, &instance->data->descCapacity)) {
         instance->data->error = RAGEPHOTO_ERROR_DESCMALLOCERROR; // 31
         return;
     }
@@ -1199,27 +3150,38 @@ void ragephoto_setphotoformat(ragephoto_t instance, uint32_t photoFormat)
 
 bool ragephoto_setphotojpeg(ragephoto_t instance, const char *data, uint32_t size, uint32_t bufferSize)
 {
+    instance->data->signFormat = 0;
+    if (isStorageData(instance->data, instance->data->jpeg)) {
+        instance->data->jpeg = NULL;
+        instance->data->jpegSize = 0;
+    }
     if (data && size) {
-        if (instance->data->jpeg) {
+        if (instance->data->jpeg && instance->data->jpegCapacity >= size) {
+            memcpy(instance->data->jpeg, data, size);
+            instance->data->jpegSize = size;
+        }
+        else if (instance->data->jpeg) {
             if (instance->data->jpegSize > size) {
-                char *t_photoData = (char*)realloc(instance->data->jpeg, size);
+                char *t_photoData = (char*)reallocBuffer(instance->data, instance->data->jpeg, size);
                 if (!t_photoData) {
                     instance->data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
                     return false;
                 }
                 instance->data->jpeg = t_photoData;
                 memcpy(instance->data->jpeg, data, size);
+                instance->data->jpegCapacity = size;
                 instance->data->jpegSize = size;
             }
             else if (instance->data->jpegSize < size) {
-                char *t_photoData = (char*)malloc(size);
+                char *t_photoData = (char*)allocBuffer(instance->data, size);
                 if (!t_photoData) {
                     instance->data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
                     return false;
                 }
-                free(instance->data->jpeg);
+                freeBuffer(instance->data, instance->data->jpeg);
                 instance->data->jpeg = t_photoData;
                 memcpy(instance->data->jpeg, data, size);
+                instance->data->jpegCapacity = size;
                 instance->data->jpegSize = size;
             }
             else {
@@ -1227,18 +3189,20 @@ bool ragephoto_setphotojpeg(ragephoto_t instance, const char *data, uint32_t siz
             }
         }
         else {
-            instance->data->jpeg = (char*)malloc(size);
+            instance->data->jpeg = (char*)allocBuffer(instance->data, size);
             if (!instance->data->jpeg) {
                 instance->data->error = RAGEPHOTO_ERROR_PHOTOMALLOCERROR; // 16
                 return false;
             }
             memcpy(instance->data->jpeg, data, size);
+            instance->data->jpegCapacity = size;
             instance->data->jpegSize = size;
         }
     }
     else if (instance->data->jpeg) {
-        free(instance->data->jpeg);
+        freeBuffer(instance->data, instance->data->jpeg);
         instance->data->jpeg = NULL;
+        instance->data->jpegCapacity = 0;
         instance->data->jpegSize = 0;
     }
 
@@ -1251,9 +3215,39 @@ bool ragephoto_setphotojpeg(ragephoto_t instance, const char *data, uint32_t siz
     return true;
 }
 
+void ragephoto_adoptphotojpeg(ragephoto_t instance, char *data, uint32_t size, uint32_t bufferSize)
+{
+    instance->data->signFormat = 0;
+    if (!isStorageData(instance->data, instance->data->jpeg))
+        freeBuffer(instance->data, instance->data->jpeg);
+    instance->data->jpeg = data;
+    instance->data->jpegCapacity = data ? size : 0;
+    instance->data->jpegSize = data ? size : 0;
+    if (bufferSize != 0) {
+        instance->data->jpegBuffer = bufferSize;
+        ragephotodata_setbufferoffsets(instance->data);
+    }
+    instance->data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+}
+
 void ragephoto_setphotojson(ragephoto_t instance, const char *json, uint32_t bufferSize)
 {
-    if (!writeDataChar(json, &instance->data->json)) {
+    detachStorageData(instance->data, &instance->data->json);
+    if (!writeDataChar(instance->data, json, &instance->data->json, &instance->data->jsonCapacity)) {
+        instance->data->error = RAGEPHOTO_ERROR_JSONMALLOCERROR; // 21
+        return;
+    }
+    if (bufferSize != 0) {
+        instance->data->jsonBuffer = bufferSize;
+        ragephotodata_setbufferoffsets(instance->data);
+    }
+    instance->data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+}
+
+void ragephoto_setphotojsonl(ragephoto_t instance, const char *json, size_t length, uint32_t bufferSize)
+{
+    detachStorageData(instance->data, &instance->data->json);
+    if (!writeDataCharl(instance->data, json, length, &instance->data->json, &instance->data->jsonCapacity)) {
         instance->data->error = RAGEPHOTO_ERROR_JSONMALLOCERROR; // 21
         return;
     }
@@ -1264,9 +3258,23 @@ void ragephoto_setphotojson(ragephoto_t instance, const char *json, uint32_t buf
     instance->data->error = RAGEPHOTO_ERROR_NOERROR; // 255
 }
 
+void ragephoto_adoptphotojson(ragephoto_t instance, char *json, uint32_t bufferSize)
+{
+    if (!isStorageData(instance->data, instance->data->json))
+        freeBuffer(instance->data, instance->data->json);
+    instance->data->json = json;
+    instance->data->jsonCapacity = 0;
+    if (bufferSize != 0) {
+        instance->data->jsonBuffer = bufferSize;
+        ragephotodata_setbufferoffsets(instance->data);
+    }
+    instance->data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+}
+
 void ragephoto_setphotoheader(ragephoto_t instance, const char *header, uint32_t headerSum)
 {
-    if (!writeDataChar(header, &instance->data->header)) {
+    detachStorageData(instance->data, &instance->data->header);
+    if (!writeDataChar(instance->data, header, &instance->data->header, &instance->data->headerCapacity)) {
         instance->data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
         return;
     }
@@ -1277,7 +3285,8 @@ void ragephoto_setphotoheader(ragephoto_t instance, const char *header, uint32_t
 
 void ragephoto_setphotoheader2(ragephoto_t instance, const char *header, uint32_t headerSum, uint32_t headerSum2)
 {
-    if (!writeDataChar(header, &instance->data->header)) {
+    detachStorageData(instance->data, &instance->data->header);
+    if (!writeDataChar(instance->data, header, &instance->data->header, &instance->data->headerCapacity)) {
         instance->data->error = RAGEPHOTO_ERROR_HEADERMALLOCERROR; // 4
         return;
     }
@@ -1288,7 +3297,22 @@ void ragephoto_setphotoheader2(ragephoto_t instance, const char *header, uint32_
 
 void ragephoto_setphototitle(ragephoto_t instance, const char *title, uint32_t bufferSize)
 {
-    if (!writeDataChar(title, &instance->data->title)) {
+    detachStorageData(instance->data, &instance->data->title);
+    if (!writeDataChar(instance->data, title, &instance->data->title, &instance->data->titlCapacity)) {
+        instance->data->error = RAGEPHOTO_ERROR_TITLEMALLOCERROR; // 26
+        return;
+    }
+    if (bufferSize != 0) {
+        instance->data->titlBuffer = bufferSize;
+        ragephotodata_setbufferoffsets(instance->data);
+    }
+    instance->data->error = RAGEPHOTO_ERROR_NOERROR; // 255
+}
+
+void ragephoto_setphototitlel(ragephoto_t instance, const char *title, size_t length, uint32_t bufferSize)
+{
+    detachStorageData(instance->data, &instance->data->title);
+    if (!writeDataCharl(instance->data, title, length, &instance->data->title, &instance->data->titlCapacity)) {
         instance->data->error = RAGEPHOTO_ERROR_TITLEMALLOCERROR; // 26
         return;
     }
@@ -1319,3 +3343,202 @@ uint32_t ragephoto_format_rdr2()
     return RAGEPHOTO_FORMAT_RDR2;
 }
 /* END OF RAGEPHOTO CLASS */
+
+/* BEGIN OF RAGEPHOTO VIEW CLASS */
+static bool loadView(RagePhotoView *rp_view, const char *data, size_t length)
+{
+    memset(rp_view, 0, sizeof(RagePhotoView));
+
+    bool ok;
+    size_t pos = 0;
+    rp_view->photoFormat = viewUInt32(data, &pos, length, &ok);
+    if (!ok) {
+        rp_view->error = RAGEPHOTO_ERROR_NOFORMATIDENTIFIER; // 1
+        return false;
+    }
+
+    if (rp_view->photoFormat != RAGEPHOTO_FORMAT_GTA5 && rp_view->photoFormat != RAGEPHOTO_FORMAT_RDR2) {
+        rp_view->error = RAGEPHOTO_ERROR_INCOMPATIBLEFORMAT; // 2
+        return false;
+    }
+
+    if (length < 260) {
+        rp_view->error = RAGEPHOTO_ERROR_INCOMPLETEHEADER; // 3
+        return false;
+    }
+    rp_view->header = &data[4];
+
+    const RagePhotoLayout *layout = photoLayout(rp_view->photoFormat);
+    uint32_t fields[LAYOUT_FIELD_CONSTANT];
+    memset(fields, 0, sizeof(fields));
+    const bool isLayoutLoaded = loadLayout(layout, data, length, fields, &rp_view->error);
+    rp_view->headerSum = fields[LAYOUT_FIELD_HEADERSUM];
+    rp_view->headerSum2 = fields[LAYOUT_FIELD_HEADERSUM2];
+    rp_view->endOfFile = fields[LAYOUT_FIELD_EOF];
+    rp_view->jsonOffset = fields[LAYOUT_FIELD_JSONOFFSET];
+    rp_view->titlOffset = fields[LAYOUT_FIELD_TITLOFFSET];
+    rp_view->descOffset = fields[LAYOUT_FIELD_DESCOFFSET];
+    rp_view->jpegBuffer = fields[LAYOUT_FIELD_JPEGBUFFER];
+    rp_view->jpegSize = fields[LAYOUT_FIELD_JPEGSIZE];
+    if (!isLayoutLoaded)
+        return false;
+    pos = layout->size;
+
+    if (length - pos < rp_view->jpegSize) {
+        rp_view->error = RAGEPHOTO_ERROR_PHOTOREADERROR; // 17
+        return false;
+    }
+    rp_view->jpeg = &data[pos];
+    pos += rp_view->jpegSize;
+
+    pos += rp_view->jpegBuffer - rp_view->jpegSize;
+    const char **sectionData[3] = {&rp_view->json, &rp_view->title, &rp_view->description};
+    uint32_t *sectionBuffer[3] = {&rp_view->jsonBuffer, &rp_view->titlBuffer, &rp_view->descBuffer};
+    const uint32_t sectionMarker[3] = {RAGEPHOTO_MARKER_JSON, RAGEPHOTO_MARKER_TITL, RAGEPHOTO_MARKER_DESC};
+    const int32_t sectionError[3] = {RAGEPHOTO_ERROR_INCOMPLETEJSONMARKER, RAGEPHOTO_ERROR_INCOMPLETETITLEMARKER, RAGEPHOTO_ERROR_INCOMPLETEDESCMARKER}; // 18, 23, 28
+    for (size_t i = 0; i < 3; i++) {
+        if (!loadSectionHead(data, length, &pos, sectionMarker[i], sectionError[i], sectionBuffer[i], &rp_view->error))
+            return false;
+        // Read error follows the incomplete buffer error
+        if (length - pos < *sectionBuffer[i]) {
+            rp_view->error = sectionError[i] + 4;
+            return false;
+        }
+        *sectionData[i] = &data[pos];
+        pos += *sectionBuffer[i];
+    }
+
+    if (pos > length || length - pos < 4) {
+        rp_view->error = RAGEPHOTO_ERROR_INCOMPLETEJENDMARKER; // 33
+        return false;
+    }
+    if (parserUInt32(&data[pos]) != RAGEPHOTO_MARKER_JEND) {
+        rp_view->error = RAGEPHOTO_ERROR_INCORRECTJENDMARKER; // 34
+        return false;
+    }
+
+    rp_view->error = RAGEPHOTO_ERROR_NOERROR; // 255
+    return true;
+}
+
+bool ragephotoview_load(RagePhotoView *rp_view, const char *data, size_t length)
+{
+    if (!loadView(rp_view, data, length))
+        return false;
+    if (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN) {
+        rp_view->jpegSign = (UINT64_C(0x100000000000000) | joaatFromInitial(rp_view->jpeg, rp_view->jpegSize, signInitial(rp_view->photoFormat)));
+        rp_view->signFormat = rp_view->photoFormat;
+    }
+    return true;
+}
+
+bool ragephotoview_getheader(const RagePhotoView *rp_view, char *data, size_t size)
+{
+    return decodeHeader(rp_view->header, data, size);
+}
+
+uint64_t ragephotoview_getphotosignf(const RagePhotoView *rp_view, uint32_t photoFormat)
+{
+    if (rp_view->jpeg) {
+        if (rp_view->signFormat != 0 && rp_view->signFormat == photoFormat)
+            return rp_view->jpegSign;
+        else if (photoFormat == RAGEPHOTO_FORMAT_GTA5)
+            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_view->jpeg, rp_view->jpegSize, RAGEPHOTO_SIGNINITIAL_GTA5));
+        else if (photoFormat == RAGEPHOTO_FORMAT_RDR2)
+            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_view->jpeg, rp_view->jpegSize, RAGEPHOTO_SIGNINITIAL_RDR2));
+    }
+    return 0;
+}
+
+uint64_t ragephotoview_getphotosign(const RagePhotoView *rp_view)
+{
+    return ragephotoview_getphotosignf(rp_view, rp_view->photoFormat);
+}
+/* END OF RAGEPHOTO VIEW CLASS */
+
+/* BEGIN OF RAGEPHOTO PARSER CLASS */
+void ragephotodata_parser_init(RagePhotoParser *rp_stream, RagePhotoData *rp_data, uint8_t sections)
+{
+    // Avoid data conflicts
+    if (libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY)
+        ragephotodata_reset(rp_data);
+    else
+        ragephotodata_clear(rp_data);
+
+    memset(rp_stream, 0, sizeof(RagePhotoParser));
+    rp_stream->data = rp_data;
+    rp_stream->fieldSize = 4;
+    rp_stream->sections = (sections | RAGEPHOTO_SECTION_HEADER) & RAGEPHOTO_SECTION_ALL;
+    rp_stream->signing = (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN) && (rp_stream->sections & RAGEPHOTO_SECTION_JPEG);
+    rp_stream->state = PARSER_STATE_FORMAT;
+}
+
+void ragephoto_parser_init(RagePhotoParser *rp_stream, ragephoto_t instance, uint8_t sections)
+{
+    ragephotodata_parser_init(rp_stream, instance->data, sections);
+}
+
+RagePhotoParserStatus ragephoto_parser_feed(RagePhotoParser *rp_stream, const char *data, size_t size)
+{
+    size_t pos = 0;
+    while (rp_stream->state < PARSER_STATE_FINISHED) {
+        if (rp_stream->fieldPos != rp_stream->fieldSize) {
+            if (pos == size)
+                return RAGEPHOTO_PARSER_CONTINUE;
+            size_t chunkSize = rp_stream->fieldSize - rp_stream->fieldPos;
+            if (chunkSize > size - pos)
+                chunkSize = size - pos;
+            char *target = parserTarget(rp_stream);
+            if (target && rp_stream->signing && rp_stream->state == PARSER_STATE_JPEG)
+                rp_stream->data->jpegSign = joaatCopy((uint32_t)rp_stream->data->jpegSign, &target[rp_stream->fieldPos], &data[pos], chunkSize);
+            else if (target)
+                memcpy(&target[rp_stream->fieldPos], &data[pos], chunkSize);
+            pos += chunkSize;
+            rp_stream->fieldPos += (uint32_t)chunkSize;
+            if (rp_stream->fieldPos != rp_stream->fieldSize)
+                return RAGEPHOTO_PARSER_CONTINUE;
+        }
+        if (!parserNext(rp_stream)) {
+            rp_stream->state = PARSER_STATE_ERROR;
+            return RAGEPHOTO_PARSER_ERROR;
+        }
+    }
+    return (rp_stream->state == PARSER_STATE_FINISHED) ? RAGEPHOTO_PARSER_FINISHED : RAGEPHOTO_PARSER_ERROR;
+}
+
+bool ragephoto_parser_finish(RagePhotoParser *rp_stream)
+{
+    if (rp_stream->state == PARSER_STATE_FINISHED)
+        return true;
+    else if (rp_stream->state == PARSER_STATE_ERROR)
+        return false;
+
+    RagePhotoData *rp_data = rp_stream->data;
+    char **section = NULL;
+    uint32_t *capacity = NULL;
+    if (rp_stream->state == PARSER_STATE_JPEG) {
+        section = &rp_data->jpeg;
+        capacity = &rp_data->jpegCapacity;
+    }
+    else if (rp_stream->state == PARSER_STATE_JSON) {
+        section = &rp_data->json;
+        capacity = &rp_data->jsonCapacity;
+    }
+    else if (rp_stream->state == PARSER_STATE_TITLE) {
+        section = &rp_data->title;
+        capacity = &rp_data->titlCapacity;
+    }
+    else if (rp_stream->state == PARSER_STATE_DESC) {
+        section = &rp_data->description;
+        capacity = &rp_data->descCapacity;
+    }
+    if (section) {
+        freeBuffer(rp_data, *section);
+        *section = NULL;
+        *capacity = 0;
+    }
+    rp_data->error = parserIncompleteError[rp_stream->state];
+    rp_stream->state = PARSER_STATE_ERROR;
+    return false;
+}
+/* END OF RAGEPHOTO PARSER CLASS */
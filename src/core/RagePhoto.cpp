@@ -21,12 +21,16 @@
 #include "RagePhoto.h"
 #include <cinttypes>
 #endif
+#include <atomic>
 
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <mutex>
+#include <new>
+#include <vector>
 
 #ifdef _WIN32
 #ifndef VC_EXTRALEAN
@@ -44,13 +48,56 @@
 #include <chrono>
 #endif
 
+#ifdef RAGEPHOTO_THREADS
+#include <system_error>
+#include <thread>
+#endif
+
+#ifdef RAGEPHOTO_IO_URING
+#include "RagePhotoUring.h"
+#include <new>
+#include <sys/stat.h>
+#define RAGEPHOTO_URING_DEPTH 32
+#define RAGEPHOTO_URING_READSIZE static_cast<size_t>(0x40000000)
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#if defined(_POSIX_VERSION) && (_POSIX_VERSION >= 200112L)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#define RAGEPHOTO_MEMALIGN
+#define RAGEPHOTO_PREAD
+#endif
+#if defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define RAGEPHOTO_MMAP
+#endif
+#endif
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#define RAGEPHOTO_DIRECT_SAVE
+#endif
+
 #if defined UNICODE_CODECVT
 #include <codecvt>
 #include <locale>
+#include <stdexcept>
 #elif defined UNICODE_ICONV
 #include <iconv.h>
+#elif defined UNICODE_BUILTIN
+#include "RagePhotoUnicode.h"
 #endif
 
+#include "RagePhotoJoaat.h"
+
 #if defined(_WIN32) && (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
 #include <filesystem>
 #elif defined(_WIN32)
@@ -62,8 +109,206 @@ typedef ragephoto::photo RagePhoto;
 
 /* RAGEPHOTO LIBRARY GLOBALS */
 int libraryflags = 0;
+RagePhotoSizeLimits sizelimits = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+RagePhotoAllocator libraryallocator = {nullptr, nullptr, nullptr, nullptr};
 const char* nullchar = "";
 
+/* RAGEPHOTO STORAGE TYPEDEF */
+typedef struct RagePhotoStorage {
+    size_t size;
+    // RagePhotoData objects sharing the storage, sections are copied before they are changed
+    std::atomic<size_t> refs;
+} RagePhotoStorage;
+
+// Sections start after the aligned storage header, each section is aligned
+#define RAGEPHOTO_ALIGN_SIZE(size) (((size) + RAGEPHOTO_BUFFER_ALIGNMENT - 1) & ~static_cast<size_t>(RAGEPHOTO_BUFFER_ALIGNMENT - 1))
+#define RAGEPHOTO_STORAGE_OFFSET RAGEPHOTO_ALIGN_SIZE(sizeof(RagePhotoStorage))
+
+/* RAGEPHOTO PARSER REGISTRY TYPEDEF */
+struct RagePhotoRegistrySlot {
+    RagePhotoFormatParser parser;
+    bool used;
+};
+
+struct RagePhotoRegistry {
+    RagePhotoRegistry *previous;
+    std::vector<RagePhotoRegistrySlot> slots;
+    size_t count;
+    size_t mask;
+};
+
+/* RAGEPHOTO PARSER REGISTRY GLOBALS */
+// Published registries are immutable, replaced ones are freed by the next update when no lookup is running
+std::atomic<RagePhotoRegistry*> parserregistry(nullptr);
+std::atomic<size_t> registryreaders(0);
+std::mutex registrylock;
+
+/* RAGEPHOTO INSTANCE POOL GLOBALS */
+// Pooled objects are reset, their section buffers are kept for the next load
+RagePhoto* instancepool[16];
+size_t instancepoolsize = 0;
+std::mutex poollock;
+
+/* RAGEPHOTO BATCH TYPEDEF */
+struct RagePhotoBatch {
+    RagePhotoBatch(RagePhoto *const *photos, const char *const *filenames, size_t count, bool metadata) :
+        photos(photos), filenames(filenames), count(count), metadata(metadata), next(0), loaded(0) {}
+    RagePhoto *const *photos;
+    const char *const *filenames;
+    size_t count;
+    bool metadata;
+    std::atomic<size_t> next;
+    std::atomic<size_t> loaded;
+};
+
+#ifdef RAGEPHOTO_IO_URING
+/* RAGEPHOTO IO_URING SLOT TYPEDEF */
+struct RagePhotoUringSlot {
+    std::string buffer;
+    size_t fileSize = 0;
+    size_t readPos = 0;
+    size_t index = 0;
+    int fd = -1;
+    bool busy = false;
+};
+#endif
+
+/* RAGEPHOTO PARSER STATES */
+enum RagePhotoParserState : uint8_t {
+    PARSER_STATE_FORMAT,
+    PARSER_STATE_HEADER,
+    PARSER_STATE_HEADERSUM,
+    PARSER_STATE_FORMATCHECK,
+    PARSER_STATE_HEADERSUM2,
+    PARSER_STATE_EOF,
+    PARSER_STATE_JSONOFFSET,
+    PARSER_STATE_TITLOFFSET,
+    PARSER_STATE_DESCOFFSET,
+    PARSER_STATE_JPEGMARKER,
+    PARSER_STATE_JPEGBUFFER,
+    PARSER_STATE_JPEGSIZE,
+    PARSER_STATE_JPEG,
+    PARSER_STATE_JPEGPADDING,
+    PARSER_STATE_JSONMARKER,
+    PARSER_STATE_JSONBUFFER,
+    PARSER_STATE_JSON,
+    PARSER_STATE_TITLMARKER,
+    PARSER_STATE_TITLBUFFER,
+    PARSER_STATE_TITLE,
+    PARSER_STATE_DESCMARKER,
+    PARSER_STATE_DESCBUFFER,
+    PARSER_STATE_DESC,
+    PARSER_STATE_JENDMARKER,
+    PARSER_STATE_FINISHED,
+    PARSER_STATE_ERROR
+};
+
+/* RAGEPHOTO PARSER INCOMPLETE ERRORS (same order as parser states) */
+static const int32_t parserIncompleteError[] = {
+    RagePhoto::Error::NoFormatIdentifier, // 1
+    RagePhoto::Error::IncompleteHeader, // 3
+    RagePhoto::Error::IncompleteChecksum, // 7
+    RagePhoto::Error::IncompleteChecksum, // 7
+    RagePhoto::Error::IncompleteChecksum, // 7
+    RagePhoto::Error::IncompleteEOF, // 8
+    RagePhoto::Error::IncompleteJsonOffset, // 9
+    RagePhoto::Error::IncompleteTitleOffset, // 10
+    RagePhoto::Error::IncompleteDescOffset, // 11
+    RagePhoto::Error::IncompleteJpegMarker, // 12
+    RagePhoto::Error::IncompletePhotoBuffer, // 14
+    RagePhoto::Error::IncompletePhotoSize, // 15
+    RagePhoto::Error::PhotoReadError, // 17
+    RagePhoto::Error::IncompleteJsonMarker, // 18
+    RagePhoto::Error::IncompleteJsonMarker, // 18
+    RagePhoto::Error::IncompleteJsonBuffer, // 20
+    RagePhoto::Error::JsonReadError, // 22
+    RagePhoto::Error::IncompleteTitleMarker, // 23
+    RagePhoto::Error::IncompleteTitleBuffer, // 25
+    RagePhoto::Error::TitleReadError, // 27
+    RagePhoto::Error::IncompleteDescMarker, // 28
+    RagePhoto::Error::IncompleteDescBuffer, // 30
+    RagePhoto::Error::DescReadError, // 32
+    RagePhoto::Error::IncompleteJendMarker // 33
+};
+
+/* RAGEPHOTO SECTION MARKERS (little endian) */
+#define RAGEPHOTO_MARKER_JPEG UINT32_C(0x4745504A)
+#define RAGEPHOTO_MARKER_JSON UINT32_C(0x4E4F534A)
+#define RAGEPHOTO_MARKER_TITL UINT32_C(0x4C544954)
+#define RAGEPHOTO_MARKER_DESC UINT32_C(0x43534544)
+#define RAGEPHOTO_MARKER_JEND UINT32_C(0x444E454A)
+
+/* RAGEPHOTO LAYOUT FIELDS */
+enum RagePhotoLayoutField : uint8_t {
+    LAYOUT_FIELD_HEADERSUM,
+    LAYOUT_FIELD_HEADERSUM2,
+    LAYOUT_FIELD_EOF,
+    LAYOUT_FIELD_JSONOFFSET,
+    LAYOUT_FIELD_TITLOFFSET,
+    LAYOUT_FIELD_DESCOFFSET,
+    LAYOUT_FIELD_JPEGBUFFER,
+    LAYOUT_FIELD_JPEGSIZE,
+    LAYOUT_FIELD_CONSTANT
+};
+
+/* RAGEPHOTO LAYOUT TYPEDEFS */
+struct RagePhotoLayoutEntry {
+    uint32_t offset;
+    uint32_t field;
+    // Expected value of LAYOUT_FIELD_CONSTANT entries
+    uint32_t value;
+    // Error when the Photo ends within the entry
+    int32_t error;
+    // Error when a constant entry doesn't match
+    int32_t checkError;
+};
+
+struct RagePhotoLayout {
+    const RagePhotoLayoutEntry *entries;
+    size_t count;
+    size_t size;
+};
+
+// Fixed fields following the format identifier and the 256 bytes UTF-16LE header
+static const RagePhotoLayoutEntry gta5LayoutEntries[] = {
+    {260, LAYOUT_FIELD_HEADERSUM, 0, RagePhoto::Error::IncompleteChecksum, 0}, // 7
+    {264, LAYOUT_FIELD_EOF, 0, RagePhoto::Error::IncompleteEOF, 0}, // 8
+    {268, LAYOUT_FIELD_JSONOFFSET, 0, RagePhoto::Error::IncompleteJsonOffset, 0}, // 9
+    {272, LAYOUT_FIELD_TITLOFFSET, 0, RagePhoto::Error::IncompleteTitleOffset, 0}, // 10
+    {276, LAYOUT_FIELD_DESCOFFSET, 0, RagePhoto::Error::IncompleteDescOffset, 0}, // 11
+    {280, LAYOUT_FIELD_CONSTANT, RAGEPHOTO_MARKER_JPEG, RagePhoto::Error::IncompleteJpegMarker, RagePhoto::Error::IncorrectJpegMarker}, // 12, 13
+    {284, LAYOUT_FIELD_JPEGBUFFER, 0, RagePhoto::Error::IncompletePhotoBuffer, 0}, // 14
+    {288, LAYOUT_FIELD_JPEGSIZE, 0, RagePhoto::Error::IncompletePhotoSize, 0} // 15
+};
+
+static const RagePhotoLayoutEntry rdr2LayoutEntries[] = {
+    {260, LAYOUT_FIELD_HEADERSUM, 0, RagePhoto::Error::IncompleteChecksum, 0}, // 7
+    {264, LAYOUT_FIELD_CONSTANT, 0, RagePhoto::Error::IncompleteChecksum, RagePhoto::Error::IncompatibleFormat}, // 7, 2
+    {268, LAYOUT_FIELD_HEADERSUM2, 0, RagePhoto::Error::IncompleteChecksum, 0}, // 7
+    {272, LAYOUT_FIELD_EOF, 0, RagePhoto::Error::IncompleteEOF, 0}, // 8
+    {276, LAYOUT_FIELD_JSONOFFSET, 0, RagePhoto::Error::IncompleteJsonOffset, 0}, // 9
+    {280, LAYOUT_FIELD_TITLOFFSET, 0, RagePhoto::Error::IncompleteTitleOffset, 0}, // 10
+    {284, LAYOUT_FIELD_DESCOFFSET, 0, RagePhoto::Error::IncompleteDescOffset, 0}, // 11
+    {288, LAYOUT_FIELD_CONSTANT, RAGEPHOTO_MARKER_JPEG, RagePhoto::Error::IncompleteJpegMarker, RagePhoto::Error::IncorrectJpegMarker}, // 12, 13
+    {292, LAYOUT_FIELD_JPEGBUFFER, 0, RagePhoto::Error::IncompletePhotoBuffer, 0}, // 14
+    {296, LAYOUT_FIELD_JPEGSIZE, 0, RagePhoto::Error::IncompletePhotoSize, 0} // 15
+};
+
+static const RagePhotoLayout gta5Layout = {gta5LayoutEntries, sizeof(gta5LayoutEntries) / sizeof(RagePhotoLayoutEntry), 292};
+static const RagePhotoLayout rdr2Layout = {rdr2LayoutEntries, sizeof(rdr2LayoutEntries) / sizeof(RagePhotoLayoutEntry), 300};
+#define RAGEPHOTO_LAYOUT_MAXSIZE 300
+
+/* RAGEPHOTO SECTION ENTRY TYPEDEF */
+struct RagePhotoSectionEntry {
+    char **data;
+    uint32_t *buffer;
+    uint32_t *capacity;
+    uint32_t limit;
+    uint32_t marker;
+    // Loading uses the incomplete marker error, saving the buffer tight error
+    int32_t error;
+};
+
 /* BEGIN OF STATIC LIBRARY FUNCTIONS */
 #if defined(_WIN32) && ((RAGEPHOTO_CXX_STD < 17) || (__cplusplus < 201703L))
 inline std::wstring convertPath(const char *path)
@@ -80,6 +325,77 @@ inline std::wstring convertPath(const char *path)
 }
 #endif
 
+#ifdef RAGEPHOTO_MMAP
+inline char* mapFile(const char *filename, size_t *size)
+{
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0 || static_cast<uintmax_t>(fileStat.st_size) > SIZE_MAX) {
+        close(fd);
+        return nullptr;
+    }
+    int mapFlags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (libraryflags & RAGEPHOTO_FLAG_MMAP_POPULATE)
+        mapFlags |= MAP_POPULATE;
+#endif
+    void *data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, mapFlags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+#ifdef MADV_SEQUENTIAL
+    if (libraryflags & RAGEPHOTO_FLAG_MMAP_SEQUENTIAL)
+        madvise(data, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+#endif
+    *size = static_cast<size_t>(fileStat.st_size);
+    return static_cast<char*>(data);
+}
+#endif
+
+#if defined(_WIN32) || defined(RAGEPHOTO_PREAD)
+inline int64_t fileSizeFd(int fd)
+{
+#ifdef _WIN32
+    return _filelengthi64(fd);
+#else
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode))
+        return -1;
+    return static_cast<int64_t>(fileStat.st_size);
+#endif
+}
+
+/* Reads exactly size bytes at offset, pread leaves the file position untouched */
+inline bool readFileAt(int fd, char *data, size_t size, int64_t offset)
+{
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) == -1)
+        return false;
+    while (size) {
+        const int readSize = _read(fd, data, (size > 0x40000000) ? 0x40000000 : static_cast<unsigned int>(size));
+        if (readSize <= 0)
+            return false;
+        data += readSize;
+        size -= static_cast<size_t>(readSize);
+    }
+#else
+    while (size) {
+        const ssize_t readSize = pread(fd, data, size, static_cast<off_t>(offset));
+        if (readSize == -1 && errno == EINTR)
+            continue;
+        if (readSize <= 0)
+            return false;
+        data += readSize;
+        size -= static_cast<size_t>(readSize);
+        offset += readSize;
+    }
+#endif
+    return true;
+}
+#endif
+
 inline size_t readBuffer(const char *input, void *output, size_t *pos, size_t outputLen, size_t inputLen)
 {
     size_t readLen = 0;
@@ -119,43 +435,301 @@ inline size_t zeroBuffer(char *output, size_t *pos, size_t outputLen, size_t inp
     return zeroLen;
 }
 
-inline bool writeDataChar(const char *input, char **output)
+/* Shared by all scatter-gather saves, only ever read */
+static char zeroPage[RAGEPHOTO_SAVEIOV_ZEROSIZE];
+
+/* Entries past count are only counted, the caller retries with enough entries */
+inline void appendIov(RagePhotoIovec *iov, size_t count, size_t *index, char *data, size_t length)
+{
+    if (*index < count) {
+        iov[*index].iov_base = data;
+        iov[*index].iov_len = length;
+    }
+    *index = *index + 1;
+}
+
+inline void appendZeroIov(RagePhotoIovec *iov, size_t count, size_t *index, size_t length)
+{
+    while (length) {
+        const size_t zeroLen = (length > RAGEPHOTO_SAVEIOV_ZEROSIZE) ? RAGEPHOTO_SAVEIOV_ZEROSIZE : length;
+        appendIov(iov, count, index, zeroPage, zeroLen);
+        length -= zeroLen;
+    }
+}
+
+#ifdef RAGEPHOTO_DIRECT_SAVE
+inline bool writeFull(int fd, const char *data, size_t length, off_t offset)
+{
+    while (length) {
+        const ssize_t written = pwrite(fd, data, length, offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+        offset += written;
+    }
+    return true;
+}
+
+/* Zero page entries are seeked past and stay holes, data runs are reserved before writing them */
+inline bool writeFileIov(int fd, const RagePhotoIovec *iov, size_t count)
+{
+    off_t offset = 0;
+    size_t i = 0;
+    while (i < count) {
+        if (iov[i].iov_base == zeroPage) {
+            offset += static_cast<off_t>(iov[i].iov_len);
+            i++;
+            continue;
+        }
+        size_t runLen = 0;
+        for (size_t j = i; j < count && iov[j].iov_base != zeroPage; j++)
+            runLen += iov[j].iov_len;
+        // A failed reservation only loses the preallocation, the write reports real errors
+        if (runLen)
+            posix_fallocate(fd, offset, static_cast<off_t>(runLen));
+        for (; i < count && iov[i].iov_base != zeroPage; i++) {
+            if (!writeFull(fd, static_cast<const char*>(iov[i].iov_base), iov[i].iov_len, offset))
+                return false;
+            offset += static_cast<off_t>(iov[i].iov_len);
+        }
+    }
+    // Trailing padding is never written, the size has to be set explicitly
+    return (ftruncate(fd, offset) == 0);
+}
+
+/* Sets opened to false when neither the target nor a temporary file could be created */
+/* Syncs the directory of a renamed file, file systems without directory sync are accepted */
+inline bool syncDirectory(const std::string &filename)
+{
+    const size_t separator = filename.rfind('/');
+    const std::string directory = (separator == std::string::npos) ? "." : filename.substr(0, separator ? separator : 1);
+    const int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1)
+        return true;
+    const bool synced = (fsync(fd) == 0 || errno == EINVAL);
+    close(fd);
+    return synced;
+}
+
+inline bool saveFileDirect(const char *filename, const RagePhotoIovec *iov, size_t count, bool *opened)
+{
+    *opened = true;
+    // Symbolic links are kept, the file they point to is replaced
+    std::string target;
+    if (libraryflags & RAGEPHOTO_FLAG_ATOMIC_SAVE) {
+        char *resolved = realpath(filename, nullptr);
+        if (resolved) {
+            target = resolved;
+            free(resolved);
+        }
+        else if (errno != ENOENT) {
+            *opened = false;
+            return false;
+        }
+        else {
+            // New files are created in place, dangling links are written through below
+            struct stat lst;
+            if (lstat(filename, &lst) != 0)
+                target = filename;
+        }
+    }
+    if (target.empty()) {
+        const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd == -1) {
+            *opened = false;
+            return false;
+        }
+        const bool written = writeFileIov(fd, iov, count);
+        return (close(fd) == 0) && written;
+    }
+    // The temporary file is created next to the target, rename only replaces within the same file system
+    std::string tempname;
+    int fd = -1;
+    for (unsigned int i = 0; fd == -1 && i < 100; i++) {
+        tempname = target + "." + std::to_string(static_cast<long>(getpid())) + "." + std::to_string(i) + ".tmp";
+        fd = open(tempname.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd == -1 && errno != EEXIST)
+            break;
+    }
+    if (fd == -1) {
+        *opened = false;
+        return false;
+    }
+    struct stat st;
+    if (stat(target.c_str(), &st) == 0)
+        fchmod(fd, st.st_mode & 07777);
+    bool written = writeFileIov(fd, iov, count) && (fdatasync(fd) == 0);
+    written = (close(fd) == 0) && written;
+    if (written)
+        written = (std::rename(tempname.c_str(), target.c_str()) == 0);
+    if (!written)
+        unlink(tempname.c_str());
+    else
+        written = syncDirectory(target);
+    return written;
+}
+#endif
+
+inline const RagePhotoAllocator* dataAllocator(const RagePhotoData *rp_data)
+{
+    return rp_data->allocator ? rp_data->allocator : &libraryallocator;
+}
+
+inline void* allocBuffer(const RagePhotoData *rp_data, size_t size)
+{
+    const RagePhotoAllocator *rp_allocator = dataAllocator(rp_data);
+    if (rp_allocator->funcMalloc)
+        return (rp_allocator->funcMalloc)(size, RAGEPHOTO_BUFFER_ALIGNMENT, rp_allocator->context);
+#ifdef RAGEPHOTO_MEMALIGN
+    // Aligned buffers stay compatible with free, adopted buffers only have to be allocated with malloc
+    void *data;
+    if (posix_memalign(&data, RAGEPHOTO_BUFFER_ALIGNMENT, size) != 0)
+        return nullptr;
+    return data;
+#else
+    return malloc(size);
+#endif
+}
+
+inline void freeBuffer(const RagePhotoData *rp_data, void *data)
+{
+    const RagePhotoAllocator *rp_allocator = dataAllocator(rp_data);
+    if (!rp_allocator->funcMalloc)
+        free(data);
+    else if (data && rp_allocator->funcFree)
+        (rp_allocator->funcFree)(data, rp_allocator->context);
+}
+
+/* Only used to shrink buffers, the first size bytes are kept */
+inline void* reallocBuffer(const RagePhotoData *rp_data, void *data, size_t size)
+{
+    const RagePhotoAllocator *rp_allocator = dataAllocator(rp_data);
+#ifndef RAGEPHOTO_MEMALIGN
+    if (!rp_allocator->funcMalloc)
+        return realloc(data, size);
+#endif
+    // realloc doesn't keep the alignment, shrinking is done with a new buffer
+    if (rp_allocator->funcMalloc && rp_allocator->funcRealloc)
+        return (rp_allocator->funcRealloc)(data, size, RAGEPHOTO_BUFFER_ALIGNMENT, rp_allocator->context);
+    void *t_data = allocBuffer(rp_data, size);
+    if (t_data) {
+        memcpy(t_data, data, size);
+        freeBuffer(rp_data, data);
+    }
+    return t_data;
+}
+
+inline bool writeDataCharl(RagePhotoData *rp_data, const char *input, size_t length, char **output, uint32_t *capacity)
 {
     if (input) {
-        const size_t src_s = strlen(input) + 1;
-        if (*output) {
-            const size_t dst_s = strlen(*output) + 1;
+        const size_t src_s = length + 1;
+        if (*output && *capacity >= src_s) {
+            memcpy(*output, input, length);
+            (*output)[length] = '\0';
+        }
+        else if (*output) {
+            // Only buffers of unknown capacity are measured
+            const size_t dst_s = *capacity ? *capacity : strlen(*output) + 1;
             if (dst_s > src_s) {
-                char *t_output = static_cast<char*>(realloc(*output, src_s));
+                char *t_output = static_cast<char*>(reallocBuffer(rp_data, *output, src_s));
                 if (!t_output)
                     return false;
                 *output = t_output;
-                memcpy(*output, input, src_s);
+                *capacity = static_cast<uint32_t>(src_s);
+                memcpy(*output, input, length);
+                (*output)[length] = '\0';
             }
             else if (dst_s < src_s) {
-                char *t_output = static_cast<char*>(malloc(src_s));
+                char *t_output = static_cast<char*>(allocBuffer(rp_data, src_s));
                 if (!t_output)
                     return false;
-                free(*output);
+                freeBuffer(rp_data, *output);
                 *output = t_output;
-                memcpy(*output, input, src_s);
+                *capacity = static_cast<uint32_t>(src_s);
+                memcpy(*output, input, length);
+                (*output)[length] = '\0';
             }
             else {
-                memcpy(*output, input, src_s);
+                *capacity = static_cast<uint32_t>(src_s);
+                memcpy(*output, input, length);
+                (*output)[length] = '\0';
             }
         }
         else {
-            char *t_output = static_cast<char*>(malloc(src_s));
+            char *t_output = static_cast<char*>(allocBuffer(rp_data, src_s));
             if (!t_output)
                 return false;
             *output = t_output;
-            memcpy(*output, input, src_s);
+            *capacity = static_cast<uint32_t>(src_s);
+            memcpy(*output, input, length);
+            (*output)[length] = '\0';
         }
     }
     else if (*output) {
-        free(*output);
+        freeBuffer(rp_data, *output);
         *output = nullptr;
+        *capacity = 0;
+    }
+    return true;
+}
+
+inline bool writeDataChar(RagePhotoData *rp_data, const char *input, char **output, uint32_t *capacity)
+{
+    return writeDataCharl(rp_data, input, input ? strlen(input) : 0, output, capacity);
+}
+
+/* Moves a buffer kept by RagePhoto::reset into an empty section */
+inline void adoptData(RagePhotoData *rp_data, char **output, uint32_t *capacity)
+{
+    char **retained;
+    uint32_t *retainedCapacity;
+    if (output == &rp_data->jpeg) {
+        retained = &rp_data->jpegRetained;
+        retainedCapacity = &rp_data->jpegRetainedCapacity;
     }
+    else if (output == &rp_data->description) {
+        retained = &rp_data->descRetained;
+        retainedCapacity = &rp_data->descRetainedCapacity;
+    }
+    else if (output == &rp_data->json) {
+        retained = &rp_data->jsonRetained;
+        retainedCapacity = &rp_data->jsonRetainedCapacity;
+    }
+    else if (output == &rp_data->header) {
+        retained = &rp_data->headerRetained;
+        retainedCapacity = &rp_data->headerRetainedCapacity;
+    }
+    else if (output == &rp_data->title) {
+        retained = &rp_data->titlRetained;
+        retainedCapacity = &rp_data->titlRetainedCapacity;
+    }
+    else {
+        return;
+    }
+    if (!*retained)
+        return;
+    *output = *retained;
+    *capacity = *retainedCapacity;
+    *retained = nullptr;
+    *retainedCapacity = 0;
+}
+
+inline bool reserveData(RagePhotoData *rp_data, char **output, uint32_t *capacity, size_t size)
+{
+    if (!*output)
+        adoptData(rp_data, output, capacity);
+    if (*output && *capacity >= size)
+        return true;
+    char *t_output = static_cast<char*>(allocBuffer(rp_data, size));
+    if (!t_output)
+        return false;
+    freeBuffer(rp_data, *output);
+    *output = t_output;
+    *capacity = static_cast<uint32_t>(size);
     return true;
 }
 
@@ -175,1422 +749,3340 @@ inline void uInt32ToCharLE(uint32_t x, char *y)
     y[3] = x >> 24;
 }
 
-inline uint32_t joaatFromInitial(const char *data, size_t size, uint32_t init_val)
+inline uint32_t signInitial(uint32_t photoFormat)
 {
-    uint32_t val = init_val;
-    for (size_t i = 0; i != size; i++) {
-        val += data[i];
-        val += val << 10;
-        val ^= val >> 6;
-    }
-    val += val << 3;
-    val ^= val >> 11;
-    val += val << 15;
-    return val;
+    return (photoFormat == RagePhoto::PhotoFormat::RDR2) ? RagePhoto::SignInitials::SIRDR2 : RagePhoto::SignInitials::SIGTA5;
 }
 
-/* END OF STATIC LIBRARY FUNCTIONS */
+inline size_t viewBuffer(const char *input, const char **output, size_t *pos, size_t outputLen, size_t inputLen)
+{
+    size_t viewLen = 0;
+    if (*pos >= inputLen)
+        return 0;
+    viewLen = inputLen - *pos;
+    if (viewLen > outputLen)
+        viewLen = outputLen;
+    *output = &input[*pos];
+    *pos = *pos + viewLen;
+    return viewLen;
+}
 
-/* BEGIN OF RAGEPHOTO CLASS */
-RagePhoto::photo()
+inline uint32_t viewUInt32(const char *input, size_t *pos, size_t inputLen, bool *ok)
 {
-    m_data = static_cast<RagePhotoData*>(malloc(sizeof(RagePhotoData)));
-    if (!m_data)
-        throw std::runtime_error("RagePhotoData data struct can't be allocated");
-    memset(m_data, 0, sizeof(RagePhotoData));
-    m_parser = static_cast<RagePhotoFormatParser*>(malloc(sizeof(RagePhotoFormatParser)));
-    if (!m_parser)
-        throw std::runtime_error("RagePhotoFormatParser parser struct can't be allocated");
-    memset(m_parser, 0, sizeof(RagePhotoFormatParser));
-    setBufferDefault(m_data);
+    uint32_t value = 0;
+    *ok = (readBuffer(input, &value, pos, 4, inputLen) == 4);
+#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
+    value = swapUInt32(value);
+#endif
+    return value;
 }
 
-RagePhoto::~photo()
+inline bool decodeHeader(const char *input, char *output, size_t outputLen)
 {
-    free(m_data->jpeg);
-    free(m_data->description);
-    free(m_data->json);
-    free(m_data->header);
-    free(m_data->title);
-    free(m_data);
-    free(m_parser);
+    if (!input || !output || outputLen == 0)
+        return false;
+#if defined UNICODE_BUILTIN
+    return (convertUtf16LeToUtf8(input, 128, output, outputLen) < UNICODE_BUILTIN_TIGHT);
+#elif defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT
+    char16_t photoHeader[129]{};
+    memcpy(photoHeader, input, 256);
+    size_t photoHeader_length = 0;
+    while (photoHeader_length != 128 && photoHeader[photoHeader_length] != 0)
+        photoHeader_length++;
+#if defined UNICODE_CODECVT
+    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>,char16_t> convert;
+    std::string photoHeader_string;
+    try {
+        photoHeader_string = convert.to_bytes(photoHeader, photoHeader + photoHeader_length);
+    }
+    catch (const std::range_error&) {
+        return false;
+    }
+    if (convert.converted() != photoHeader_length || photoHeader_string.size() >= outputLen)
+        return false;
+    memcpy(output, photoHeader_string.c_str(), photoHeader_string.size() + 1);
+    return true;
+#elif defined UNICODE_ICONV
+    iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
+    if (iconv_in == (iconv_t)-1)
+        return false;
+    size_t src_s = photoHeader_length * sizeof(char16_t);
+    size_t dst_s = outputLen - 1;
+    char *src = reinterpret_cast<char*>(photoHeader);
+    char *dst = output;
+    const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+    iconv_close(iconv_in);
+    if (ret == static_cast<size_t>(-1))
+        return false;
+    *dst = '\0';
+    return true;
+#elif defined UNICODE_WINCVT
+    if (photoHeader_length == 0) {
+        output[0] = '\0';
+        return true;
+    }
+    const int converted = WideCharToMultiByte(CP_UTF8, 0, reinterpret_cast<wchar_t*>(photoHeader), static_cast<int>(photoHeader_length), output, static_cast<int>(outputLen - 1), NULL, NULL);
+    if (converted == 0)
+        return false;
+    output[converted] = '\0';
+    return true;
+#endif
+#else
+    return false;
+#endif
 }
 
-void RagePhoto::addParser(RagePhotoFormatParser *rp_parser)
+#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT || defined UNICODE_BUILTIN
+inline bool loadHeader(RagePhotoData *rp_data, char *photoHeader)
 {
-    if (rp_parser) {
-        RagePhotoFormatParser n_parser[1]{};
-        if (!memcmp(&n_parser[0], rp_parser, sizeof(RagePhotoFormatParser)))
-            return;
-        size_t length;
-        for (length = 0; memcmp(&n_parser[0], &m_parser[length], sizeof(RagePhotoFormatParser)); length++);
-        RagePhotoFormatParser *t_parser = static_cast<RagePhotoFormatParser*>(realloc(m_parser, (length + 2) * sizeof(RagePhotoFormatParser)));
-        if (!t_parser)
-            throw std::runtime_error("RagePhotoFormatParser array can't be expanded");
-        m_parser = t_parser;
-        memcpy(&m_parser[length], rp_parser, sizeof(RagePhotoFormatParser));
-        memset(&m_parser[length + 1], 0, sizeof(RagePhotoFormatParser));
+#if defined UNICODE_CODECVT
+    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>,char16_t> convert;
+    std::string photoHeader_string;
+    try {
+        photoHeader_string = convert.to_bytes(reinterpret_cast<char16_t*>(photoHeader));
+    }
+    catch (const std::range_error&) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+    if (convert.converted() == 0) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+    const size_t photoHeader_size = photoHeader_string.size() + 1;
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, photoHeader_size)) {
+        rp_data->error = RagePhoto::Error::HeaderMallocError; // 4
+        return false;
+    }
+    memcpy(rp_data->header, photoHeader_string.data(), photoHeader_size);
+#elif defined UNICODE_ICONV
+    iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
+    if (iconv_in == (iconv_t)-1) {
+        rp_data->error = RagePhoto::Error::UnicodeInitError; // 4
+        return false;
+    }
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, 256)) {
+        rp_data->error = RagePhoto::Error::HeaderMallocError; // 4
+        iconv_close(iconv_in);
+        return false;
+    }
+    size_t src_s = 256;
+    size_t dst_s = 256;
+    char *src = photoHeader;
+    char *dst = rp_data->header;
+    const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+    iconv_close(iconv_in);
+    if (ret == static_cast<size_t>(-1)) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+#elif defined UNICODE_WINCVT
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, 256)) {
+        rp_data->error = RagePhoto::Error::HeaderMallocError; // 4
+        return false;
+    }
+    const int converted = WideCharToMultiByte(CP_UTF8, 0, reinterpret_cast<wchar_t*>(photoHeader), -1, rp_data->header, 256, NULL, NULL);
+    if (converted == 0) {
+        freeBuffer(rp_data, rp_data->header);
+        rp_data->header = nullptr;
+        rp_data->headerCapacity = 0;
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+#elif defined UNICODE_BUILTIN
+    char header[385];
+    const size_t header_length = convertUtf16LeToUtf8(photoHeader, 128, header, sizeof(header));
+    if (header_length >= UNICODE_BUILTIN_TIGHT) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+    if (!reserveData(rp_data, &rp_data->header, &rp_data->headerCapacity, header_length + 1)) {
+        rp_data->error = RagePhoto::Error::HeaderMallocError; // 4
+        return false;
     }
+    memcpy(rp_data->header, header, header_length + 1);
+#endif
+    return true;
 }
 
-void RagePhoto::clear(RagePhotoData *rp_data)
+inline bool saveHeader(RagePhotoData *rp_data, char *photoHeader)
 {
-    free(rp_data->jpeg);
-    free(rp_data->description);
-    free(rp_data->json);
-    free(rp_data->header);
-    free(rp_data->title);
-    memset(rp_data, 0, sizeof(RagePhotoData));
-    setBufferDefault(rp_data);
+    // Writes the 256 bytes of the UTF-16LE header, zero-filled after the converted header
+#if defined UNICODE_CODECVT
+    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>,char16_t> convert;
+    std::u16string photoHeader_string;
+    try {
+        photoHeader_string = convert.from_bytes(rp_data->header);
+    }
+    catch (const std::range_error&) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+    if (convert.converted() == 0) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+    const size_t photoHeader_size = photoHeader_string.size() * sizeof(char16_t);
+    if (photoHeader_size > 256) {
+        rp_data->error = RagePhoto::Error::HeaderBufferTight; // 35
+        return false;
+    }
+    memcpy(photoHeader, photoHeader_string.data(), photoHeader_size);
+    memset(&photoHeader[photoHeader_size], 0, 256 - photoHeader_size);
+#elif defined UNICODE_ICONV
+    iconv_t iconv_in = iconv_open("UTF-16LE", "UTF-8");
+    if (iconv_in == (iconv_t)-1) {
+        rp_data->error = RagePhoto::Error::UnicodeInitError; // 4
+        return false;
+    }
+    memset(photoHeader, 0, 256);
+    size_t src_s = strlen(rp_data->header);
+    size_t dst_s = 256;
+    char *src = rp_data->header;
+    char *dst = photoHeader;
+    const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
+    iconv_close(iconv_in);
+    if (ret == static_cast<size_t>(-1)) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+#elif defined UNICODE_WINCVT
+    memset(photoHeader, 0, 256);
+    const int converted = MultiByteToWideChar(CP_UTF8, 0, rp_data->header, static_cast<int>(strlen(rp_data->header)), reinterpret_cast<wchar_t*>(photoHeader), 256 / sizeof(wchar_t));
+    if (converted == 0) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+#elif defined UNICODE_BUILTIN
+    const size_t photoHeader_size = convertUtf8ToUtf16Le(rp_data->header, strlen(rp_data->header), photoHeader, 256);
+    if (photoHeader_size == UNICODE_BUILTIN_INVALID) {
+        rp_data->error = RagePhoto::Error::UnicodeHeaderError; // 6
+        return false;
+    }
+    else if (photoHeader_size == UNICODE_BUILTIN_TIGHT) {
+        rp_data->error = RagePhoto::Error::HeaderBufferTight; // 35
+        return false;
+    }
+    memset(&photoHeader[photoHeader_size], 0, 256 - photoHeader_size);
+#endif
+    return true;
 }
+#endif
 
-void RagePhoto::clear()
+inline bool isStorageData(const RagePhotoData *rp_data, const char *data)
 {
-    clear(m_data);
+    if (!rp_data->storage || !data)
+        return false;
+    const uintptr_t storage = reinterpret_cast<uintptr_t>(rp_data->storage);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(data);
+    return (address >= storage && address < storage + static_cast<const RagePhotoStorage*>(rp_data->storage)->size);
 }
 
-RagePhotoData* RagePhoto::data()
+inline void detachStorageData(RagePhotoData *rp_data, char **data)
 {
-    return m_data;
+    if (isStorageData(rp_data, *data))
+        *data = nullptr;
 }
 
-bool RagePhoto::load(const char *data, size_t length, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+inline void retainStorage(void *storage)
 {
-#ifdef RAGEPHOTO_BENCHMARK
-    auto benchmark_parse_start = std::chrono::steady_clock::now();
-#endif
+    static_cast<RagePhotoStorage*>(storage)->refs.fetch_add(1, std::memory_order_relaxed);
+}
 
-    // Avoid data conflicts
-    clear(rp_data);
+/* Returns true when the last reference was released */
+inline bool releaseStorage(void *storage)
+{
+    return (static_cast<RagePhotoStorage*>(storage)->refs.fetch_sub(1, std::memory_order_acq_rel) == 1);
+}
 
-    size_t pos = 0;
-    size_t size = readBuffer(data, &rp_data->photoFormat, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-    rp_data->photoFormat = swapUInt32(rp_data->photoFormat);
-#endif
-    if (size != 4) {
-        rp_data->error = Error::NoFormatIdentifier; // 1
+inline bool isSharedStorage(void *storage)
+{
+    return (static_cast<RagePhotoStorage*>(storage)->refs.load(std::memory_order_acquire) > 1);
+}
+
+inline bool shareStorageData(const RagePhotoData *rp_data, const RagePhotoData *source, char *data, char **output)
+{
+    if (!rp_data->storage || rp_data->storage != source->storage || !isStorageData(source, data))
         return false;
-    }
+    *output = data;
+    return true;
+}
 
-    if (rp_data->photoFormat == PhotoFormat::GTA5 || rp_data->photoFormat == PhotoFormat::RDR2) {
-#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT
-        char photoHeader[256];
-        size = readBuffer(data, photoHeader, &pos, 256, length);
-        if (size != 256) {
-            rp_data->error = Error::IncompleteHeader; // 3
-            return false;
-        }
-
-#if defined UNICODE_CODECVT
-        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>,char16_t> convert;
-        const std::string photoHeader_string = convert.to_bytes(reinterpret_cast<char16_t*>(photoHeader));
-        if (convert.converted() == 0) {
-            rp_data->error = Error::UnicodeHeaderError; // 6
-            return false;
-        }
-        const size_t photoHeader_size = photoHeader_string.size() + 1;
-        rp_data->header = static_cast<char*>(malloc(photoHeader_size));
-        if (!rp_data->header) {
-            rp_data->error = Error::HeaderMallocError; // 4
-            return false;
-        }
-        memcpy(rp_data->header, photoHeader_string.data(), photoHeader_size);
-#elif defined UNICODE_ICONV
-        iconv_t iconv_in = iconv_open("UTF-8", "UTF-16LE");
-        if (iconv_in == (iconv_t)-1) {
-            rp_data->error = Error::UnicodeInitError; // 4
-            return false;
-        }
-        rp_data->header = static_cast<char*>(malloc(256));
-        if (!rp_data->header) {
-            rp_data->error = Error::HeaderMallocError; // 4
-            iconv_close(iconv_in);
-            return false;
-        }
-        size_t src_s = sizeof(photoHeader);
-        size_t dst_s = 256;
-        char *src = photoHeader;
-        char *dst = rp_data->header;
-        const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
-        iconv_close(iconv_in);
-        if (ret == static_cast<size_t>(-1)) {
-            rp_data->error = Error::UnicodeHeaderError; // 6
-            return false;
-        }
-#elif defined UNICODE_WINCVT
-        rp_data->header = static_cast<char*>(malloc(256));
-        if (!rp_data->header) {
-            rp_data->error = Error::HeaderMallocError; // 4
-            return false;
+inline void freeData(RagePhotoData *rp_data)
+{
+    if (!isStorageData(rp_data, rp_data->jpeg))
+        freeBuffer(rp_data, rp_data->jpeg);
+    if (!isStorageData(rp_data, rp_data->description))
+        freeBuffer(rp_data, rp_data->description);
+    if (!isStorageData(rp_data, rp_data->json))
+        freeBuffer(rp_data, rp_data->json);
+    if (!isStorageData(rp_data, rp_data->header))
+        freeBuffer(rp_data, rp_data->header);
+    if (!isStorageData(rp_data, rp_data->title))
+        freeBuffer(rp_data, rp_data->title);
+    freeBuffer(rp_data, rp_data->jpegRetained);
+    freeBuffer(rp_data, rp_data->descRetained);
+    freeBuffer(rp_data, rp_data->jsonRetained);
+    freeBuffer(rp_data, rp_data->headerRetained);
+    freeBuffer(rp_data, rp_data->titlRetained);
+    if (rp_data->storage && releaseStorage(rp_data->storage))
+        freeBuffer(rp_data, rp_data->storage);
+}
+
+/* Keeps the larger one of a section buffer and the buffer kept before, kept buffers are invisible to getters and save */
+inline void retainData(const RagePhotoData *rp_data, char *data, uint32_t capacity, char *retained, uint32_t retainedCapacity, char **output, uint32_t *outputCapacity)
+{
+    if (!isStorageData(rp_data, data)) {
+        if (data && capacity > retainedCapacity) {
+            freeBuffer(rp_data, retained);
+            retained = data;
+            retainedCapacity = capacity;
         }
-        const int converted = WideCharToMultiByte(CP_UTF8, 0, reinterpret_cast<wchar_t*>(photoHeader), -1, rp_data->header, 256, NULL, NULL);
-        if (converted == 0) {
-            free(rp_data->header);
-            rp_data->header = nullptr;
-            rp_data->error = Error::UnicodeHeaderError; // 6
-            return false;
-        }
-#endif
-
-        size = readBuffer(data, &rp_data->headerSum, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->headerSum = swapUInt32(rp_data->headerSum);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteChecksum; // 7
-            return false;
+        else {
+            freeBuffer(rp_data, data);
         }
+    }
+    *output = retained;
+    *outputCapacity = retainedCapacity;
+}
 
-        if (rp_data->photoFormat == PhotoFormat::RDR2) {
-            char formatCheckBuffer[4];
-            size = readBuffer(data, formatCheckBuffer, &pos, 4, length);
-            if (size != 4) {
-                rp_data->error = Error::IncompleteChecksum; // 7
-                return false;
-            }
-            char n_formatCheckBuffer[4]{};
-            if (memcmp(formatCheckBuffer, n_formatCheckBuffer, 4)) {
-                rp_data->error = Error::IncompatibleFormat; // 2
-                return false;
-            }
+/* Loads a view without computing the JPEG sign, defined with the RagePhoto View Class */
+inline bool loadView(const char *data, size_t length, RagePhotoView *rp_view);
 
-            size = readBuffer(data, &rp_data->headerSum2, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-            rp_data->headerSum2 = swapUInt32(rp_data->headerSum2);
-#endif
-            if (size != 4) {
-                rp_data->error = Error::IncompleteChecksum; // 7
-                return false;
-            }
-        }
+inline bool loadStorage(const char *data, size_t length, RagePhotoData *rp_data, bool loadJpeg)
+{
+    RagePhotoView rp_view;
+    if (!loadView(data, length, &rp_view))
+        return false;
+    // Sections exceeding the size limits are rejected by loadData with the matching error
+    if ((loadJpeg && rp_view.jpegSize > sizelimits.jpegSize) || rp_view.jsonBuffer > sizelimits.jsonBuffer ||
+            rp_view.titlBuffer > sizelimits.titlBuffer || rp_view.descBuffer > sizelimits.descBuffer)
+        return false;
+    char photoHeader[512];
+    if (!decodeHeader(rp_view.header, photoHeader, sizeof(photoHeader)))
+        return false;
 
-        size = readBuffer(data, &rp_data->endOfFile, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->endOfFile = swapUInt32(rp_data->endOfFile);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteEOF; // 8
+    const size_t headerSize = strlen(photoHeader) + 1;
+    const size_t jpegSize = loadJpeg ? rp_view.jpegSize : 0;
+    const size_t storageSize = RAGEPHOTO_STORAGE_OFFSET + RAGEPHOTO_ALIGN_SIZE(jpegSize) + RAGEPHOTO_ALIGN_SIZE(rp_view.jsonBuffer) +
+            RAGEPHOTO_ALIGN_SIZE(rp_view.titlBuffer) + RAGEPHOTO_ALIGN_SIZE(rp_view.descBuffer) + headerSize;
+    char *storage = static_cast<char*>(rp_data->storage);
+    if ((libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY) && storage && reinterpret_cast<RagePhotoStorage*>(storage)->size >= storageSize && !isSharedStorage(storage)) {
+        // Keep the storage, section buffers outside of it are released
+        RagePhoto::reset(rp_data);
+        rp_data->storage = nullptr;
+        RagePhoto::clear(rp_data);
+    }
+    else {
+        storage = static_cast<char*>(allocBuffer(rp_data, storageSize));
+        if (!storage)
             return false;
-        }
+        RagePhoto::clear(rp_data);
+        RagePhotoStorage *rp_storage = new (storage) RagePhotoStorage;
+        rp_storage->size = storageSize;
+        rp_storage->refs.store(1, std::memory_order_relaxed);
+    }
+    rp_data->storage = storage;
 
-        size = readBuffer(data, &rp_data->jsonOffset, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jsonOffset = swapUInt32(rp_data->jsonOffset);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteJsonOffset; // 9
-            return false;
+    char *section = storage + RAGEPHOTO_STORAGE_OFFSET;
+    if (loadJpeg) {
+        rp_data->jpeg = section;
+        if (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN) {
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFinish(joaatCopy(signInitial(rp_view.photoFormat), section, rp_view.jpeg, jpegSize)));
+            rp_data->signFormat = rp_view.photoFormat;
         }
-        size = readBuffer(data, &rp_data->titlOffset, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->titlOffset = swapUInt32(rp_data->titlOffset);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteTitleOffset; // 10
-            return false;
+        else {
+            memcpy(section, rp_view.jpeg, jpegSize);
         }
+        section += RAGEPHOTO_ALIGN_SIZE(jpegSize);
+    }
+    rp_data->json = section;
+    memcpy(section, rp_view.json, rp_view.jsonBuffer);
+    section += RAGEPHOTO_ALIGN_SIZE(rp_view.jsonBuffer);
+    rp_data->title = section;
+    memcpy(section, rp_view.title, rp_view.titlBuffer);
+    section += RAGEPHOTO_ALIGN_SIZE(rp_view.titlBuffer);
+    rp_data->description = section;
+    memcpy(section, rp_view.description, rp_view.descBuffer);
+    section += RAGEPHOTO_ALIGN_SIZE(rp_view.descBuffer);
+    rp_data->header = section;
+    memcpy(section, photoHeader, headerSize);
+
+    rp_data->descBuffer = rp_view.descBuffer;
+    rp_data->descOffset = rp_view.descOffset;
+    rp_data->endOfFile = rp_view.endOfFile;
+    rp_data->headerSum = rp_view.headerSum;
+    rp_data->headerSum2 = rp_view.headerSum2;
+    rp_data->jpegBuffer = rp_view.jpegBuffer;
+    rp_data->jpegSize = rp_view.jpegSize;
+    rp_data->jsonBuffer = rp_view.jsonBuffer;
+    rp_data->jsonOffset = rp_view.jsonOffset;
+    rp_data->photoFormat = rp_view.photoFormat;
+    rp_data->titlBuffer = rp_view.titlBuffer;
+    rp_data->titlOffset = rp_view.titlOffset;
+    rp_data->error = RagePhoto::Error::NoError; // 255
+    return true;
+}
 
-        size = readBuffer(data, &rp_data->descOffset, &pos, 4, length);
+inline uint32_t parserUInt32(const char *input)
+{
+    uint32_t value;
+    memcpy(&value, input, 4);
 #ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->descOffset = swapUInt32(rp_data->descOffset);
+    value = swapUInt32(value);
 #endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteDescOffset; // 11
-            return false;
-        }
+    return value;
+}
 
-        char markerBuffer[4];
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = Error::IncompleteJpegMarker; // 12
-            return false;
-        }
-        if (memcmp(markerBuffer, "JPEG", 4)) {
-            rp_data->error = Error::IncorrectJpegMarker; // 13
-            return false;
-        }
+inline const RagePhotoLayout* photoLayout(uint32_t photoFormat)
+{
+    return (photoFormat == RagePhoto::PhotoFormat::RDR2) ? &rdr2Layout : &gta5Layout;
+}
 
-        size = readBuffer(data, &rp_data->jpegBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jpegBuffer = swapUInt32(rp_data->jpegBuffer);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompletePhotoBuffer; // 14
+inline bool loadLayout(const RagePhotoLayout *layout, const char *data, size_t length, uint32_t *fields, int32_t *error)
+{
+    // Length is checked once, a truncated Photo fails at its first incomplete entry
+    size_t count = layout->count;
+    *error = RagePhoto::Error::NoError; // 255
+    if (length < layout->size) {
+        for (count = 0; layout->entries[count].offset + 4 <= length; count++);
+        *error = layout->entries[count].error;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const RagePhotoLayoutEntry *entry = &layout->entries[i];
+        const uint32_t value = parserUInt32(&data[entry->offset]);
+        if (entry->field != LAYOUT_FIELD_CONSTANT)
+            fields[entry->field] = value;
+        else if (value != entry->value) {
+            *error = entry->checkError;
             return false;
         }
+    }
+    return (*error == RagePhoto::Error::NoError);
+}
 
-        size = readBuffer(data, &rp_data->jpegSize, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jpegSize = swapUInt32(rp_data->jpegSize);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompletePhotoSize; // 15
-            return false;
-        }
+inline void saveLayout(const RagePhotoLayout *layout, const uint32_t *fields, char *output)
+{
+    for (size_t i = 0; i < layout->count; i++) {
+        const RagePhotoLayoutEntry *entry = &layout->entries[i];
+        uInt32ToCharLE((entry->field != LAYOUT_FIELD_CONSTANT) ? fields[entry->field] : entry->value, &output[entry->offset]);
+    }
+}
 
-        rp_data->jpeg = static_cast<char*>(malloc(rp_data->jpegSize));
-        if (!rp_data->jpeg) {
-            rp_data->error = Error::PhotoMallocError; // 16
-            return false;
-        }
-        size = readBuffer(data, rp_data->jpeg, &pos, rp_data->jpegSize, length);
-        if (size != rp_data->jpegSize) {
-            free(rp_data->jpeg);
-            rp_data->jpeg = nullptr;
-            rp_data->error = Error::PhotoReadError; // 17
-            return false;
-        }
+inline void saveFields(const RagePhotoData *rp_data, uint32_t *fields)
+{
+    fields[LAYOUT_FIELD_HEADERSUM] = rp_data->headerSum;
+    fields[LAYOUT_FIELD_HEADERSUM2] = rp_data->headerSum2;
+    fields[LAYOUT_FIELD_JSONOFFSET] = rp_data->jpegBuffer + UINT32_C(28);
+    fields[LAYOUT_FIELD_TITLOFFSET] = fields[LAYOUT_FIELD_JSONOFFSET] + rp_data->jsonBuffer + UINT32_C(8);
+    fields[LAYOUT_FIELD_DESCOFFSET] = fields[LAYOUT_FIELD_TITLOFFSET] + rp_data->titlBuffer + UINT32_C(8);
+    fields[LAYOUT_FIELD_EOF] = fields[LAYOUT_FIELD_DESCOFFSET] + rp_data->descBuffer + UINT32_C(12);
+    fields[LAYOUT_FIELD_JPEGBUFFER] = rp_data->jpegBuffer;
+    fields[LAYOUT_FIELD_JPEGSIZE] = rp_data->jpegSize;
+}
 
-        pos += rp_data->jpegBuffer - rp_data->jpegSize;
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = Error::IncompleteJsonMarker; // 18
-            return false;
-        }
-        if (memcmp(markerBuffer, "JSON", 4)) {
-            rp_data->error = Error::IncorrectJsonMarker; // 19
-            return false;
-        }
+inline bool loadSectionHead(const char *data, size_t length, size_t *pos, uint32_t marker, int32_t error, uint32_t *buffer, int32_t *r_error)
+{
+    // Errors follow the incomplete marker error: incorrect marker, incomplete buffer
+    const size_t remaining = (*pos < length) ? length - *pos : 0;
+    if (remaining < 4) {
+        *r_error = error;
+        return false;
+    }
+    if (parserUInt32(&data[*pos]) != marker) {
+        *r_error = error + 1;
+        return false;
+    }
+    if (remaining < 8) {
+        *r_error = error + 2;
+        return false;
+    }
+    *buffer = parserUInt32(&data[*pos + 4]);
+    *pos += 8;
+    return true;
+}
 
-        size = readBuffer(data, &rp_data->jsonBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->jsonBuffer = swapUInt32(rp_data->jsonBuffer);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteJsonBuffer; // 20
-            return false;
-        }
+inline char* parserTarget(RagePhotoParser *rp_stream)
+{
+    switch (rp_stream->state) {
+    case PARSER_STATE_JPEG:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_JPEG) ? rp_stream->data->jpeg : nullptr;
+    case PARSER_STATE_JPEGPADDING:
+        return nullptr;
+    case PARSER_STATE_JSON:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_JSON) ? rp_stream->data->json : nullptr;
+    case PARSER_STATE_TITLE:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_TITLE) ? rp_stream->data->title : nullptr;
+    case PARSER_STATE_DESC:
+        return (rp_stream->sections & RAGEPHOTO_SECTION_DESC) ? rp_stream->data->description : nullptr;
+    default:
+        return rp_stream->buffer;
+    }
+}
 
-        rp_data->json = static_cast<char*>(malloc(rp_data->jsonBuffer));
-        if (!rp_data->json) {
-            rp_data->error = Error::JsonMallocError; // 21
-            return false;
-        }
-        size = readBuffer(data, rp_data->json, &pos, rp_data->jsonBuffer, length);
-        if (size != rp_data->jsonBuffer) {
-            free(rp_data->json);
-            rp_data->json = nullptr;
-            rp_data->error = Error::JsonReadError; // 22
-            return false;
-        }
+inline bool parserAllocate(RagePhotoData *rp_data, char **output, uint32_t *capacity, uint32_t size, uint32_t limit, bool required)
+{
+    if (!required)
+        return true;
+    if (size > limit)
+        return false;
+    return reserveData(rp_data, output, capacity, size);
+}
 
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = Error::IncompleteTitleMarker; // 23
+inline bool parserNext(RagePhotoParser *rp_stream)
+{
+    RagePhotoData *rp_data = rp_stream->data;
+    const uint8_t sections = rp_stream->sections;
+    const uint32_t value = parserUInt32(rp_stream->buffer);
+    uint8_t state = rp_stream->state + 1;
+    uint32_t fieldSize = 4;
+
+    switch (rp_stream->state) {
+    case PARSER_STATE_FORMAT:
+        rp_data->photoFormat = value;
+        if (rp_data->photoFormat != RagePhoto::PhotoFormat::GTA5 && rp_data->photoFormat != RagePhoto::PhotoFormat::RDR2) {
+            rp_data->error = RagePhoto::Error::IncompatibleFormat; // 2
             return false;
         }
-        if (memcmp(markerBuffer, "TITL", 4)) {
-            rp_data->error = Error::IncorrectTitleMarker; // 24
+#if !defined UNICODE_ICONV && !defined UNICODE_CODECVT && !defined UNICODE_WINCVT && !defined UNICODE_BUILTIN
+        std::cout << "UTF-16LE decoding support missing" << std::endl;
+        rp_data->error = RagePhoto::Error::UnicodeInitError; // 4
+        return false;
+#endif
+        fieldSize = 256;
+        break;
+    case PARSER_STATE_HEADER:
+#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT || defined UNICODE_BUILTIN
+        if (!loadHeader(rp_data, rp_stream->buffer))
             return false;
-        }
-
-        size = readBuffer(data, &rp_data->titlBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->titlBuffer = swapUInt32(rp_data->titlBuffer);
 #endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteTitleBuffer; // 25
+        break;
+    case PARSER_STATE_HEADERSUM:
+        rp_data->headerSum = value;
+        if (rp_data->photoFormat != RagePhoto::PhotoFormat::RDR2)
+            state = PARSER_STATE_EOF;
+        break;
+    case PARSER_STATE_FORMATCHECK:
+        if (value != 0) {
+            rp_data->error = RagePhoto::Error::IncompatibleFormat; // 2
             return false;
         }
-
-        rp_data->title = static_cast<char*>(malloc(rp_data->titlBuffer));
-        if (!rp_data->title) {
-            rp_data->error = Error::TitleMallocError; // 26
+        break;
+    case PARSER_STATE_HEADERSUM2:
+        rp_data->headerSum2 = value;
+        break;
+    case PARSER_STATE_EOF:
+        rp_data->endOfFile = value;
+        break;
+    case PARSER_STATE_JSONOFFSET:
+        rp_data->jsonOffset = value;
+        break;
+    case PARSER_STATE_TITLOFFSET:
+        rp_data->titlOffset = value;
+        break;
+    case PARSER_STATE_DESCOFFSET:
+        rp_data->descOffset = value;
+        rp_stream->completed |= RAGEPHOTO_SECTION_HEADER;
+        break;
+    case PARSER_STATE_JPEGMARKER:
+        if (memcmp(rp_stream->buffer, "JPEG", 4)) {
+            rp_data->error = RagePhoto::Error::IncorrectJpegMarker; // 13
             return false;
         }
-        size = readBuffer(data, rp_data->title, &pos, rp_data->titlBuffer, length);
-        if (size != rp_data->titlBuffer) {
-            free(rp_data->title);
-            rp_data->title = nullptr;
-            rp_data->error = Error::TitleReadError; // 27
+        break;
+    case PARSER_STATE_JPEGBUFFER:
+        rp_data->jpegBuffer = value;
+        break;
+    case PARSER_STATE_JPEGSIZE:
+        rp_data->jpegSize = value;
+        // The JPEG padding would underflow, load fails at the JSON marker for the same Photo
+        if (rp_data->jpegSize > rp_data->jpegBuffer) {
+            rp_data->error = RagePhoto::Error::IncompleteJsonMarker; // 18
             return false;
         }
-
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = Error::IncompleteDescMarker; // 28
+        if (!parserAllocate(rp_data, &rp_data->jpeg, &rp_data->jpegCapacity, rp_data->jpegSize, sizelimits.jpegSize, sections & RAGEPHOTO_SECTION_JPEG)) {
+            rp_data->error = RagePhoto::Error::PhotoMallocError; // 16
             return false;
         }
-        if (memcmp(markerBuffer, "DESC", 4)) {
-            rp_data->error = Error::IncorrectDescMarker; // 29
+        // The JOAAT state is kept in jpegSign until the JPEG is complete
+        if (rp_stream->signing)
+            rp_data->jpegSign = signInitial(rp_data->photoFormat);
+        fieldSize = rp_data->jpegSize;
+        break;
+    case PARSER_STATE_JPEG:
+        if (rp_stream->signing) {
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFinish(static_cast<uint32_t>(rp_data->jpegSign)));
+            rp_data->signFormat = rp_data->photoFormat;
+        }
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_JPEG);
+        fieldSize = rp_data->jpegBuffer - rp_data->jpegSize;
+        break;
+    case PARSER_STATE_JPEGPADDING:
+        break;
+    case PARSER_STATE_JSONMARKER:
+        if (memcmp(rp_stream->buffer, "JSON", 4)) {
+            rp_data->error = RagePhoto::Error::IncorrectJsonMarker; // 19
             return false;
         }
-
-        size = readBuffer(data, &rp_data->descBuffer, &pos, 4, length);
-#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
-        rp_data->descBuffer = swapUInt32(rp_data->descBuffer);
-#endif
-        if (size != 4) {
-            rp_data->error = Error::IncompleteDescBuffer; // 30
+        break;
+    case PARSER_STATE_JSONBUFFER:
+        rp_data->jsonBuffer = value;
+        if (!parserAllocate(rp_data, &rp_data->json, &rp_data->jsonCapacity, rp_data->jsonBuffer, sizelimits.jsonBuffer, sections & RAGEPHOTO_SECTION_JSON)) {
+            rp_data->error = RagePhoto::Error::JsonMallocError; // 21
             return false;
         }
-
-        rp_data->description = static_cast<char*>(malloc(rp_data->descBuffer));
-        if (!rp_data->description) {
-            rp_data->error = Error::DescMallocError; // 31
+        fieldSize = rp_data->jsonBuffer;
+        break;
+    case PARSER_STATE_JSON:
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_JSON);
+        break;
+    case PARSER_STATE_TITLMARKER:
+        if (memcmp(rp_stream->buffer, "TITL", 4)) {
+            rp_data->error = RagePhoto::Error::IncorrectTitleMarker; // 24
             return false;
         }
-        size = readBuffer(data, rp_data->description, &pos, rp_data->descBuffer, length);
-        if (size != rp_data->descBuffer) {
-            free(rp_data->description);
-            rp_data->description = nullptr;
-            rp_data->error = Error::DescReadError; // 32
+        break;
+    case PARSER_STATE_TITLBUFFER:
+        rp_data->titlBuffer = value;
+        if (!parserAllocate(rp_data, &rp_data->title, &rp_data->titlCapacity, rp_data->titlBuffer, sizelimits.titlBuffer, sections & RAGEPHOTO_SECTION_TITLE)) {
+            rp_data->error = RagePhoto::Error::TitleMallocError; // 26
             return false;
         }
-
-        size = readBuffer(data, markerBuffer, &pos, 4, length);
-        if (size != 4) {
-            rp_data->error = Error::IncompleteJendMarker; // 33
+        fieldSize = rp_data->titlBuffer;
+        break;
+    case PARSER_STATE_TITLE:
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_TITLE);
+        break;
+    case PARSER_STATE_DESCMARKER:
+        if (memcmp(rp_stream->buffer, "DESC", 4)) {
+            rp_data->error = RagePhoto::Error::IncorrectDescMarker; // 29
             return false;
         }
-        if (memcmp(markerBuffer, "JEND", 4)) {
-            rp_data->error = Error::IncorrectJendMarker; // 34
+        break;
+    case PARSER_STATE_DESCBUFFER:
+        rp_data->descBuffer = value;
+        if (!parserAllocate(rp_data, &rp_data->description, &rp_data->descCapacity, rp_data->descBuffer, sizelimits.descBuffer, sections & RAGEPHOTO_SECTION_DESC)) {
+            rp_data->error = RagePhoto::Error::DescMallocError; // 31
             return false;
         }
-
-#ifdef RAGEPHOTO_BENCHMARK
-        auto benchmark_parse_end = std::chrono::steady_clock::now();
-        auto benchmark_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(benchmark_parse_end - benchmark_parse_start);
-        std::cout << "Benchmark: " << benchmark_ns.count() << "ns" << std::endl;
-#endif
-
-#ifdef RAGEPHOTO_DEBUG
-        const uint32_t jsonOffset = rp_data->jpegBuffer + UINT32_C(28);
-        const uint32_t titlOffset = jsonOffset + rp_data->jsonBuffer + UINT32_C(8);
-        const uint32_t descOffset = titlOffset + rp_data->titlBuffer + UINT32_C(8);
-        const uint32_t endOfFile = descOffset + rp_data->descBuffer + UINT32_C(12);
-        std::cout << "header: " << rp_data->header << std::endl;
-        std::cout << "headerSum: " << rp_data->headerSum << std::endl;
-        std::cout << "headerSum2: " << rp_data->headerSum2 << std::endl;
-        std::cout << "photoBuffer: " << rp_data->jpegBuffer << std::endl;
-        std::cout << "descBuffer: " << rp_data->descBuffer << std::endl;
-        std::cout << "descOffset: " << rp_data->descOffset << " (" << descOffset << ")" << std::endl;
-        std::cout << "description: " << rp_data->description << std::endl;
-        std::cout << "jsonBuffer: " << rp_data->jsonBuffer << std::endl;
-        std::cout << "jsonOffset: " << rp_data->jsonOffset << " (" << jsonOffset << ")" << std::endl;
-        std::cout << "json: " << rp_data->json << std::endl;
-        std::cout << "sign: " << jpegSign(rp_data) << std::endl;
-        std::cout << "titlBuffer: " << rp_data->titlBuffer << std::endl;
-        std::cout << "titlOffset: " << rp_data->titlOffset << " (" << titlOffset << ")" << std::endl;
-        std::cout << "title: " << rp_data->title << std::endl;
-        std::cout << "eofOffset: " << rp_data->endOfFile << " (" << endOfFile << ")" << std::endl;
-        std::cout << "size: " << length << " (" << saveSize(rp_data, nullptr) << ")" << std::endl;
-#endif
-
-        rp_data->error = Error::NoError; // 255
-        return true;
-#else
-        std::cout << "UTF-16LE decoding support missing" << std::endl;
-        rp_data->error = Error::UnicodeInitError; // 4
-        return false;
-#endif
-    }
-    else if (rp_parser) {
-        RagePhotoFormatParser n_parser[1]{};
-        for (size_t i = 0; memcmp(&n_parser[0], &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
-            if (rp_data->photoFormat == rp_parser[i].photoFormat)
-                if (rp_parser[i].funcLoad)
-                    return (rp_parser[i].funcLoad)(rp_data, data, length);
+        fieldSize = rp_data->descBuffer;
+        break;
+    case PARSER_STATE_DESC:
+        break;
+    case PARSER_STATE_JENDMARKER:
+        if (memcmp(rp_stream->buffer, "JEND", 4)) {
+            rp_data->error = RagePhoto::Error::IncorrectJendMarker; // 34
+            return false;
         }
+        rp_stream->completed |= (sections & RAGEPHOTO_SECTION_DESC);
+        break;
     }
-    rp_data->error = Error::IncompatibleFormat; // 2
-    return false;
-}
 
-bool RagePhoto::load(const char *data, size_t size)
-{
-    return load(data, size, m_data, m_parser);
-}
-
-bool RagePhoto::load(const std::string &data)
-{
-    return load(data.data(), data.size(), m_data, m_parser);
+    rp_stream->state = state;
+    rp_stream->fieldPos = 0;
+    rp_stream->fieldSize = fieldSize;
+    if ((rp_stream->completed & sections) == sections || state == PARSER_STATE_FINISHED) {
+        rp_stream->state = PARSER_STATE_FINISHED;
+        rp_data->error = RagePhoto::Error::NoError; // 255
+    }
+    return true;
 }
-
-bool RagePhoto::loadFile(const char *filename)
+inline bool loadFileBuffer(RagePhoto *ragePhoto, const char *filename, std::string &buffer)
 {
+#ifdef RAGEPHOTO_MMAP
+    if (!(libraryflags & RAGEPHOTO_FLAG_DISABLE_MMAP)) {
+        size_t mapSize;
+        char *mapData = mapFile(filename, &mapSize);
+        if (mapData) {
+            const bool isLoaded = ragePhoto->load(mapData, mapSize);
+            munmap(mapData, mapSize);
+            return isLoaded;
+        }
+    }
+#endif
 #if defined(_WIN32) && (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
-    std::ifstream ifs(std::filesystem::u8path(filename), std::ios::in | std::ios::binary);
+    std::ifstream ifs(std::filesystem::u8path(filename), std::ios::in | std::ios::binary | std::ios::ate);
 #elif defined(_WIN32)
-    std::ifstream ifs(convertPath(filename).data(), std::ios::in | std::ios::binary);
+    std::ifstream ifs(convertPath(filename).data(), std::ios::in | std::ios::binary | std::ios::ate);
 #else
-    std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+    std::ifstream ifs(filename, std::ios::in | std::ios::binary | std::ios::ate);
 #endif
-    if (ifs.is_open()) {
-        std::string sdata(std::istreambuf_iterator<char>{ifs}, {});
-        ifs.close();
-        return load(sdata);
+    if (!ifs.is_open()) {
+        ragePhoto->data()->error = RagePhoto::Error::Uninitialised; // 0
+        return false;
     }
-    else {
-        m_data->error = Error::Uninitialised; // 0
+    const std::streamoff fileSize = ifs.tellg();
+    if (fileSize == -1 || static_cast<uint64_t>(fileSize) > SIZE_MAX || !ifs.seekg(0, std::ios::beg)) {
+        ragePhoto->data()->error = RagePhoto::Error::Uninitialised; // 0
+        return false;
+    }
+    // The buffer only grows, batch loads reuse it for every file of a worker
+    if (buffer.size() < static_cast<size_t>(fileSize))
+        buffer.resize(static_cast<size_t>(fileSize));
+    if (!ifs.read(&buffer[0], fileSize)) {
+        ragePhoto->data()->error = RagePhoto::Error::Uninitialised; // 0
         return false;
     }
+    ifs.close();
+    return ragePhoto->load(buffer.data(), static_cast<size_t>(fileSize));
 }
 
-int32_t RagePhoto::error() const
+/* Exceptions must not escape a worker thread, they fail the file and the batch carries on */
+template<typename Load>
+inline bool loadBatchPhoto(RagePhoto *ragePhoto, Load load)
 {
-    return m_data->error;
+    try {
+        return load();
+    }
+    catch (const std::bad_alloc&) {
+        ragePhoto->data()->error = RagePhoto::Error::PhotoMallocError; // 16
+    }
+    catch (const std::exception&) {
+        ragePhoto->data()->error = RagePhoto::Error::Uninitialised; // 0
+    }
+    return false;
 }
 
-uint32_t RagePhoto::format() const
+inline size_t nextBatchIndex(RagePhotoBatch *batch)
 {
-    return m_data->photoFormat;
+    const size_t index = batch->next++;
+    // Errors before the Photo is parsed are file access errors
+    if (index < batch->count)
+        batch->photos[index]->data()->error = RagePhoto::Error::Uninitialised; // 0
+    return index;
 }
 
-const std::string RagePhoto::jpeg() const
+#ifdef RAGEPHOTO_IO_URING
+inline bool prepareSlotUring(RagePhotoUringSlot *slot)
 {
-    if (m_data->jpeg)
-        return std::string(m_data->jpeg, m_data->jpegSize);
-    return std::string();
+    struct stat fileStat;
+    if (fstat(slot->fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode) || static_cast<uintmax_t>(fileStat.st_size) > SIZE_MAX)
+        return false;
+    slot->fileSize = static_cast<size_t>(fileStat.st_size);
+    slot->readPos = 0;
+    // The buffer only grows, the slot reuses it for every file
+    if (slot->buffer.size() < slot->fileSize) {
+        try {
+            slot->buffer.resize(slot->fileSize);
+        }
+        catch (const std::bad_alloc&) {
+            return false;
+        }
+    }
+    return true;
 }
 
-#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
-const std::string_view RagePhoto::jpeg_view() const
+inline bool readSlotUring(RagePhotoUring *ring, RagePhotoUringSlot *slot, uint64_t slotIndex)
 {
-    if (m_data->jpeg)
-        return std::string_view(m_data->jpeg, m_data->jpegSize);
-    return std::string_view();
+    struct io_uring_sqe *sqe = uringGetSqe(ring);
+    if (!sqe)
+        return false;
+    size_t length = slot->fileSize - slot->readPos;
+    if (length > RAGEPHOTO_URING_READSIZE)
+        length = RAGEPHOTO_URING_READSIZE;
+    uringPrepRead(sqe, slot->fd, &slot->buffer[slot->readPos], static_cast<uint32_t>(length), slot->readPos, slotIndex);
+    return true;
 }
-#endif
 
-const char* RagePhoto::jpegData() const
-{
-    if (m_data->jpeg)
-        return m_data->jpeg;
-    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+inline void finishSlotUring(RagePhotoBatch *batch, RagePhotoUringSlot *slot, bool isRead, std::string &fileBuffer, size_t *loaded)
+{
+    RagePhoto *ragePhoto = batch->photos[slot->index];
+    if (slot->fd != -1)
+        close(slot->fd);
+    // Failed and unsupported operations fall back to the blocking loader
+    const char *filename = batch->filenames[slot->index];
+    const bool isLoaded = loadBatchPhoto(ragePhoto, [&]() {
+        return isRead ?
+                   ragePhoto->load(slot->buffer.data(), slot->fileSize) :
+                   loadFileBuffer(ragePhoto, filename, fileBuffer);
+    });
+    if (isLoaded)
+        (*loaded)++;
+    slot->busy = false;
+}
+
+/* Collects the completions of requests the kernel already took, false when waiting for them fails */
+inline bool drainSlotsUring(RagePhotoUring *ring, RagePhotoUringSlot *slots, size_t inFlight)
+{
+    // Entries left in the submission queue were never taken by the kernel
+    size_t pending = inFlight - uringUnconsumed(ring);
+    while (pending) {
+        uint64_t slotIndex;
+        int32_t result;
+        while (pending && uringPopCqe(ring, &slotIndex, &result)) {
+            RagePhotoUringSlot *slot = &slots[slotIndex];
+            // A late open still returns a descriptor, it's closed with the slot
+            if (slot->fd == -1 && result >= 0)
+                slot->fd = result;
+            pending--;
+        }
+        if (pending && uringWait(ring, 1) == -1)
+            return false;
+    }
+    return true;
 }
 
-uint64_t RagePhoto::jpegSign(uint32_t photoFormat, RagePhotoData *rp_data)
+inline bool loadBatchUring(RagePhotoBatch *batch, size_t *loaded)
 {
-    if (rp_data->jpeg) {
-        if (photoFormat == PhotoFormat::GTA5)
-            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, SignInitials::SIGTA5));
-        else if (photoFormat == PhotoFormat::RDR2)
-            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, SignInitials::SIRDR2));
+    RagePhotoUring ring;
+    if (!uringInit(&ring, RAGEPHOTO_URING_DEPTH))
+        return false;
+    std::unique_ptr<RagePhotoUringSlot[]> slotStorage(new RagePhotoUringSlot[RAGEPHOTO_URING_DEPTH]);
+    RagePhotoUringSlot *slots = slotStorage.get();
+    size_t inFlight = 0;
+    bool failed = false;
+    bool drained = true;
+    bool queued = true;
+    for (;;) {
+        // Keep every slot busy with an open or read while files are left
+        for (size_t i = 0; queued && i < RAGEPHOTO_URING_DEPTH; i++) {
+            if (slots[i].busy)
+                continue;
+            const size_t index = nextBatchIndex(batch);
+            if (index >= batch->count) {
+                queued = false;
+                break;
+            }
+            slots[i].index = index;
+            slots[i].fd = -1;
+            slots[i].busy = true;
+            struct io_uring_sqe *sqe = uringGetSqe(&ring);
+            if (!sqe) {
+                finishSlotUring(batch, &slots[i], false, slots[i].buffer, loaded);
+                continue;
+            }
+            uringPrepOpen(sqe, batch->filenames[index], i);
+            inFlight++;
+        }
+        if (inFlight == 0)
+            break;
+        if (uringSubmitAndWait(&ring, 1) == -1) {
+            failed = true;
+            drained = drainSlotsUring(&ring, slots, inFlight);
+            break;
+        }
+        uint64_t slotIndex;
+        int32_t result;
+        while (uringPopCqe(&ring, &slotIndex, &result)) {
+            RagePhotoUringSlot *slot = &slots[slotIndex];
+            bool isRead = false;
+            if (slot->fd == -1) {
+                if (result >= 0) {
+                    slot->fd = result;
+                    if (prepareSlotUring(slot)) {
+                        if (slot->fileSize == 0)
+                            isRead = true;
+                        else if (readSlotUring(&ring, slot, slotIndex))
+                            continue;
+                    }
+                }
+            }
+            else if (result > 0) {
+                slot->readPos += static_cast<size_t>(result);
+                if (slot->readPos == slot->fileSize)
+                    isRead = true;
+                else if (readSlotUring(&ring, slot, slotIndex))
+                    continue;
+            }
+            else if ((result == -EINTR || result == -EAGAIN) && readSlotUring(&ring, slot, slotIndex)) {
+                continue;
+            }
+            finishSlotUring(batch, slot, isRead, slot->buffer, loaded);
+            inFlight--;
+        }
     }
-    return 0;
+    uringClose(&ring);
+    // The kernel may still complete reads into the buffers of busy slots, they are leaked instead of reused
+    if (!drained)
+        slotStorage.release();
+    std::string fileBuffer;
+    for (size_t i = 0; i < RAGEPHOTO_URING_DEPTH; i++) {
+        // Only reached with busy slots when the ring fails, load them blocking
+        if (slots[i].busy)
+            finishSlotUring(batch, &slots[i], false, drained ? slots[i].buffer : fileBuffer, loaded);
+    }
+    // Files never queued are left to the blocking loader of the caller
+    return !failed;
 }
+#endif
 
-uint64_t RagePhoto::jpegSign(RagePhotoData *rp_data)
+inline void loadBatchWorker(RagePhotoBatch *batch)
 {
-    return jpegSign(rp_data->photoFormat, rp_data);
-}
-
-uint64_t RagePhoto::jpegSign(uint32_t photoFormat) const
-{
-    return jpegSign(photoFormat, m_data);
+    size_t loaded = 0;
+#ifdef RAGEPHOTO_IO_URING
+    if (batch->metadata || (libraryflags & RAGEPHOTO_FLAG_DISABLE_IO_URING) || !loadBatchUring(batch, &loaded)) {
+#endif
+        std::string buffer;
+        size_t index;
+        while ((index = nextBatchIndex(batch)) < batch->count) {
+            RagePhoto *ragePhoto = batch->photos[index];
+            const char *filename = batch->filenames[index];
+            const bool isLoaded = loadBatchPhoto(ragePhoto, [&]() {
+                return batch->metadata ?
+                           ragePhoto->loadMetaFile(filename) :
+                           loadFileBuffer(ragePhoto, filename, buffer);
+            });
+            if (isLoaded)
+                loaded++;
+        }
+#ifdef RAGEPHOTO_IO_URING
+    }
+#endif
+    batch->loaded += loaded;
 }
 
-uint64_t RagePhoto::jpegSign() const
+inline size_t loadBatch(RagePhoto *const *photos, const char *const *filenames, size_t count, const RagePhotoBatchOptions &options)
 {
-    return jpegSign(m_data->photoFormat, m_data);
+#ifdef RAGEPHOTO_BENCHMARK
+    auto benchmark_batch_start = std::chrono::steady_clock::now();
+#endif
+
+    size_t threads = options.threads;
+#ifdef RAGEPHOTO_THREADS
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+#else
+    threads = 1;
+#endif
+    if (threads > count)
+        threads = count;
+
+    RagePhotoBatch batch(photos, filenames, count, options.metadata);
+#ifdef RAGEPHOTO_THREADS
+    // The calling thread is the first worker
+    std::vector<std::thread> workers;
+    if (threads > 1)
+        workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; i++) {
+        try {
+            workers.emplace_back(loadBatchWorker, &batch);
+        }
+        catch (const std::system_error&) {
+            break;
+        }
+    }
+    loadBatchWorker(&batch);
+    for (std::thread &workerThread : workers)
+        workerThread.join();
+#else
+    loadBatchWorker(&batch);
+#endif
+
+#ifdef RAGEPHOTO_BENCHMARK
+    auto benchmark_batch_end = std::chrono::steady_clock::now();
+    auto benchmark_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(benchmark_batch_end - benchmark_batch_start);
+    std::cout << "Batch Benchmark: " << benchmark_ns.count() << "ns (" << count << " files, " << threads << " threads)" << std::endl;
+#endif
+
+    return batch.loaded;
 }
 
-uint32_t RagePhoto::jpegSize() const
+inline size_t registrySlot(const RagePhotoRegistry *rp_registry, uint32_t photoFormat)
 {
-    if (m_data->jpeg)
-        return m_data->jpegSize;
-    return 0;
+    uint32_t hash = photoFormat;
+    hash ^= hash >> 16;
+    hash *= UINT32_C(0x7FEB352D);
+    hash ^= hash >> 15;
+    size_t slot = hash & rp_registry->mask;
+    while (rp_registry->slots[slot].used && rp_registry->slots[slot].parser.photoFormat != photoFormat)
+        slot = (slot + 1) & rp_registry->mask;
+    return slot;
 }
 
-const char* RagePhoto::description() const
+/* The parser is copied, the registry can be freed after the lookup */
+inline bool registeredParser(uint32_t photoFormat, RagePhotoFormatParser *rp_parser)
 {
-    if (m_data->description)
-        return m_data->description;
-    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+    bool found = false;
+    // Sequentially consistent, an update either sees a running lookup or the lookup sees the new registry
+    registryreaders.fetch_add(1, std::memory_order_seq_cst);
+    const RagePhotoRegistry *rp_registry = parserregistry.load(std::memory_order_seq_cst);
+    if (rp_registry) {
+        const size_t slot = registrySlot(rp_registry, photoFormat);
+        if (rp_registry->slots[slot].used) {
+            *rp_parser = rp_registry->slots[slot].parser;
+            found = true;
+        }
+    }
+    registryreaders.fetch_sub(1, std::memory_order_release);
+    return found;
 }
 
-const char* RagePhoto::header() const
+inline bool updateRegistry(uint32_t photoFormat, const RagePhotoFormatParser *rp_parser)
 {
-    if (m_data->header)
-        return m_data->header;
-    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+    std::lock_guard<std::mutex> lock(registrylock);
+    RagePhotoRegistry *o_registry = parserregistry.load(std::memory_order_relaxed);
+    const bool registered = o_registry && o_registry->slots[registrySlot(o_registry, photoFormat)].used;
+    if (!rp_parser && !registered)
+        return false;
+    const size_t count = (o_registry ? o_registry->count : 0) - (registered ? 1 : 0) + (rp_parser ? 1 : 0);
+    size_t capacity = 8;
+    while (capacity < count * 2)
+        capacity <<= 1;
+
+    // The table is rebuilt with at least half of the slots free, probing always ends on a free slot
+    RagePhotoRegistry *n_registry = new (std::nothrow) RagePhotoRegistry;
+    if (!n_registry)
+        return false;
+    try {
+        n_registry->slots.resize(capacity, RagePhotoRegistrySlot{});
+    }
+    catch (const std::bad_alloc&) {
+        delete n_registry;
+        return false;
+    }
+    n_registry->previous = o_registry;
+    n_registry->count = count;
+    n_registry->mask = capacity - 1;
+    if (o_registry) {
+        for (const RagePhotoRegistrySlot &slot : o_registry->slots) {
+            if (slot.used && slot.parser.photoFormat != photoFormat)
+                n_registry->slots[registrySlot(n_registry, slot.parser.photoFormat)] = slot;
+        }
+    }
+    if (rp_parser) {
+        RagePhotoRegistrySlot &slot = n_registry->slots[registrySlot(n_registry, photoFormat)];
+        slot.parser = *rp_parser;
+        slot.used = true;
+    }
+    parserregistry.store(n_registry, std::memory_order_seq_cst);
+    // Replaced registries are kept until no lookup can still read them
+    if (registryreaders.load(std::memory_order_seq_cst) == 0) {
+        RagePhotoRegistry *p_registry = n_registry->previous;
+        n_registry->previous = nullptr;
+        while (p_registry) {
+            RagePhotoRegistry *t_registry = p_registry->previous;
+            delete p_registry;
+            p_registry = t_registry;
+        }
+    }
+    return true;
 }
+/* END OF STATIC LIBRARY FUNCTIONS */
 
-const char* RagePhoto::json() const
+/* BEGIN OF RAGEPHOTO CLASS */
+RagePhoto::photo()
 {
-    if (m_data->json)
-        return m_data->json;
-    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+    m_data = static_cast<RagePhotoData*>(malloc(sizeof(RagePhotoData)));
+    if (!m_data)
+        throw std::runtime_error("RagePhotoData data struct can't be allocated");
+    memset(m_data, 0, sizeof(RagePhotoData));
+    // The parser array is allocated with the first custom parser
+    m_parser = nullptr;
+    setBufferDefault(m_data);
 }
 
-const char* RagePhoto::title() const
+RagePhoto::photo(RagePhoto &&ragePhoto) noexcept
 {
-    if (m_data->title)
-        return m_data->title;
-    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+    m_data = ragePhoto.m_data;
+    m_parser = ragePhoto.m_parser;
+    ragePhoto.m_data = nullptr;
+    ragePhoto.m_parser = nullptr;
 }
 
-const char* RagePhoto::version()
+RagePhoto::~photo()
 {
-    return RAGEPHOTO_VERSION;
+    // Moved-from objects own no data
+    if (m_data)
+        freeData(m_data);
+    free(m_data);
+    free(m_parser);
 }
 
-bool RagePhoto::save(char *data, uint32_t photoFormat, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+RagePhoto& RagePhoto::operator=(RagePhoto &&ragePhoto) noexcept
 {
-    if (photoFormat == PhotoFormat::GTA5 || photoFormat == PhotoFormat::RDR2) {
-        if (!rp_data->header) {
-            rp_data->error = Error::IncompleteHeader; // 3
-            return false;
-        }
-#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT
-#if defined UNICODE_CODECVT
-        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>,char16_t> convert;
-        std::u16string photoHeader_string = convert.from_bytes(rp_data->header);
-        if (convert.converted() == 0) {
-            rp_data->error = Error::UnicodeHeaderError; // 6
-            return false;
-        }
-        const size_t photoHeader_size = photoHeader_string.size() * sizeof(char16_t);
-        if (photoHeader_size > 256) {
-            rp_data->error = Error::HeaderBufferTight; // 35
-            return false;
-        }
-        const char *photoHeader = reinterpret_cast<const char*>(photoHeader_string.data());
-#elif defined UNICODE_ICONV
-        iconv_t iconv_in = iconv_open("UTF-16LE", "UTF-8");
-        if (iconv_in == (iconv_t)-1) {
-            rp_data->error = Error::UnicodeInitError; // 4
-            return false;
-        }
-        char photoHeader[256]{};
-        size_t src_s = strlen(rp_data->header);
-        size_t dst_s = sizeof(photoHeader);
-        char *src = rp_data->header;
-        char *dst = photoHeader;
-        const size_t ret = iconv(iconv_in, &src, &src_s, &dst, &dst_s);
-        iconv_close(iconv_in);
-        if (ret == static_cast<size_t>(-1)) {
-            rp_data->error = Error::UnicodeHeaderError; // 6
-            return false;
-        }
-        const size_t photoHeader_size = 256;
-#elif defined UNICODE_WINCVT
-        char photoHeader[256]{};
-        const int converted = MultiByteToWideChar(CP_UTF8, 0, rp_data->header, static_cast<int>(strlen(rp_data->header)), reinterpret_cast<wchar_t*>(photoHeader), 256 / sizeof(wchar_t));
-        if (converted == 0) {
-            rp_data->error = Error::UnicodeHeaderError; // 6
-            return false;
-        }
-        const size_t photoHeader_size = 256;
-#endif
+    swap(ragePhoto);
+    return *this;
+}
 
-        const size_t length = saveSize(photoFormat, rp_data, nullptr);
-        size_t pos = 0;
+void RagePhoto::addParser(RagePhotoFormatParser *rp_parser)
+{
+    if (rp_parser) {
+        RagePhotoFormatParser n_parser[1]{};
+        if (!memcmp(&n_parser[0], rp_parser, sizeof(RagePhotoFormatParser)))
+            return;
+        size_t length = 0;
+        if (m_parser)
+            for (; memcmp(&n_parser[0], &m_parser[length], sizeof(RagePhotoFormatParser)); length++);
+        RagePhotoFormatParser *t_parser = static_cast<RagePhotoFormatParser*>(realloc(m_parser, (length + 2) * sizeof(RagePhotoFormatParser)));
+        if (!t_parser)
+            throw std::runtime_error("RagePhotoFormatParser array can't be expanded");
+        m_parser = t_parser;
+        memcpy(&m_parser[length], rp_parser, sizeof(RagePhotoFormatParser));
+        memset(&m_parser[length + 1], 0, sizeof(RagePhotoFormatParser));
+    }
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&photoFormat, data, &pos, length, 4);
-#else
-        char uInt32Buffer[4];
-        uInt32ToCharLE(photoFormat, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+bool RagePhoto::adoptData(RagePhotoData *rp_data)
+{
+    if (!rp_data)
+        return false;
+    return setData(rp_data, false);
+}
 
-        writeBuffer(photoHeader, data, &pos, length, photoHeader_size);
-        zeroBuffer(data, &pos, length, 256 - photoHeader_size);
+bool RagePhoto::registerParser(const RagePhotoFormatParser *rp_parser)
+{
+    if (!rp_parser || (!rp_parser->funcLoad && !rp_parser->funcSave && !rp_parser->funcSavep && !rp_parser->funcSaveSz))
+        return false;
+    return updateRegistry(rp_parser->photoFormat, rp_parser);
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->headerSum, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->headerSum, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+bool RagePhoto::unregisterParser(uint32_t photoFormat)
+{
+    return updateRegistry(photoFormat, nullptr);
+}
 
-        if (photoFormat == PhotoFormat::RDR2) {
-            zeroBuffer(data, &pos, length, 4);
+void RagePhoto::clear(RagePhotoData *rp_data)
+{
+    const RagePhotoAllocator *rp_allocator = rp_data->allocator;
+    freeData(rp_data);
+    memset(rp_data, 0, sizeof(RagePhotoData));
+    rp_data->allocator = rp_allocator;
+    setBufferDefault(rp_data);
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-            writeBuffer(&rp_data->headerSum2, data, &pos, length, 4);
-#else
-            uInt32ToCharLE(rp_data->headerSum2, uInt32Buffer);
-            writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-        }
+void RagePhoto::clear()
+{
+    clear(m_data);
+}
 
-        const uint32_t jsonOffset = rp_data->jpegBuffer + UINT32_C(28);
-        const uint32_t titlOffset = jsonOffset + rp_data->jsonBuffer + UINT32_C(8);
-        const uint32_t descOffset = titlOffset + rp_data->titlBuffer + UINT32_C(8);
-        const uint32_t endOfFile = descOffset + rp_data->descBuffer + UINT32_C(12);
+void RagePhoto::reset(RagePhotoData *rp_data)
+{
+    RagePhotoData n_data{};
+    retainData(rp_data, rp_data->jpeg, rp_data->jpegCapacity, rp_data->jpegRetained, rp_data->jpegRetainedCapacity, &n_data.jpegRetained, &n_data.jpegRetainedCapacity);
+    retainData(rp_data, rp_data->description, rp_data->descCapacity, rp_data->descRetained, rp_data->descRetainedCapacity, &n_data.descRetained, &n_data.descRetainedCapacity);
+    retainData(rp_data, rp_data->json, rp_data->jsonCapacity, rp_data->jsonRetained, rp_data->jsonRetainedCapacity, &n_data.jsonRetained, &n_data.jsonRetainedCapacity);
+    retainData(rp_data, rp_data->header, rp_data->headerCapacity, rp_data->headerRetained, rp_data->headerRetainedCapacity, &n_data.headerRetained, &n_data.headerRetainedCapacity);
+    retainData(rp_data, rp_data->title, rp_data->titlCapacity, rp_data->titlRetained, rp_data->titlRetainedCapacity, &n_data.titlRetained, &n_data.titlRetainedCapacity);
+    // Shared storage can't be reused, it stays with the other RagePhotoData objects
+    if (rp_data->storage && isSharedStorage(rp_data->storage)) {
+        if (releaseStorage(rp_data->storage))
+            freeBuffer(rp_data, rp_data->storage);
+    }
+    else {
+        n_data.storage = rp_data->storage;
+    }
+    n_data.allocator = rp_data->allocator;
+    memcpy(rp_data, &n_data, sizeof(RagePhotoData));
+    setBufferDefault(rp_data);
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&endOfFile, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(endOfFile, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+void RagePhoto::reset()
+{
+    reset(m_data);
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&jsonOffset, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(jsonOffset, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+RagePhoto* RagePhoto::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(poollock);
+        if (instancepoolsize != 0)
+            return instancepool[--instancepoolsize];
+    }
+    return new RagePhoto;
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&titlOffset, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(titlOffset, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+void RagePhoto::release(RagePhoto *ragePhoto)
+{
+    // A custom allocator may not outlive the current owner, the object isn't handed to the next one
+    if (ragePhoto->m_data->allocator) {
+        delete ragePhoto;
+        return;
+    }
+    reset(ragePhoto->m_data);
+    free(ragePhoto->m_parser);
+    ragePhoto->m_parser = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(poollock);
+        if (instancepoolsize != sizeof(instancepool) / sizeof(RagePhoto*)) {
+            instancepool[instancepoolsize++] = ragePhoto;
+            return;
+        }
+    }
+    delete ragePhoto;
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&descOffset, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(descOffset, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+RagePhotoData* RagePhoto::data()
+{
+    return m_data;
+}
 
-        writeBuffer("JPEG", data, &pos, length, 4);
+RagePhotoData* RagePhoto::releaseData()
+{
+    RagePhotoData *n_data = static_cast<RagePhotoData*>(malloc(sizeof(RagePhotoData)));
+    if (!n_data)
+        return nullptr;
+    memset(n_data, 0, sizeof(RagePhotoData));
+    n_data->allocator = m_data->allocator;
+    setBufferDefault(n_data);
+    RagePhotoData *rp_data = m_data;
+    m_data = n_data;
+    return rp_data;
+}
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->jpegBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->jpegBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
+bool RagePhoto::loadData(const char *data, size_t length, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, bool loadJpeg)
+{
+#ifdef RAGEPHOTO_BENCHMARK
+    auto benchmark_parse_start = std::chrono::steady_clock::now();
 #endif
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->jpegSize, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->jpegSize, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
+    // Avoid data conflicts
+    if (libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY)
+        reset(rp_data);
+    else
+        clear(rp_data);
+
+    size_t pos = 0;
+    size_t size = readBuffer(data, &rp_data->photoFormat, &pos, 4, length);
+#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
+    rp_data->photoFormat = swapUInt32(rp_data->photoFormat);
 #endif
+    if (size != 4) {
+        rp_data->error = Error::NoFormatIdentifier; // 1
+        return false;
+    }
 
-        if (rp_data->jpeg) {
-            if (rp_data->jpegSize > rp_data->jpegBuffer) {
-                rp_data->error = Error::PhotoBufferTight; // 36
-                return false;
-            }
-            writeBuffer(rp_data->jpeg, data, &pos, length, rp_data->jpegSize);
-            zeroBuffer(data, &pos, length, rp_data->jpegBuffer - rp_data->jpegSize);
-        }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->jpegBuffer);
+    if (rp_data->photoFormat == PhotoFormat::GTA5 || rp_data->photoFormat == PhotoFormat::RDR2) {
+#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT || defined UNICODE_BUILTIN
+        if (length < 260) {
+            rp_data->error = Error::IncompleteHeader; // 3
+            return false;
         }
+        char photoHeader[256];
+        memcpy(photoHeader, &data[4], 256);
 
-        writeBuffer("JSON", data, &pos, length, 4);
+        if (!loadHeader(rp_data, photoHeader))
+            return false;
 
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->jsonBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->jsonBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
+        const RagePhotoLayout *layout = photoLayout(rp_data->photoFormat);
+        // Fields the Photo ends before keep their default values
+        uint32_t fields[LAYOUT_FIELD_CONSTANT] = {rp_data->headerSum, rp_data->headerSum2, rp_data->endOfFile, rp_data->jsonOffset,
+                                                  rp_data->titlOffset, rp_data->descOffset, rp_data->jpegBuffer, rp_data->jpegSize};
+        const bool isLayoutLoaded = loadLayout(layout, data, length, fields, &rp_data->error);
+        rp_data->headerSum = fields[LAYOUT_FIELD_HEADERSUM];
+        rp_data->headerSum2 = fields[LAYOUT_FIELD_HEADERSUM2];
+        rp_data->endOfFile = fields[LAYOUT_FIELD_EOF];
+        rp_data->jsonOffset = fields[LAYOUT_FIELD_JSONOFFSET];
+        rp_data->titlOffset = fields[LAYOUT_FIELD_TITLOFFSET];
+        rp_data->descOffset = fields[LAYOUT_FIELD_DESCOFFSET];
+        rp_data->jpegBuffer = fields[LAYOUT_FIELD_JPEGBUFFER];
+        rp_data->jpegSize = fields[LAYOUT_FIELD_JPEGSIZE];
+        if (!isLayoutLoaded)
+            return false;
+        pos = layout->size;
 
-        if (rp_data->json) {
-            const size_t jsonString_size = strlen(rp_data->json) + 1;
-            if (jsonString_size > rp_data->jsonBuffer) {
-                rp_data->error = Error::JsonBufferTight; // 37
+        if (loadJpeg) {
+            // Check the size limit and remaining input before allocating
+            if (rp_data->jpegSize > sizelimits.jpegSize) {
+                rp_data->error = Error::PhotoMallocError; // 16
                 return false;
             }
-            writeBuffer(rp_data->json, data, &pos, length, jsonString_size);
-            zeroBuffer(data, &pos, length, rp_data->jsonBuffer - jsonString_size);
-        }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->jsonBuffer);
-        }
-
-        writeBuffer("TITL", data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->titlBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->titlBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        if (rp_data->title) {
-            const size_t titlString_size = strlen(rp_data->title) + 1;
-            if (titlString_size > rp_data->titlBuffer) {
-                rp_data->error = Error::TitleBufferTight; // 38
+            if (length - pos < rp_data->jpegSize) {
+                rp_data->error = Error::PhotoReadError; // 17
+                return false;
+            }
+            if (!reserveData(rp_data, &rp_data->jpeg, &rp_data->jpegCapacity, rp_data->jpegSize)) {
+                rp_data->error = Error::PhotoMallocError; // 16
                 return false;
             }
-            writeBuffer(rp_data->title, data, &pos, length, titlString_size);
-            zeroBuffer(data, &pos, length, rp_data->titlBuffer - titlString_size);
+            memcpy(rp_data->jpeg, &data[pos], rp_data->jpegSize);
+            if (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN)
+                RagePhoto::jpegSign(rp_data->photoFormat, rp_data);
         }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->titlBuffer);
+        else if (length - pos < rp_data->jpegSize) {
+            rp_data->error = Error::PhotoReadError; // 17
+            return false;
         }
+        pos += rp_data->jpegSize;
 
-        writeBuffer("DESC", data, &pos, length, 4);
-
-#ifdef LIBRAGEPHOTO_LITTLE_ENDIAN
-        writeBuffer(&rp_data->descBuffer, data, &pos, length, 4);
-#else
-        uInt32ToCharLE(rp_data->descBuffer, uInt32Buffer);
-        writeBuffer(uInt32Buffer, data, &pos, length, 4);
-#endif
-
-        if (rp_data->description) {
-            const size_t descString_size = strlen(rp_data->description) + 1;
-            if (descString_size > rp_data->descBuffer) {
-                rp_data->error = Error::DescBufferTight; // 39
+        pos += rp_data->jpegBuffer - rp_data->jpegSize;
+        const RagePhotoSectionEntry sections[3] = {
+            {&rp_data->json, &rp_data->jsonBuffer, &rp_data->jsonCapacity, sizelimits.jsonBuffer, RAGEPHOTO_MARKER_JSON, Error::IncompleteJsonMarker}, // 18
+            {&rp_data->title, &rp_data->titlBuffer, &rp_data->titlCapacity, sizelimits.titlBuffer, RAGEPHOTO_MARKER_TITL, Error::IncompleteTitleMarker}, // 23
+            {&rp_data->description, &rp_data->descBuffer, &rp_data->descCapacity, sizelimits.descBuffer, RAGEPHOTO_MARKER_DESC, Error::IncompleteDescMarker} // 28
+        };
+        for (size_t i = 0; i < 3; i++) {
+            const RagePhotoSectionEntry *section = &sections[i];
+            if (!loadSectionHead(data, length, &pos, section->marker, section->error, section->buffer, &rp_data->error))
+                return false;
+            const uint32_t buffer = *section->buffer;
+            // Malloc and read errors follow the incomplete buffer error
+            if (buffer > section->limit) {
+                rp_data->error = section->error + 3;
                 return false;
             }
-            writeBuffer(rp_data->description, data, &pos, length, descString_size);
-            zeroBuffer(data, &pos, length, rp_data->descBuffer - descString_size);
-        }
-        else {
-            zeroBuffer(data, &pos, length, rp_data->descBuffer);
+            if (length - pos < buffer) {
+                rp_data->error = section->error + 4;
+                return false;
+            }
+            if (!reserveData(rp_data, section->data, section->capacity, buffer)) {
+                rp_data->error = section->error + 3;
+                return false;
+            }
+            memcpy(*section->data, &data[pos], buffer);
+            pos += buffer;
         }
 
-        writeBuffer("JEND", data, &pos, length, 4);
-
-        rp_data->error = Error::NoError; // 255
-        return true;
-#else
-        std::cout << "UTF-16LE encoding support missing" << std::endl;
-        rp_data->error = Error::UnicodeInitError; // 4
-        return false;
-#endif
-    }
-    else if (photoFormat == PhotoFormat::JPEG) {
-        if (rp_data->jpeg) {
-            size_t pos = 0;
-            writeBuffer(rp_data->jpeg, data, &pos, rp_data->jpegSize, rp_data->jpegSize);
+        if (pos > length || length - pos < 4) {
+            rp_data->error = Error::IncompleteJendMarker; // 33
+            return false;
         }
-        else {
-            rp_data->error = Error::PhotoReadError; // 17
+        if (parserUInt32(&data[pos]) != RAGEPHOTO_MARKER_JEND) {
+            rp_data->error = Error::IncorrectJendMarker; // 34
             return false;
         }
 
-        rp_data->error = Error::NoError; // 255
-        return true;
-    }
-    else if (rp_parser) {
-        RagePhotoFormatParser n_parser[1]{};
-        for (size_t i = 0; memcmp(&n_parser[0], &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
-            if (photoFormat == rp_parser[i].photoFormat)
-                if (rp_parser[i].funcSave)
-                    return (rp_parser[i].funcSave)(rp_data, data, photoFormat);
-        }
-    }
+#ifdef RAGEPHOTO_BENCHMARK
+        auto benchmark_parse_end = std::chrono::steady_clock::now();
+        auto benchmark_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(benchmark_parse_end - benchmark_parse_start);
+        std::cout << "Benchmark: " << benchmark_ns.count() << "ns" << std::endl;
+#endif
+
+#ifdef RAGEPHOTO_DEBUG
+        const uint32_t jsonOffset = rp_data->jpegBuffer + UINT32_C(28);
+        const uint32_t titlOffset = jsonOffset + rp_data->jsonBuffer + UINT32_C(8);
+        const uint32_t descOffset = titlOffset + rp_data->titlBuffer + UINT32_C(8);
+        const uint32_t endOfFile = descOffset + rp_data->descBuffer + UINT32_C(12);
+        std::cout << "header: " << rp_data->header << std::endl;
+        std::cout << "headerSum: " << rp_data->headerSum << std::endl;
+        std::cout << "headerSum2: " << rp_data->headerSum2 << std::endl;
+        std::cout << "photoBuffer: " << rp_data->jpegBuffer << std::endl;
+        std::cout << "descBuffer: " << rp_data->descBuffer << std::endl;
+        std::cout << "descOffset: " << rp_data->descOffset << " (" << descOffset << ")" << std::endl;
+        std::cout << "description: " << rp_data->description << std::endl;
+        std::cout << "jsonBuffer: " << rp_data->jsonBuffer << std::endl;
+        std::cout << "jsonOffset: " << rp_data->jsonOffset << " (" << jsonOffset << ")" << std::endl;
+        std::cout << "json: " << rp_data->json << std::endl;
+        std::cout << "sign: " << jpegSign(rp_data) << std::endl;
+        std::cout << "titlBuffer: " << rp_data->titlBuffer << std::endl;
+        std::cout << "titlOffset: " << rp_data->titlOffset << " (" << titlOffset << ")" << std::endl;
+        std::cout << "title: " << rp_data->title << std::endl;
+        std::cout << "eofOffset: " << rp_data->endOfFile << " (" << endOfFile << ")" << std::endl;
+        std::cout << "size: " << length << " (" << saveSize(rp_data, nullptr) << ")" << std::endl;
+#endif
+
+        rp_data->error = Error::NoError; // 255
+        return true;
+#else
+        std::cout << "UTF-16LE decoding support missing" << std::endl;
+        rp_data->error = Error::UnicodeInitError; // 4
+        return false;
+#endif
+    }
+    else {
+        if (libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY) {
+            // Custom parsers expect cleared data
+            const uint32_t photoFormat = rp_data->photoFormat;
+            clear(rp_data);
+            rp_data->photoFormat = photoFormat;
+        }
+        if (rp_parser) {
+            RagePhotoFormatParser n_parser[1]{};
+            for (size_t i = 0; memcmp(&n_parser[0], &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
+                if (rp_data->photoFormat == rp_parser[i].photoFormat)
+                    if (rp_parser[i].funcLoad)
+                        return (rp_parser[i].funcLoad)(rp_data, data, length);
+            }
+        }
+        RagePhotoFormatParser r_parser;
+        if (registeredParser(rp_data->photoFormat, &r_parser) && r_parser.funcLoad)
+            return (r_parser.funcLoad)(rp_data, data, length);
+    }
+    rp_data->error = Error::IncompatibleFormat; // 2
+    return false;
+}
+
+bool RagePhoto::load(const char *data, size_t length, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+{
+    if ((libraryflags & RAGEPHOTO_FLAG_ARENA_STORAGE) && loadStorage(data, length, rp_data, true))
+        return true;
+    return loadData(data, length, rp_data, rp_parser, true);
+}
+
+bool RagePhoto::load(const char *data, size_t size)
+{
+    return load(data, size, m_data, m_parser);
+}
+
+bool RagePhoto::load(const std::string &data)
+{
+    return load(data.data(), data.size(), m_data, m_parser);
+}
+
+bool RagePhoto::loadFile(const char *filename)
+{
+    std::string buffer;
+    return loadFileBuffer(this, filename, buffer);
+}
+
+bool RagePhoto::loadMeta(const char *data, size_t length, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+{
+    if ((libraryflags & RAGEPHOTO_FLAG_ARENA_STORAGE) && loadStorage(data, length, rp_data, false))
+        return true;
+    return loadData(data, length, rp_data, rp_parser, false);
+}
+
+bool RagePhoto::loadMeta(const char *data, size_t size)
+{
+    return loadMeta(data, size, m_data, m_parser);
+}
+
+bool RagePhoto::loadMeta(const std::string &data)
+{
+    return loadMeta(data.data(), data.size(), m_data, m_parser);
+}
+
+bool RagePhoto::loadMetaFile(const char *filename)
+{
+#if defined(_WIN32) && (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+    const int fd = _wopen(std::filesystem::u8path(filename).c_str(), _O_RDONLY | _O_BINARY);
+#elif defined(_WIN32)
+    const int fd = _wopen(convertPath(filename).c_str(), _O_RDONLY | _O_BINARY);
+#elif defined(RAGEPHOTO_PREAD)
+    const int fd = open(filename, O_RDONLY);
+#endif
+#if defined(_WIN32) || defined(RAGEPHOTO_PREAD)
+    if (fd == -1) {
+        m_data->error = Error::Uninitialised; // 0
+        return false;
+    }
+    const bool isLoaded = loadMetaFd(fd);
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+    return isLoaded;
+#else
+    // Without positioned reads the whole Photo is loaded
+    return loadFile(filename);
+#endif
+}
+
+bool RagePhoto::loadMetaFd(int fd)
+{
+#if defined(_WIN32) || defined(RAGEPHOTO_PREAD)
+    const int64_t fileSize = fileSizeFd(fd);
+    if (fileSize == -1 || static_cast<uint64_t>(fileSize) > SIZE_MAX) {
+        m_data->error = Error::Uninitialised; // 0
+        return false;
+    }
+
+    char photoHead[RDR2_HEADERSIZE + 28];
+    const size_t headSize = (static_cast<uint64_t>(fileSize) < sizeof(photoHead)) ? static_cast<size_t>(fileSize) : sizeof(photoHead);
+    if (!readFileAt(fd, photoHead, headSize, 0)) {
+        m_data->error = Error::Uninitialised; // 0
+        return false;
+    }
+    uint32_t photoFormat = 0;
+    if (headSize >= 4) {
+        memcpy(&photoFormat, photoHead, 4);
+#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
+        photoFormat = swapUInt32(photoFormat);
+#endif
+    }
+
+    if (photoFormat != PhotoFormat::GTA5 && photoFormat != PhotoFormat::RDR2) {
+        // Other formats have no known layout, fallback to reading the whole file
+        std::string sdata(static_cast<size_t>(fileSize), '\0');
+        if (!readFileAt(fd, &sdata[0], sdata.size(), 0)) {
+            m_data->error = Error::Uninitialised; // 0
+            return false;
+        }
+        return loadMeta(sdata);
+    }
+
+    const size_t jpegStart = (photoFormat == PhotoFormat::GTA5 ? GTA5_HEADERSIZE : RDR2_HEADERSIZE) + 28;
+    if (headSize < jpegStart)
+        return loadMeta(photoHead, headSize);
+
+    uint32_t endOfFile, jpegBuffer, jpegSize;
+    memcpy(&endOfFile, &photoHead[jpegStart - 28], 4);
+    memcpy(&jpegBuffer, &photoHead[jpegStart - 8], 4);
+    memcpy(&jpegSize, &photoHead[jpegStart - 4], 4);
+#ifndef LIBRAGEPHOTO_LITTLE_ENDIAN
+    endOfFile = swapUInt32(endOfFile);
+    jpegBuffer = swapUInt32(jpegBuffer);
+    jpegSize = swapUInt32(jpegSize);
+#endif
+    if (static_cast<uint64_t>(fileSize) - jpegStart < jpegSize)
+        return loadMeta(photoHead, jpegStart);
+
+    // JSON, TITL, DESC and JEND follow the JPEG buffer, data after the End Of File offset isn't read
+    const uint64_t metaStart = static_cast<uint64_t>(jpegStart) + jpegBuffer;
+    const uint64_t eofOffset = static_cast<uint64_t>(jpegStart - 28) + endOfFile;
+    const uint64_t metaEnd = (eofOffset > metaStart && eofOffset < static_cast<uint64_t>(fileSize)) ? eofOffset : static_cast<uint64_t>(fileSize);
+    size_t metaSize = 0;
+    if (jpegBuffer >= jpegSize && metaStart < metaEnd)
+        metaSize = static_cast<size_t>(metaEnd - metaStart);
+
+    // The JPEG sizes are zeroed so the loader continues directly with the JSON section
+    std::string sdata(jpegStart + metaSize, '\0');
+    memcpy(&sdata[0], photoHead, jpegStart - 8);
+    if (metaSize && !readFileAt(fd, &sdata[jpegStart], metaSize, static_cast<int64_t>(metaStart))) {
+        m_data->error = Error::Uninitialised; // 0
+        return false;
+    }
+
+    const bool isLoaded = loadMeta(sdata);
+    if (m_data->error > Error::IncompletePhotoSize) {
+        m_data->jpegBuffer = jpegBuffer;
+        m_data->jpegSize = jpegSize;
+    }
+    return isLoaded;
+#else
+    static_cast<void>(fd);
+    m_data->error = Error::Uninitialised; // 0
+    return false;
+#endif
+}
+
+bool RagePhoto::validate(const char *data, size_t size, RagePhotoValidation *rp_validation)
+{
+    memset(rp_validation, 0, sizeof(RagePhotoValidation));
+
+    RagePhotoView rp_view;
+    const bool isLoaded = loadView(data, size, &rp_view);
+    rp_validation->error = rp_view.error;
+    rp_validation->descBuffer = rp_view.descBuffer;
+    rp_validation->descOffset = rp_view.descOffset;
+    rp_validation->endOfFile = rp_view.endOfFile;
+    rp_validation->jpegBuffer = rp_view.jpegBuffer;
+    rp_validation->jpegSize = rp_view.jpegSize;
+    rp_validation->jsonBuffer = rp_view.jsonBuffer;
+    rp_validation->jsonOffset = rp_view.jsonOffset;
+    rp_validation->photoFormat = rp_view.photoFormat;
+    rp_validation->titlBuffer = rp_view.titlBuffer;
+    rp_validation->titlOffset = rp_view.titlOffset;
+    if (rp_view.jpeg)
+        rp_validation->jpegPos = static_cast<size_t>(rp_view.jpeg - data);
+    if (rp_view.json)
+        rp_validation->jsonPos = static_cast<size_t>(rp_view.json - data);
+    if (rp_view.title)
+        rp_validation->titlPos = static_cast<size_t>(rp_view.title - data);
+    if (rp_view.description)
+        rp_validation->descPos = static_cast<size_t>(rp_view.description - data);
+
+    // Error codes are ordered by position, every section before the failing one has been read
+#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT || defined UNICODE_BUILTIN
+    char photoHeader[512];
+    if (rp_view.header && !decodeHeader(rp_view.header, photoHeader, sizeof(photoHeader)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_HEADERUNICODE;
+#endif
+    if (rp_view.error > Error::IncompletePhotoSize && rp_view.jpegSize > rp_view.jpegBuffer)
+        rp_validation->issues |= RAGEPHOTO_ISSUE_JPEGSIZE;
+    if (rp_view.error > Error::PhotoReadError &&
+            (rp_view.jpegSize < 2 || static_cast<unsigned char>(rp_view.jpeg[0]) != 0xFF || static_cast<unsigned char>(rp_view.jpeg[1]) != 0xD8))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_JPEGMARKER;
+    if (rp_view.error > Error::JsonReadError && (rp_view.jsonBuffer == 0 || !memchr(rp_view.json, 0, rp_view.jsonBuffer)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_JSONSTRING;
+    if (rp_view.error > Error::TitleReadError && (rp_view.titlBuffer == 0 || !memchr(rp_view.title, 0, rp_view.titlBuffer)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_TITLESTRING;
+    if (rp_view.error > Error::DescReadError && (rp_view.descBuffer == 0 || !memchr(rp_view.description, 0, rp_view.descBuffer)))
+        rp_validation->issues |= RAGEPHOTO_ISSUE_DESCSTRING;
+
+    if (isLoaded) {
+        const uint32_t jsonOffset = rp_view.jpegBuffer + UINT32_C(28);
+        const uint32_t titlOffset = jsonOffset + rp_view.jsonBuffer + UINT32_C(8);
+        const uint32_t descOffset = titlOffset + rp_view.titlBuffer + UINT32_C(8);
+        const uint32_t endOfFile = descOffset + rp_view.descBuffer + UINT32_C(12);
+        if (rp_view.jsonOffset != jsonOffset)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_JSONOFFSET;
+        if (rp_view.titlOffset != titlOffset)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_TITLEOFFSET;
+        if (rp_view.descOffset != descOffset)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_DESCOFFSET;
+        if (rp_view.endOfFile != endOfFile)
+            rp_validation->issues |= RAGEPHOTO_ISSUE_ENDOFFILE;
+        rp_validation->photoSize = rp_validation->descPos + rp_view.descBuffer + 4;
+    }
+
+    return (isLoaded && rp_validation->issues == 0);
+}
+
+int32_t RagePhoto::error() const
+{
+    return m_data->error;
+}
+
+uint32_t RagePhoto::format() const
+{
+    return m_data->photoFormat;
+}
+
+const std::string RagePhoto::jpeg() const
+{
+    if (m_data->jpeg)
+        return std::string(m_data->jpeg, m_data->jpegSize);
+    return std::string();
+}
+
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+const std::string_view RagePhoto::jpeg_view() const
+{
+    if (m_data->jpeg)
+        return std::string_view(m_data->jpeg, m_data->jpegSize);
+    return std::string_view();
+}
+#endif
+
+const char* RagePhoto::jpegData() const
+{
+    if (m_data->jpeg)
+        return m_data->jpeg;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+}
+
+uint64_t RagePhoto::jpegSign(uint32_t photoFormat, RagePhotoData *rp_data)
+{
+    if (rp_data->jpeg) {
+        if (rp_data->signFormat != 0 && rp_data->signFormat == photoFormat)
+            return rp_data->jpegSign;
+        else if (photoFormat == PhotoFormat::GTA5)
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, SignInitials::SIGTA5));
+        else if (photoFormat == PhotoFormat::RDR2)
+            rp_data->jpegSign = (UINT64_C(0x100000000000000) | joaatFromInitial(rp_data->jpeg, rp_data->jpegSize, SignInitials::SIRDR2));
+        else
+            return 0;
+        rp_data->signFormat = photoFormat;
+        return rp_data->jpegSign;
+    }
+    return 0;
+}
+
+uint64_t RagePhoto::jpegSign(RagePhotoData *rp_data)
+{
+    return jpegSign(rp_data->photoFormat, rp_data);
+}
+
+uint64_t RagePhoto::jpegSign(uint32_t photoFormat) const
+{
+    // A const Photo may be shared between threads, so the cache is never written here
+    if (m_data->jpeg) {
+        if (m_data->signFormat != 0 && m_data->signFormat == photoFormat)
+            return m_data->jpegSign;
+        else if (photoFormat == PhotoFormat::GTA5)
+            return (UINT64_C(0x100000000000000) | joaatFromInitial(m_data->jpeg, m_data->jpegSize, SignInitials::SIGTA5));
+        else if (photoFormat == PhotoFormat::RDR2)
+            return (UINT64_C(0x100000000000000) | joaatFromInitial(m_data->jpeg, m_data->jpegSize, SignInitials::SIRDR2));
+    }
+    return 0;
+}
+
+uint64_t RagePhoto::jpegSign() const
+{
+    return jpegSign(m_data->photoFormat);
+}
+
+uint64_t RagePhoto::jpegSign(uint32_t photoFormat)
+{
+    return jpegSign(photoFormat, m_data);
+}
+
+uint64_t RagePhoto::jpegSign()
+{
+    return jpegSign(m_data->photoFormat, m_data);
+}
+
+void RagePhoto::jpegSignMany(RagePhotoData **rp_data, size_t count, uint64_t *signs)
+{
+    const char *data[JOAAT_CHUNK];
+    size_t size[JOAAT_CHUNK];
+    uint32_t init_val[JOAAT_CHUNK];
+    uint32_t hash[JOAAT_CHUNK];
+    size_t index[JOAAT_CHUNK];
+    for (size_t offset = 0; offset < count; offset += JOAAT_CHUNK) {
+        const size_t end = (count - offset > JOAAT_CHUNK) ? offset + JOAAT_CHUNK : count;
+        size_t jobs = 0;
+        for (size_t i = offset; i < end; i++) {
+            signs[i] = 0;
+            if (!rp_data[i] || !rp_data[i]->jpeg)
+                continue;
+            if (rp_data[i]->signFormat != 0 && rp_data[i]->signFormat == rp_data[i]->photoFormat) {
+                signs[i] = rp_data[i]->jpegSign;
+                continue;
+            }
+            if (rp_data[i]->photoFormat == PhotoFormat::GTA5)
+                init_val[jobs] = SignInitials::SIGTA5;
+            else if (rp_data[i]->photoFormat == PhotoFormat::RDR2)
+                init_val[jobs] = SignInitials::SIRDR2;
+            else
+                continue;
+            data[jobs] = rp_data[i]->jpeg;
+            size[jobs] = rp_data[i]->jpegSize;
+            index[jobs] = i;
+            jobs++;
+        }
+        joaatMany(data, size, init_val, hash, jobs);
+        for (size_t i = 0; i < jobs; i++) {
+            RagePhotoData *t_data = rp_data[index[i]];
+            t_data->jpegSign = (UINT64_C(0x100000000000000) | hash[i]);
+            t_data->signFormat = t_data->photoFormat;
+            signs[index[i]] = t_data->jpegSign;
+        }
+    }
+}
+
+uint32_t RagePhoto::jpegSize() const
+{
+    if (m_data->jpeg)
+        return m_data->jpegSize;
+    return 0;
+}
+
+const char* RagePhoto::description() const
+{
+    if (m_data->description)
+        return m_data->description;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+}
+
+const char* RagePhoto::header() const
+{
+    if (m_data->header)
+        return m_data->header;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+}
+
+const char* RagePhoto::json() const
+{
+    if (m_data->json)
+        return m_data->json;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+}
+
+const char* RagePhoto::title() const
+{
+    if (m_data->title)
+        return m_data->title;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
+}
+
+const char* RagePhoto::version()
+{
+    return RAGEPHOTO_VERSION;
+}
+
+bool RagePhoto::save(char *data, uint32_t photoFormat, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+{
+    if (photoFormat == PhotoFormat::GTA5 || photoFormat == PhotoFormat::RDR2) {
+        if (!rp_data->header) {
+            rp_data->error = Error::IncompleteHeader; // 3
+            return false;
+        }
+#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT || defined UNICODE_BUILTIN
+        char photoHeader[256];
+        if (!saveHeader(rp_data, photoHeader))
+            return false;
+
+        const size_t length = saveSize(photoFormat, rp_data, nullptr);
+        size_t pos = 0;
+
+        const RagePhotoLayout *layout = photoLayout(photoFormat);
+        uint32_t fields[LAYOUT_FIELD_CONSTANT];
+        saveFields(rp_data, fields);
+
+        // The fixed header is assembled first and written at once
+        char layoutBuffer[RAGEPHOTO_LAYOUT_MAXSIZE];
+        uInt32ToCharLE(photoFormat, layoutBuffer);
+        memcpy(&layoutBuffer[4], photoHeader, 256);
+        saveLayout(layout, fields, layoutBuffer);
+        writeBuffer(layoutBuffer, data, &pos, length, layout->size);
+
+        if (rp_data->jpeg) {
+            if (rp_data->jpegSize > rp_data->jpegBuffer) {
+                rp_data->error = Error::PhotoBufferTight; // 36
+                return false;
+            }
+            writeBuffer(rp_data->jpeg, data, &pos, length, rp_data->jpegSize);
+            zeroBuffer(data, &pos, length, rp_data->jpegBuffer - rp_data->jpegSize);
+        }
+        else {
+            zeroBuffer(data, &pos, length, rp_data->jpegBuffer);
+        }
+
+        const RagePhotoSectionEntry sections[3] = {
+            {&rp_data->json, &rp_data->jsonBuffer, nullptr, 0, RAGEPHOTO_MARKER_JSON, Error::JsonBufferTight}, // 37
+            {&rp_data->title, &rp_data->titlBuffer, nullptr, 0, RAGEPHOTO_MARKER_TITL, Error::TitleBufferTight}, // 38
+            {&rp_data->description, &rp_data->descBuffer, nullptr, 0, RAGEPHOTO_MARKER_DESC, Error::DescBufferTight} // 39
+        };
+        for (size_t i = 0; i < 3; i++) {
+            const RagePhotoSectionEntry *section = &sections[i];
+            char sectionHead[8];
+            uInt32ToCharLE(section->marker, &sectionHead[0]);
+            uInt32ToCharLE(*section->buffer, &sectionHead[4]);
+            writeBuffer(sectionHead, data, &pos, length, 8);
+            if (*section->data) {
+                const size_t string_size = strlen(*section->data) + 1;
+                if (string_size > *section->buffer) {
+                    rp_data->error = section->error;
+                    return false;
+                }
+                writeBuffer(*section->data, data, &pos, length, string_size);
+                zeroBuffer(data, &pos, length, *section->buffer - string_size);
+            }
+            else {
+                zeroBuffer(data, &pos, length, *section->buffer);
+            }
+        }
+
+        writeBuffer("JEND", data, &pos, length, 4);
+
+        rp_data->error = Error::NoError; // 255
+        return true;
+#else
+        std::cout << "UTF-16LE encoding support missing" << std::endl;
+        rp_data->error = Error::UnicodeInitError; // 4
+        return false;
+#endif
+    }
+    else if (photoFormat == PhotoFormat::JPEG) {
+        if (rp_data->jpeg) {
+            size_t pos = 0;
+            writeBuffer(rp_data->jpeg, data, &pos, rp_data->jpegSize, rp_data->jpegSize);
+        }
+        else {
+            rp_data->error = Error::PhotoReadError; // 17
+            return false;
+        }
+
+        rp_data->error = Error::NoError; // 255
+        return true;
+    }
+    else {
+        if (rp_parser) {
+            RagePhotoFormatParser n_parser[1]{};
+            for (size_t i = 0; memcmp(&n_parser[0], &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
+                if (photoFormat == rp_parser[i].photoFormat)
+                    if (rp_parser[i].funcSave)
+                        return (rp_parser[i].funcSave)(rp_data, data, photoFormat);
+            }
+        }
+        RagePhotoFormatParser r_parser;
+        if (registeredParser(photoFormat, &r_parser) && r_parser.funcSave)
+            return (r_parser.funcSave)(rp_data, data, photoFormat);
+    }
+
+    rp_data->error = Error::IncompatibleFormat; // 2
+    return false;
+}
+
+bool RagePhoto::save(char *data, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+{
+    return save(data, rp_data->photoFormat, rp_data, rp_parser);
+}
+
+bool RagePhoto::save(char *data, uint32_t photoFormat)
+{
+    return save(data, photoFormat, m_data, m_parser);
+}
+
+bool RagePhoto::save(char *data)
+{
+    return save(data, m_data->photoFormat, m_data, m_parser);
+}
+
+size_t RagePhoto::saveIov(RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat, RagePhotoData *rp_data)
+{
+    size_t index = 0;
+    if (photoFormat == PhotoFormat::GTA5 || photoFormat == PhotoFormat::RDR2) {
+        if (!rp_data->header) {
+            rp_data->error = Error::IncompleteHeader; // 3
+            return 0;
+        }
+#if defined UNICODE_ICONV || defined UNICODE_CODECVT || defined UNICODE_WINCVT || defined UNICODE_BUILTIN
+        // The buffer holds the fixed header, the three section heads and the JEND marker
+        const RagePhotoLayout *layout = photoLayout(photoFormat);
+        uInt32ToCharLE(photoFormat, buffer);
+        if (!saveHeader(rp_data, &buffer[4]))
+            return 0;
+        uint32_t fields[LAYOUT_FIELD_CONSTANT];
+        saveFields(rp_data, fields);
+        saveLayout(layout, fields, buffer);
+        appendIov(iov, count, &index, buffer, layout->size);
+
+        if (rp_data->jpeg) {
+            if (rp_data->jpegSize > rp_data->jpegBuffer) {
+                rp_data->error = Error::PhotoBufferTight; // 36
+                return 0;
+            }
+            appendIov(iov, count, &index, rp_data->jpeg, rp_data->jpegSize);
+            appendZeroIov(iov, count, &index, rp_data->jpegBuffer - rp_data->jpegSize);
+        }
+        else {
+            appendZeroIov(iov, count, &index, rp_data->jpegBuffer);
+        }
+
+        const RagePhotoSectionEntry sections[3] = {
+            {&rp_data->json, &rp_data->jsonBuffer, nullptr, 0, RAGEPHOTO_MARKER_JSON, Error::JsonBufferTight}, // 37
+            {&rp_data->title, &rp_data->titlBuffer, nullptr, 0, RAGEPHOTO_MARKER_TITL, Error::TitleBufferTight}, // 38
+            {&rp_data->description, &rp_data->descBuffer, nullptr, 0, RAGEPHOTO_MARKER_DESC, Error::DescBufferTight} // 39
+        };
+        char *sectionHead = &buffer[layout->size];
+        for (size_t i = 0; i < 3; i++) {
+            const RagePhotoSectionEntry *section = &sections[i];
+            uInt32ToCharLE(section->marker, &sectionHead[0]);
+            uInt32ToCharLE(*section->buffer, &sectionHead[4]);
+            appendIov(iov, count, &index, sectionHead, 8);
+            sectionHead += 8;
+            if (*section->data) {
+                const size_t string_size = strlen(*section->data) + 1;
+                if (string_size > *section->buffer) {
+                    rp_data->error = section->error;
+                    return 0;
+                }
+                appendIov(iov, count, &index, *section->data, string_size);
+                appendZeroIov(iov, count, &index, *section->buffer - string_size);
+            }
+            else {
+                appendZeroIov(iov, count, &index, *section->buffer);
+            }
+        }
+
+        memcpy(sectionHead, "JEND", 4);
+        appendIov(iov, count, &index, sectionHead, 4);
+
+        rp_data->error = Error::NoError; // 255
+        return index;
+#else
+        std::cout << "UTF-16LE encoding support missing" << std::endl;
+        rp_data->error = Error::UnicodeInitError; // 4
+        return 0;
+#endif
+    }
+    else if (photoFormat == PhotoFormat::JPEG) {
+        if (!rp_data->jpeg) {
+            rp_data->error = Error::PhotoReadError; // 17
+            return 0;
+        }
+        appendIov(iov, count, &index, rp_data->jpeg, rp_data->jpegSize);
+
+        rp_data->error = Error::NoError; // 255
+        return index;
+    }
+
+    rp_data->error = Error::IncompatibleFormat; // 2
+    return 0;
+}
+
+size_t RagePhoto::saveIov(RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat)
+{
+    return saveIov(iov, count, buffer, photoFormat, m_data);
+}
+
+size_t RagePhoto::saveIov(RagePhotoIovec *iov, size_t count, char *buffer)
+{
+    return saveIov(iov, count, buffer, m_data->photoFormat, m_data);
+}
+
+const std::string RagePhoto::save(uint32_t photoFormat, bool *ok)
+{
+    std::string sdata;
+    const size_t size = saveSize(photoFormat, m_data, m_parser);
+    if (size == 0) {
+        if (ok)
+            *ok = false;
+        return sdata;
+    }
+    sdata.resize(size);
+    const bool saved = save(&sdata[0], photoFormat, m_data, m_parser);
+    if (ok)
+        *ok = saved;
+    return sdata;
+}
+
+const std::string RagePhoto::save(bool *ok)
+{
+    return save(m_data->photoFormat, ok);
+}
+
+bool RagePhoto::saveFile(const char *filename, uint32_t photoFormat)
+{
+    // GTA V, RDR 2 and JPEG Photos are written from their section buffers, other formats are saved to a std::string first
+    std::vector<RagePhotoIovec> iov;
+    char buffer[RAGEPHOTO_SAVEIOV_BUFFERSIZE];
+    std::string sdata;
+    try {
+        if (photoFormat == PhotoFormat::GTA5 || photoFormat == PhotoFormat::RDR2 || photoFormat == PhotoFormat::JPEG) {
+            iov.resize(32);
+            const size_t count = saveIov(iov.data(), iov.size(), buffer, photoFormat, m_data);
+            if (count == 0)
+                return false;
+            if (count > iov.size()) {
+                iov.resize(count);
+                saveIov(iov.data(), iov.size(), buffer, photoFormat, m_data);
+            }
+            iov.resize(count);
+        }
+        else {
+            bool ok;
+            sdata = save(photoFormat, &ok);
+            if (!ok)
+                return false;
+            iov.push_back({&sdata[0], sdata.size()});
+        }
+    }
+    catch (const std::bad_alloc&) {
+        m_data->error = Error::PhotoMallocError; // 16
+        return false;
+    }
+#ifdef RAGEPHOTO_DIRECT_SAVE
+    if (!(libraryflags & RAGEPHOTO_FLAG_DISABLE_DIRECT_SAVE)) {
+        bool opened;
+        const bool written = saveFileDirect(filename, iov.data(), iov.size(), &opened);
+        if (!opened)
+            m_data->error = Error::Uninitialised; // 0
+        return written;
+    }
+#endif
+#if defined(_WIN32) && (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+    std::ofstream ofs(std::filesystem::u8path(filename), std::ios::out | std::ios::binary | std::ios::trunc);
+#elif defined(_WIN32)
+    std::ofstream ofs(convertPath(filename).data(), std::ios::out | std::ios::binary | std::ios::trunc);
+#else
+    std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+#endif
+    if (!ofs.is_open()) {
+        m_data->error = Error::Uninitialised; // 0
+        return false;
+    }
+    for (const RagePhotoIovec &entry : iov)
+        ofs.write(static_cast<const char*>(entry.iov_base), entry.iov_len);
+    const bool ok = ofs.good();
+    ofs.close();
+    return ok;
+}
+
+bool RagePhoto::saveFile(const char *filename)
+{
+    return saveFile(filename, m_data->photoFormat);
+}
+
+size_t RagePhoto::saveSize(uint32_t photoFormat, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+{
+    if (photoFormat == PhotoFormat::GTA5)
+        return (rp_data->jpegBuffer + rp_data->jsonBuffer + rp_data->titlBuffer + rp_data->descBuffer + GTA5_HEADERSIZE + UINT32_C(56));
+    else if (photoFormat == PhotoFormat::RDR2)
+        return (rp_data->jpegBuffer + rp_data->jsonBuffer + rp_data->titlBuffer + rp_data->descBuffer + RDR2_HEADERSIZE + UINT32_C(56));
+    else if (photoFormat == PhotoFormat::JPEG)
+        return (rp_data->jpegSize);
+    else {
+        if (rp_parser) {
+            RagePhotoFormatParser n_parser[1]{};
+            for (size_t i = 0; memcmp(&n_parser[0], &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
+                if (photoFormat == rp_parser[i].photoFormat)
+                    if (rp_parser[i].funcSaveSz)
+                        return (rp_parser[i].funcSaveSz)(rp_data, photoFormat);
+            }
+        }
+        RagePhotoFormatParser r_parser;
+        if (registeredParser(photoFormat, &r_parser) && r_parser.funcSaveSz)
+            return (r_parser.funcSaveSz)(rp_data, photoFormat);
+    }
+    return 0;
+}
+
+size_t RagePhoto::saveSize(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+{
+    return saveSize(rp_data->photoFormat, rp_data, rp_parser);
+}
+
+size_t RagePhoto::saveSize(uint32_t photoFormat)
+{
+    return saveSize(photoFormat, m_data, m_parser);
+}
+
+size_t RagePhoto::saveSize()
+{
+    return saveSize(m_data->photoFormat, m_data, m_parser);
+}
+
+void RagePhoto::setBufferDefault(RagePhotoData *rp_data)
+{
+    rp_data->descBuffer = DEFAULT_DESCBUFFER;
+    rp_data->jsonBuffer = DEFAULT_JSONBUFFER;
+    rp_data->titlBuffer = DEFAULT_TITLBUFFER;
+    setBufferOffsets(rp_data);
+}
+
+void RagePhoto::setBufferDefault()
+{
+    setBufferDefault(m_data);
+}
+
+void RagePhoto::setBufferOffsets(RagePhotoData *rp_data)
+{
+    rp_data->jsonOffset = rp_data->jpegBuffer + 28;
+    rp_data->titlOffset = rp_data->jsonOffset + rp_data->jsonBuffer + 8;
+    rp_data->descOffset = rp_data->titlOffset + rp_data->titlBuffer + 8;
+    rp_data->endOfFile = rp_data->descOffset + rp_data->descBuffer + 12;
+}
+
+void RagePhoto::setBufferOffsets()
+{
+    setBufferOffsets(m_data);
+}
+
+/* Library state is only read from source when it belongs to an instance, other data objects only provide the sections */
+inline bool copyPhotoData(RagePhotoData *rp_data, const RagePhotoData *source, bool isInstanceData)
+{
+    RagePhoto::clear(rp_data);
+    rp_data->photoFormat = source->photoFormat;
+
+    // Sections in storage are shared when both use the same allocator
+    if (isInstanceData && source->storage && dataAllocator(source) == dataAllocator(rp_data)) {
+        retainStorage(source->storage);
+        rp_data->storage = source->storage;
+    }
+
+    if (source->header) {
+        if (!shareStorageData(rp_data, source, source->header, &rp_data->header)) {
+            const size_t headerSize = strlen(source->header) + 1;
+            rp_data->header = static_cast<char*>(allocBuffer(rp_data, headerSize));
+            if (!rp_data->header)
+                return false;
+            memcpy(rp_data->header, source->header, headerSize);
+            rp_data->headerCapacity = static_cast<uint32_t>(headerSize);
+        }
+        rp_data->headerSum = source->headerSum;
+        rp_data->headerSum2 = source->headerSum2;
+    }
+
+    if (source->jpeg) {
+        if (!shareStorageData(rp_data, source, source->jpeg, &rp_data->jpeg)) {
+            rp_data->jpeg = static_cast<char*>(allocBuffer(rp_data, source->jpegSize));
+            if (!rp_data->jpeg)
+                return false;
+            memcpy(rp_data->jpeg, source->jpeg, source->jpegSize);
+            rp_data->jpegCapacity = source->jpegSize;
+        }
+        rp_data->jpegSize = source->jpegSize;
+        rp_data->jpegBuffer = source->jpegBuffer;
+        if (isInstanceData) {
+            rp_data->jpegSign = source->jpegSign;
+            rp_data->signFormat = source->signFormat;
+        }
+    }
+
+    if (source->json) {
+        if (!shareStorageData(rp_data, source, source->json, &rp_data->json)) {
+            const size_t jsonSize = strlen(source->json) + 1;
+            rp_data->json = static_cast<char*>(allocBuffer(rp_data, jsonSize));
+            if (!rp_data->json)
+                return false;
+            memcpy(rp_data->json, source->json, jsonSize);
+            rp_data->jsonCapacity = static_cast<uint32_t>(jsonSize);
+        }
+        rp_data->jsonBuffer = source->jsonBuffer;
+    }
+
+    if (source->title) {
+        if (!shareStorageData(rp_data, source, source->title, &rp_data->title)) {
+            const size_t titleSize = strlen(source->title) + 1;
+            rp_data->title = static_cast<char*>(allocBuffer(rp_data, titleSize));
+            if (!rp_data->title)
+                return false;
+            memcpy(rp_data->title, source->title, titleSize);
+            rp_data->titlCapacity = static_cast<uint32_t>(titleSize);
+        }
+        rp_data->titlBuffer = source->titlBuffer;
+    }
+
+    if (source->description) {
+        if (!shareStorageData(rp_data, source, source->description, &rp_data->description)) {
+            const size_t descriptionSize = strlen(source->description) + 1;
+            rp_data->description = static_cast<char*>(allocBuffer(rp_data, descriptionSize));
+            if (!rp_data->description)
+                return false;
+            memcpy(rp_data->description, source->description, descriptionSize);
+            rp_data->descCapacity = static_cast<uint32_t>(descriptionSize);
+        }
+        rp_data->descBuffer = source->descBuffer;
+    }
+
+    RagePhoto::setBufferOffsets(rp_data);
+    return true;
+}
+
+bool RagePhoto::copyData(const RagePhoto &ragePhoto)
+{
+    if (m_data == ragePhoto.m_data)
+        return true;
+    return copyPhotoData(m_data, ragePhoto.m_data, true);
+}
+
+bool RagePhoto::setData(RagePhotoData *rp_data, bool takeCopy)
+{
+    if (m_data == rp_data)
+        return true;
+
+    if (takeCopy)
+        return copyPhotoData(m_data, rp_data, false);
+
+    freeData(m_data);
+    free(m_data);
+
+    m_data = rp_data;
+    return true;
+}
+
+void RagePhoto::setDescription(const char *description, uint32_t bufferSize)
+{
+    detachStorageData(m_data, &m_data->description);
+    if (!writeDataChar(m_data, description, &m_data->description, &m_data->descCapacity)) {
+        m_data->error = Error::DescMallocError; // 31
+        return;
+    }
+    if (bufferSize != 0) {
+        m_data->descBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+void RagePhoto::setDescription(const char *description, size_t length, uint32_t bufferSize)
+{
+    detachStorageData(m_data, &m_data->description);
+    if (!writeDataCharl(m_data, description, length, &m_data->description, &m_data->descCapacity)) {
+        m_data->error = Error::DescMallocError; // 31
+        return;
+    }
+    if (bufferSize != 0) {
+        m_data->descBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+void RagePhoto::setDescription(std::string_view description, uint32_t bufferSize)
+{
+    setDescription(description.data(), description.size(), bufferSize);
+}
+#endif
+
+void RagePhoto::setFormat(uint32_t photoFormat)
+{
+    m_data->photoFormat = photoFormat;
+}
+
+void RagePhoto::setHeader(const char *header, uint32_t headerSum, uint32_t headerSum2)
+{
+    detachStorageData(m_data, &m_data->header);
+    if (!writeDataChar(m_data, header, &m_data->header, &m_data->headerCapacity)) {
+        m_data->error = Error::HeaderMallocError; // 4
+        return;
+    }
+    m_data->headerSum = headerSum;
+    m_data->headerSum2 = headerSum2;
+    m_data->error = Error::NoError; // 255
+}
+
+bool RagePhoto::setJpeg(const char *data, uint32_t size, uint32_t bufferSize)
+{
+    m_data->signFormat = 0;
+    if (isStorageData(m_data, m_data->jpeg)) {
+        m_data->jpeg = nullptr;
+        m_data->jpegSize = 0;
+    }
+    if (data && size) {
+        if (m_data->jpeg && m_data->jpegCapacity >= size) {
+            memcpy(m_data->jpeg, data, size);
+            m_data->jpegSize = size;
+        }
+        else if (m_data->jpeg) {
+            if (m_data->jpegSize > size) {
+                char *t_photoData = static_cast<char*>(reallocBuffer(m_data, m_data->jpeg, size));
+                if (!t_photoData) {
+                    m_data->error = Error::PhotoMallocError; // 16
+                    return false;
+                }
+                m_data->jpeg = t_photoData;
+                memcpy(m_data->jpeg, data, size);
+                m_data->jpegCapacity = size;
+                m_data->jpegSize = size;
+            }
+            else if (m_data->jpegSize < size) {
+                char *t_photoData = static_cast<char*>(allocBuffer(m_data, size));
+                if (!t_photoData) {
+                    m_data->error = Error::PhotoMallocError; // 16
+                    return false;
+                }
+                freeBuffer(m_data, m_data->jpeg);
+                m_data->jpeg = t_photoData;
+                memcpy(m_data->jpeg, data, size);
+                m_data->jpegCapacity = size;
+                m_data->jpegSize = size;
+            }
+            else {
+                memcpy(m_data->jpeg, data, size);
+            }
+        }
+        else {
+            m_data->jpeg = static_cast<char*>(allocBuffer(m_data, size));
+            if (!m_data->jpeg) {
+                m_data->error = Error::PhotoMallocError; // 16
+                return false;
+            }
+            memcpy(m_data->jpeg, data, size);
+            m_data->jpegCapacity = size;
+            m_data->jpegSize = size;
+        }
+    }
+    else if (m_data->jpeg) {
+        freeBuffer(m_data, m_data->jpeg);
+        m_data->jpeg = nullptr;
+        m_data->jpegCapacity = 0;
+        m_data->jpegSize = 0;
+    }
+
+    if (bufferSize != 0) {
+        m_data->jpegBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+
+    m_data->error = Error::NoError; // 255
+    return true;
+}
+
+bool RagePhoto::setJpeg(const std::string &data, uint32_t bufferSize)
+{
+    return setJpeg(data.data(), static_cast<uint32_t>(data.size()), bufferSize);
+}
+
+void RagePhoto::adoptJpeg(char *data, uint32_t size, uint32_t bufferSize)
+{
+    m_data->signFormat = 0;
+    if (!isStorageData(m_data, m_data->jpeg))
+        freeBuffer(m_data, m_data->jpeg);
+    m_data->jpeg = data;
+    m_data->jpegCapacity = data ? size : 0;
+    m_data->jpegSize = data ? size : 0;
+    if (bufferSize != 0) {
+        m_data->jpegBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+void RagePhoto::setJson(const char *json, uint32_t bufferSize)
+{
+    detachStorageData(m_data, &m_data->json);
+    if (!writeDataChar(m_data, json, &m_data->json, &m_data->jsonCapacity)) {
+        m_data->error = Error::JsonMallocError; // 21
+        return;
+    }
+    if (bufferSize != 0) {
+        m_data->jsonBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+void RagePhoto::setJson(const char *json, size_t length, uint32_t bufferSize)
+{
+    detachStorageData(m_data, &m_data->json);
+    if (!writeDataCharl(m_data, json, length, &m_data->json, &m_data->jsonCapacity)) {
+        m_data->error = Error::JsonMallocError; // 21
+        return;
+    }
+    if (bufferSize != 0) {
+        m_data->jsonBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+void RagePhoto::adoptJson(char *json, uint32_t bufferSize)
+{
+    if (!isStorageData(m_data, m_data->json))
+        freeBuffer(m_data, m_data->json);
+    m_data->json = json;
+    m_data->jsonCapacity = 0;
+    if (bufferSize != 0) {
+        m_data->jsonBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+void RagePhoto::setJson(std::string_view json, uint32_t bufferSize)
+{
+    setJson(json.data(), json.size(), bufferSize);
+}
+#endif
+
+void RagePhoto::setLibraryFlag(RagePhotoLibraryFlag flag, bool state)
+{
+    state ? (libraryflags |= flag) : (libraryflags &= ~flag);
+}
+
+void RagePhoto::setSizeLimits(const RagePhotoSizeLimits *limits)
+{
+    if (limits) {
+        sizelimits = *limits;
+        return;
+    }
+    sizelimits.descBuffer = UINT32_MAX;
+    sizelimits.jpegSize = UINT32_MAX;
+    sizelimits.jsonBuffer = UINT32_MAX;
+    sizelimits.titlBuffer = UINT32_MAX;
+}
+
+void RagePhoto::sizeLimits(RagePhotoSizeLimits *limits)
+{
+    *limits = sizelimits;
+}
+
+void RagePhoto::setLibraryAllocator(const RagePhotoAllocator *allocator)
+{
+    if (allocator)
+        libraryallocator = *allocator;
+    else
+        memset(&libraryallocator, 0, sizeof(RagePhotoAllocator));
+}
+
+void RagePhoto::setAllocator(const RagePhotoAllocator *allocator)
+{
+    clear(m_data);
+    m_data->allocator = allocator;
+}
+
+void RagePhoto::setTitle(const char *title, uint32_t bufferSize)
+{
+    detachStorageData(m_data, &m_data->title);
+    if (!writeDataChar(m_data, title, &m_data->title, &m_data->titlCapacity)) {
+        m_data->error = Error::TitleMallocError; // 26
+        return;
+    }
+    if (bufferSize != 0) {
+        m_data->titlBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+void RagePhoto::setTitle(const char *title, size_t length, uint32_t bufferSize)
+{
+    detachStorageData(m_data, &m_data->title);
+    if (!writeDataCharl(m_data, title, length, &m_data->title, &m_data->titlCapacity)) {
+        m_data->error = Error::TitleMallocError; // 26
+        return;
+    }
+    if (bufferSize != 0) {
+        m_data->titlBuffer = bufferSize;
+        setBufferOffsets(m_data);
+    }
+    m_data->error = Error::NoError; // 255
+}
+
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+void RagePhoto::setTitle(std::string_view title, uint32_t bufferSize)
+{
+    setTitle(title.data(), title.size(), bufferSize);
+}
+#endif
+
+void RagePhoto::swap(RagePhoto &ragePhoto) noexcept
+{
+    RagePhotoData *t_data = m_data;
+    RagePhotoFormatParser *t_parser = m_parser;
+    m_data = ragePhoto.m_data;
+    m_parser = ragePhoto.m_parser;
+    ragePhoto.m_data = t_data;
+    ragePhoto.m_parser = t_parser;
+}
+#ifdef LIBRAGEPHOTO_CXX_C
+ragephoto_t ragephoto_open()
+{
+    try {
+        return reinterpret_cast<ragephoto_t>(new RagePhoto);
+    }
+    catch (const std::exception &exception) {
+        std::cerr << "[libragephoto] Exception thrown at ragephoto_open: " << exception.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void ragephoto_addparser(ragephoto_t instance, RagePhotoFormatParser *rp_parser)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    try {
+        ragePhoto->addParser(rp_parser);
+    }
+    catch (const std::exception &exception) {
+        std::cerr << "[libragephoto] Exception thrown at ragephoto_addparser: " << exception.what() << std::endl;
+    }
+}
+
+bool ragephoto_registerparser(const RagePhotoFormatParser *rp_parser)
+{
+    return RagePhoto::registerParser(rp_parser);
+}
+
+bool ragephoto_unregisterparser(uint32_t photoFormat)
+{
+    return RagePhoto::unregisterParser(photoFormat);
+}
+
+void ragephoto_clear(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->clear();
+}
+
+void ragephotodata_clear(RagePhotoData *rp_data)
+{
+    RagePhoto::clear(rp_data);
+}
+
+void ragephoto_reset(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->reset();
+}
+
+void ragephotodata_reset(RagePhotoData *rp_data)
+{
+    RagePhoto::reset(rp_data);
+}
+
+bool ragephoto_load(ragephoto_t instance, const char *data, size_t size)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->load(data, size);
+}
+
+bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t size)
+{
+    return RagePhoto::load(data, size, rp_data, rp_parser);
+}
+
+bool ragephoto_loadmeta(ragephoto_t instance, const char *data, size_t size)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->loadMeta(data, size);
+}
+
+bool ragephotodata_loadmeta(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t size)
+{
+    return RagePhoto::loadMeta(data, size, rp_data, rp_parser);
+}
+
+bool ragephoto_loadfile(ragephoto_t instance, const char *filename)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->loadFile(filename);
+}
+
+bool ragephoto_loadmetafile(ragephoto_t instance, const char *filename)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->loadMetaFile(filename);
+}
+
+bool ragephoto_loadmetafd(ragephoto_t instance, int fd)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->loadMetaFd(fd);
+}
+
+bool ragephoto_validate(const char *data, size_t size, RagePhotoValidation *rp_validation)
+{
+    return RagePhoto::validate(data, size, rp_validation);
+}
+
+int32_t ragephoto_error(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->error();
+}
+
+uint32_t ragephoto_defpbuf_gta5()
+{
+    return RagePhoto::DEFAULT_GTA5_PHOTOBUFFER;
+}
+
+uint32_t ragephoto_defpbuf_rdr2()
+{
+    return RagePhoto::DEFAULT_RDR2_PHOTOBUFFER;
+}
+
+uint32_t ragephoto_format_gta5()
+{
+    return RagePhoto::GTA5;
+}
+
+uint32_t ragephoto_format_rdr2()
+{
+    return RagePhoto::RDR2;
+}
+
+RagePhotoData* ragephoto_getphotodata(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->data();
+}
+
+RagePhotoData* ragephoto_releasephotodata(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->releaseData();
+}
+
+const char* ragephoto_getphotodesc(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->description();
+}
+
+uint32_t ragephoto_getphotoformat(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->format();
+}
+
+const char* ragephoto_getphotojpeg(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->jpegData();
+}
+
+const char* ragephoto_getphotojson(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->json();
+}
+
+const char* ragephoto_getphotoheader(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->header();
+}
+
+uint64_t ragephoto_getphotosign(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->jpegSign();
+}
+
+uint64_t ragephoto_getphotosignf(ragephoto_t instance, uint32_t photoFormat)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->jpegSign(photoFormat);
+}
 
-    rp_data->error = Error::IncompatibleFormat; // 2
-    return false;
+void ragephoto_getphotosigns(ragephoto_t instance, char *data, size_t size)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    snprintf(data, size, "%" PRIu64, ragePhoto->jpegSign());
 }
 
-bool RagePhoto::save(char *data, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+void ragephoto_getphotosignsf(ragephoto_t instance, char *data, size_t size, uint32_t photoFormat)
 {
-    return save(data, rp_data->photoFormat, rp_data, rp_parser);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    snprintf(data, size, "%" PRIu64, ragePhoto->jpegSign(photoFormat));
 }
 
-bool RagePhoto::save(char *data, uint32_t photoFormat)
+uint64_t ragephotodata_getphotosign(RagePhotoData *rp_data)
 {
-    return save(data, photoFormat, m_data, m_parser);
+    return RagePhoto::jpegSign(rp_data);
 }
 
-bool RagePhoto::save(char *data)
+uint64_t ragephotodata_getphotosignf(RagePhotoData *rp_data, uint32_t photoFormat)
 {
-    return save(data, m_data->photoFormat, m_data, m_parser);
+    return RagePhoto::jpegSign(photoFormat, rp_data);
 }
 
-const std::string RagePhoto::save(uint32_t photoFormat, bool *ok)
+void ragephotodata_getphotosignmany(RagePhotoData **rp_data, size_t count, uint64_t *signs)
 {
-    std::string sdata;
-    const size_t size = saveSize(photoFormat, m_data, m_parser);
-    if (size == 0) {
-        if (ok)
-            *ok = false;
-        return sdata;
+    RagePhoto::jpegSignMany(rp_data, count, signs);
+}
+
+void ragephoto_getphotosignmany(ragephoto_t *instances, size_t count, uint64_t *signs)
+{
+    RagePhotoData *rp_data[JOAAT_CHUNK];
+    for (size_t offset = 0; offset < count; offset += JOAAT_CHUNK) {
+        const size_t chunk = (count - offset > JOAAT_CHUNK) ? JOAAT_CHUNK : count - offset;
+        for (size_t i = 0; i < chunk; i++)
+            rp_data[i] = instances[offset + i] ? reinterpret_cast<RagePhoto*>(instances[offset + i])->data() : nullptr;
+        RagePhoto::jpegSignMany(rp_data, chunk, &signs[offset]);
     }
-    sdata.resize(size);
-    const bool saved = save(&sdata[0], photoFormat, m_data, m_parser);
-    if (ok)
-        *ok = saved;
-    return sdata;
 }
 
-const std::string RagePhoto::save(bool *ok)
+uint32_t ragephoto_getphotosize(ragephoto_t instance)
 {
-    return save(m_data->photoFormat, ok);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->jpegSize();
 }
 
-bool RagePhoto::saveFile(const char *filename, uint32_t photoFormat)
+const char* ragephoto_getphototitle(ragephoto_t instance)
 {
-    bool ok;
-    const std::string sdata = save(photoFormat, &ok);
-    if (ok) {
-#if defined(_WIN32) && (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
-        std::ofstream ofs(std::filesystem::u8path(filename), std::ios::out | std::ios::binary | std::ios::trunc);
-#elif defined(_WIN32)
-        std::ofstream ofs(convertPath(filename).data(), std::ios::out | std::ios::binary | std::ios::trunc);
-#else
-        std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
-#endif
-        if (!ofs.is_open()) {
-            m_data->error = Error::Uninitialised; // 0
-            return false;
-        }
-        ofs.write(sdata.data(), sdata.size());
-        ok = ofs.good();
-        ofs.close();
-        return ok;
-    }
-    return false;
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->title();
 }
 
-bool RagePhoto::saveFile(const char *filename)
+size_t ragephoto_getsavesize(ragephoto_t instance)
 {
-    return saveFile(filename, m_data->photoFormat);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->saveSize();
 }
 
-size_t RagePhoto::saveSize(uint32_t photoFormat, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+size_t ragephotodata_getsavesize(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
 {
-    if (photoFormat == PhotoFormat::GTA5)
-        return (rp_data->jpegBuffer + rp_data->jsonBuffer + rp_data->titlBuffer + rp_data->descBuffer + GTA5_HEADERSIZE + UINT32_C(56));
-    else if (photoFormat == PhotoFormat::RDR2)
-        return (rp_data->jpegBuffer + rp_data->jsonBuffer + rp_data->titlBuffer + rp_data->descBuffer + RDR2_HEADERSIZE + UINT32_C(56));
-    else if (photoFormat == PhotoFormat::JPEG)
-        return (rp_data->jpegSize);
-    else if (rp_parser) {
-        RagePhotoFormatParser n_parser[1]{};
-        for (size_t i = 0; memcmp(&n_parser[0], &rp_parser[i], sizeof(RagePhotoFormatParser)); i++) {
-            if (photoFormat == rp_parser[i].photoFormat)
-                if (rp_parser[i].funcSaveSz)
-                    return (rp_parser[i].funcSaveSz)(rp_data, photoFormat);
-        }
-    }
-    return 0;
+    return RagePhoto::saveSize(rp_data, rp_parser);
 }
 
-size_t RagePhoto::saveSize(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+size_t ragephoto_getsavesizef(ragephoto_t instance, uint32_t photoFormat)
 {
-    return saveSize(rp_data->photoFormat, rp_data, rp_parser);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->saveSize(photoFormat);
 }
 
-size_t RagePhoto::saveSize(uint32_t photoFormat)
+size_t ragephotodata_getsavesizef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, uint32_t photoFormat)
 {
-    return saveSize(photoFormat, m_data, m_parser);
+    return RagePhoto::saveSize(photoFormat, rp_data, rp_parser);
 }
 
-size_t RagePhoto::saveSize()
+bool ragephoto_save(ragephoto_t instance, char *data)
 {
-    return saveSize(m_data->photoFormat, m_data, m_parser);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->save(data);
 }
 
-void RagePhoto::setBufferDefault(RagePhotoData *rp_data)
+bool ragephotodata_save(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, char *data)
 {
-    rp_data->descBuffer = DEFAULT_DESCBUFFER;
-    rp_data->jsonBuffer = DEFAULT_JSONBUFFER;
-    rp_data->titlBuffer = DEFAULT_TITLBUFFER;
-    setBufferOffsets(rp_data);
+    return RagePhoto::save(data, rp_data->photoFormat, rp_data, rp_parser);
 }
 
-void RagePhoto::setBufferDefault()
+bool ragephoto_savef(ragephoto_t instance, char *data, uint32_t photoFormat)
 {
-    setBufferDefault(m_data);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->save(data, photoFormat);
 }
 
-void RagePhoto::setBufferOffsets(RagePhotoData *rp_data)
+bool ragephotodata_savef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, char *data, uint32_t photoFormat)
 {
-    rp_data->jsonOffset = rp_data->jpegBuffer + 28;
-    rp_data->titlOffset = rp_data->jsonOffset + rp_data->jsonBuffer + 8;
-    rp_data->descOffset = rp_data->titlOffset + rp_data->titlBuffer + 8;
-    rp_data->endOfFile = rp_data->descOffset + rp_data->descBuffer + 12;
+    return RagePhoto::save(data, photoFormat, rp_data, rp_parser);
 }
 
-void RagePhoto::setBufferOffsets()
+size_t ragephoto_saveiov(ragephoto_t instance, RagePhotoIovec *iov, size_t count, char *buffer)
 {
-    setBufferOffsets(m_data);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->saveIov(iov, count, buffer);
 }
 
-bool RagePhoto::setData(RagePhotoData *rp_data, bool takeCopy)
+size_t ragephotodata_saveiov(RagePhotoData *rp_data, RagePhotoIovec *iov, size_t count, char *buffer)
 {
-    if (m_data == rp_data)
-        return true;
+    return RagePhoto::saveIov(iov, count, buffer, rp_data->photoFormat, rp_data);
+}
 
-    if (takeCopy) {
-        clear(m_data);
-        m_data->photoFormat = rp_data->photoFormat;
+size_t ragephoto_saveiovf(ragephoto_t instance, RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->saveIov(iov, count, buffer, photoFormat);
+}
 
-        if (rp_data->header) {
-            const size_t headerSize = strlen(rp_data->header) + 1;
-            m_data->header = static_cast<char*>(malloc(headerSize));
-            if (!m_data->header)
-                return false;
-            memcpy(m_data->header, rp_data->header, headerSize);
-            m_data->headerSum = rp_data->headerSum;
-            m_data->headerSum2 = rp_data->headerSum2;
-        }
+size_t ragephotodata_saveiovf(RagePhotoData *rp_data, RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat)
+{
+    return RagePhoto::saveIov(iov, count, buffer, photoFormat, rp_data);
+}
 
-        if (rp_data->jpeg) {
-            m_data->jpeg = static_cast<char*>(malloc(rp_data->jpegSize));
-            if (!m_data->jpeg)
-                return false;
-            memcpy(m_data->jpeg, rp_data->jpeg, rp_data->jpegSize);
-            m_data->jpegSize = rp_data->jpegSize;
-            m_data->jpegBuffer = rp_data->jpegBuffer;
-        }
+bool ragephoto_savefile(ragephoto_t instance, const char *filename)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->saveFile(filename);
+}
 
-        if (rp_data->json) {
-            const size_t jsonSize = strlen(rp_data->json) + 1;
-            m_data->json = static_cast<char*>(malloc(jsonSize));
-            if (!m_data->json)
-                return false;
-            memcpy(m_data->json, rp_data->json, jsonSize);
-            m_data->jsonBuffer = rp_data->jsonBuffer;
-        }
+bool ragephoto_savefilef(ragephoto_t instance, const char *filename, uint32_t photoFormat)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->saveFile(filename, photoFormat);
+}
 
-        if (rp_data->title) {
-            const size_t titleSize = strlen(rp_data->title) + 1;
-            m_data->title = static_cast<char*>(malloc(titleSize));
-            if (!m_data->title)
-                return false;
-            memcpy(m_data->title, rp_data->title, titleSize);
-            m_data->titlBuffer = rp_data->titlBuffer;
-        }
+void ragephoto_setbufferdefault(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setBufferDefault();
+}
 
-        if (rp_data->description) {
-            const size_t descriptionSize = strlen(rp_data->description) + 1;
-            m_data->description = static_cast<char*>(malloc(descriptionSize));
-            if (!m_data->description)
-                return false;
-            memcpy(m_data->description, rp_data->description, descriptionSize);
-            m_data->descBuffer = rp_data->descBuffer;
-        }
+void ragephotodata_setbufferdefault(RagePhotoData *rp_data)
+{
+    RagePhoto::setBufferDefault(rp_data);
+}
 
-        setBufferOffsets(m_data);
-    }
-    else {
-        free(m_data->jpeg);
-        free(m_data->description);
-        free(m_data->json);
-        free(m_data->header);
-        free(m_data->title);
-        free(m_data);
+void ragephoto_setbufferoffsets(ragephoto_t instance)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setBufferOffsets();
+}
 
-        m_data = rp_data;
-    }
+void ragephotodata_setbufferoffsets(RagePhotoData *rp_data)
+{
+    RagePhoto::setBufferOffsets(rp_data);
+}
 
-    return true;
+void ragephoto_setlibraryflag(RagePhotoLibraryFlag flag, bool state)
+{
+    RagePhoto::setLibraryFlag(flag, state);
 }
 
-void RagePhoto::setDescription(const char *description, uint32_t bufferSize)
+void ragephoto_setsizelimits(const RagePhotoSizeLimits *limits)
 {
-    if (!writeDataChar(description, &m_data->description)) {
-        m_data->error = Error::DescMallocError; // 31
-        return;
-    }
-    if (bufferSize != 0) {
-        m_data->descBuffer = bufferSize;
-        setBufferOffsets(m_data);
-    }
-    m_data->error = Error::NoError; // 255
+    RagePhoto::setSizeLimits(limits);
 }
 
-void RagePhoto::setFormat(uint32_t photoFormat)
+void ragephoto_getsizelimits(RagePhotoSizeLimits *limits)
 {
-    m_data->photoFormat = photoFormat;
+    RagePhoto::sizeLimits(limits);
 }
 
-void RagePhoto::setHeader(const char *header, uint32_t headerSum, uint32_t headerSum2)
+void ragephoto_setlibraryallocator(const RagePhotoAllocator *allocator)
 {
-    if (!writeDataChar(header, &m_data->header)) {
-        m_data->error = Error::HeaderMallocError; // 4
-        return;
-    }
-    m_data->headerSum = headerSum;
-    m_data->headerSum2 = headerSum2;
-    m_data->error = Error::NoError; // 255
+    RagePhoto::setLibraryAllocator(allocator);
 }
 
-bool RagePhoto::setJpeg(const char *data, uint32_t size, uint32_t bufferSize)
+void ragephoto_setallocator(ragephoto_t instance, const RagePhotoAllocator *allocator)
 {
-    if (data && size) {
-        if (m_data->jpeg) {
-            if (m_data->jpegSize > size) {
-                char *t_photoData = static_cast<char*>(realloc(m_data->jpeg, size));
-                if (!t_photoData) {
-                    m_data->error = Error::PhotoMallocError; // 16
-                    return false;
-                }
-                m_data->jpeg = t_photoData;
-                memcpy(m_data->jpeg, data, size);
-                m_data->jpegSize = size;
-            }
-            else if (m_data->jpegSize < size) {
-                char *t_photoData = static_cast<char*>(malloc(size));
-                if (!t_photoData) {
-                    m_data->error = Error::PhotoMallocError; // 16
-                    return false;
-                }
-                free(m_data->jpeg);
-                m_data->jpeg = t_photoData;
-                memcpy(m_data->jpeg, data, size);
-                m_data->jpegSize = size;
-            }
-            else {
-                memcpy(m_data->jpeg, data, size);
-            }
-        }
-        else {
-            m_data->jpeg = static_cast<char*>(malloc(size));
-            if (!m_data->jpeg) {
-                m_data->error = Error::PhotoMallocError; // 16
-                return false;
-            }
-            memcpy(m_data->jpeg, data, size);
-            m_data->jpegSize = size;
-        }
-    }
-    else if (m_data->jpeg) {
-        free(m_data->jpeg);
-        m_data->jpeg = nullptr;
-        m_data->jpegSize = 0;
-    }
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setAllocator(allocator);
+}
 
-    if (bufferSize != 0) {
-        m_data->jpegBuffer = bufferSize;
-        setBufferOffsets(m_data);
-    }
+bool ragephoto_setphotodata(ragephoto_t instance, RagePhotoData *rp_data)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->setData(rp_data, false);
+}
 
-    m_data->error = Error::NoError; // 255
-    return true;
+bool ragephoto_setphotodatac(ragephoto_t instance, RagePhotoData *rp_data)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->setData(rp_data, true);
 }
 
-bool RagePhoto::setJpeg(const std::string &data, uint32_t bufferSize)
+bool ragephoto_copyphotodata(ragephoto_t instance, ragephoto_t source)
 {
-    return setJpeg(data.data(), static_cast<uint32_t>(data.size()), bufferSize);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->copyData(*reinterpret_cast<RagePhoto*>(source));
 }
 
-void RagePhoto::setJson(const char *json, uint32_t bufferSize)
+void ragephoto_setphotodesc(ragephoto_t instance, const char *description, uint32_t bufferSize)
 {
-    if (!writeDataChar(json, &m_data->json)) {
-        m_data->error = Error::JsonMallocError; // 21
-        return;
-    }
-    if (bufferSize != 0) {
-        m_data->jsonBuffer = bufferSize;
-        setBufferOffsets(m_data);
-    }
-    m_data->error = Error::NoError; // 255
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setDescription(description, bufferSize);
+}
+
+void ragephoto_setphotodescl(ragephoto_t instance, const char *description, size_t length, uint32_t bufferSize)
+{
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setDescription(description, length, bufferSize);
 }
 
-void RagePhoto::setLibraryFlag(RagePhotoLibraryFlag flag, bool state)
+void ragephoto_setphotoformat(ragephoto_t instance, uint32_t photoFormat)
 {
-    state ? (libraryflags |= flag) : (libraryflags &= ~flag);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setFormat(photoFormat);
 }
 
-void RagePhoto::setTitle(const char *title, uint32_t bufferSize)
+bool ragephoto_setphotojpeg(ragephoto_t instance, const char *data, uint32_t size, uint32_t bufferSize)
 {
-    if (!writeDataChar(title, &m_data->title)) {
-        m_data->error = Error::TitleMallocError; // 26
-        return;
-    }
-    if (bufferSize != 0) {
-        m_data->titlBuffer = bufferSize;
-        setBufferOffsets(m_data);
-    }
-    m_data->error = Error::NoError; // 255
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    return ragePhoto->setJpeg(data, size, bufferSize);
 }
 
-#ifdef LIBRAGEPHOTO_CXX_C
-ragephoto_t ragephoto_open()
+void ragephoto_adoptphotojpeg(ragephoto_t instance, char *data, uint32_t size, uint32_t bufferSize)
 {
-    try {
-        return reinterpret_cast<ragephoto_t>(new RagePhoto);
-    }
-    catch (const std::exception &exception) {
-        std::cerr << "[libragephoto] Exception thrown at ragephoto_open: " << exception.what() << std::endl;
-        return nullptr;
-    }
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->adoptJpeg(data, size, bufferSize);
 }
 
-void ragephoto_addparser(ragephoto_t instance, RagePhotoFormatParser *rp_parser)
+void ragephoto_setphotojson(ragephoto_t instance, const char *json, uint32_t bufferSize)
 {
     RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    try {
-        ragePhoto->addParser(rp_parser);
-    }
-    catch (const std::exception &exception) {
-        std::cerr << "[libragephoto] Exception thrown at ragephoto_addparser: " << exception.what() << std::endl;
-    }
+    ragePhoto->setJson(json, bufferSize);
 }
 
-void ragephoto_clear(ragephoto_t instance)
+void ragephoto_setphotojsonl(ragephoto_t instance, const char *json, size_t length, uint32_t bufferSize)
 {
     RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->clear();
+    ragePhoto->setJson(json, length, bufferSize);
 }
 
-void ragephotodata_clear(RagePhotoData *rp_data)
+void ragephoto_adoptphotojson(ragephoto_t instance, char *json, uint32_t bufferSize)
 {
-    RagePhoto::clear(rp_data);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->adoptJson(json, bufferSize);
 }
 
-bool ragephoto_load(ragephoto_t instance, const char *data, size_t size)
+void ragephoto_setphotoheader(ragephoto_t instance, const char *header, uint32_t headerSum)
 {
     RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->load(data, size);
+    ragePhoto->setHeader(header, headerSum);
 }
 
-bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t size)
+void ragephoto_setphotoheader2(ragephoto_t instance, const char *header, uint32_t headerSum, uint32_t headerSum2)
 {
-    return RagePhoto::load(data, size, rp_data, rp_parser);
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    ragePhoto->setHeader(header, headerSum, headerSum2);
 }
 
-bool ragephoto_loadfile(ragephoto_t instance, const char *filename)
+void ragephoto_setphototitle(ragephoto_t instance, const char *title, uint32_t bufferSize)
 {
     RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->loadFile(filename);
+    ragePhoto->setTitle(title, bufferSize);
 }
 
-int32_t ragephoto_error(ragephoto_t instance)
+void ragephoto_setphototitlel(ragephoto_t instance, const char *title, size_t length, uint32_t bufferSize)
 {
     RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->error();
+    ragePhoto->setTitle(title, length, bufferSize);
 }
 
-uint32_t ragephoto_defpbuf_gta5()
+void ragephoto_close(ragephoto_t instance)
 {
-    return RagePhoto::DEFAULT_GTA5_PHOTOBUFFER;
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    delete ragePhoto;
 }
 
-uint32_t ragephoto_defpbuf_rdr2()
+ragephoto_t ragephoto_acquire()
 {
-    return RagePhoto::DEFAULT_RDR2_PHOTOBUFFER;
+    try {
+        return reinterpret_cast<ragephoto_t>(RagePhoto::acquire());
+    }
+    catch (const std::exception &exception) {
+        std::cerr << "[libragephoto] Exception thrown at ragephoto_acquire: " << exception.what() << std::endl;
+        return nullptr;
+    }
 }
 
-uint32_t ragephoto_format_gta5()
+void ragephoto_release(ragephoto_t instance)
 {
-    return RagePhoto::GTA5;
+    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
+    RagePhoto::release(ragePhoto);
 }
 
-uint32_t ragephoto_format_rdr2()
+const char* ragephoto_version()
 {
-    return RagePhoto::RDR2;
+    return RAGEPHOTO_VERSION;
 }
+#endif
+/* END OF RAGEPHOTO CLASS */
 
-RagePhotoData* ragephoto_getphotodata(ragephoto_t instance)
+/* BEGIN OF RAGEPHOTO VIEW CLASS */
+ragephoto::photo_view::photo_view()
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->data();
+    memset(&m_view, 0, sizeof(RagePhotoView));
 }
 
-const char* ragephoto_getphotodesc(ragephoto_t instance)
+inline bool loadView(const char *data, size_t length, RagePhotoView *rp_view)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->description();
+    memset(rp_view, 0, sizeof(RagePhotoView));
+
+    bool ok;
+    size_t pos = 0;
+    rp_view->photoFormat = viewUInt32(data, &pos, length, &ok);
+    if (!ok) {
+        rp_view->error = RagePhoto::Error::NoFormatIdentifier; // 1
+        return false;
+    }
+
+    if (rp_view->photoFormat != RagePhoto::PhotoFormat::GTA5 && rp_view->photoFormat != RagePhoto::PhotoFormat::RDR2) {
+        rp_view->error = RagePhoto::Error::IncompatibleFormat; // 2
+        return false;
+    }
+
+    if (length < 260) {
+        rp_view->error = RagePhoto::Error::IncompleteHeader; // 3
+        return false;
+    }
+    rp_view->header = &data[4];
+
+    const RagePhotoLayout *layout = photoLayout(rp_view->photoFormat);
+    uint32_t fields[LAYOUT_FIELD_CONSTANT]{};
+    const bool isLayoutLoaded = loadLayout(layout, data, length, fields, &rp_view->error);
+    rp_view->headerSum = fields[LAYOUT_FIELD_HEADERSUM];
+    rp_view->headerSum2 = fields[LAYOUT_FIELD_HEADERSUM2];
+    rp_view->endOfFile = fields[LAYOUT_FIELD_EOF];
+    rp_view->jsonOffset = fields[LAYOUT_FIELD_JSONOFFSET];
+    rp_view->titlOffset = fields[LAYOUT_FIELD_TITLOFFSET];
+    rp_view->descOffset = fields[LAYOUT_FIELD_DESCOFFSET];
+    rp_view->jpegBuffer = fields[LAYOUT_FIELD_JPEGBUFFER];
+    rp_view->jpegSize = fields[LAYOUT_FIELD_JPEGSIZE];
+    if (!isLayoutLoaded)
+        return false;
+    pos = layout->size;
+
+    if (length - pos < rp_view->jpegSize) {
+        rp_view->error = RagePhoto::Error::PhotoReadError; // 17
+        return false;
+    }
+    rp_view->jpeg = &data[pos];
+    pos += rp_view->jpegSize;
+
+    pos += rp_view->jpegBuffer - rp_view->jpegSize;
+    const char **sectionData[3] = {&rp_view->json, &rp_view->title, &rp_view->description};
+    uint32_t *sectionBuffer[3] = {&rp_view->jsonBuffer, &rp_view->titlBuffer, &rp_view->descBuffer};
+    const uint32_t sectionMarker[3] = {RAGEPHOTO_MARKER_JSON, RAGEPHOTO_MARKER_TITL, RAGEPHOTO_MARKER_DESC};
+    const int32_t sectionError[3] = {RagePhoto::Error::IncompleteJsonMarker, RagePhoto::Error::IncompleteTitleMarker, RagePhoto::Error::IncompleteDescMarker}; // 18, 23, 28
+    for (size_t i = 0; i < 3; i++) {
+        if (!loadSectionHead(data, length, &pos, sectionMarker[i], sectionError[i], sectionBuffer[i], &rp_view->error))
+            return false;
+        // Read error follows the incomplete buffer error
+        if (length - pos < *sectionBuffer[i]) {
+            rp_view->error = sectionError[i] + 4;
+            return false;
+        }
+        *sectionData[i] = &data[pos];
+        pos += *sectionBuffer[i];
+    }
+
+    if (pos > length || length - pos < 4) {
+        rp_view->error = RagePhoto::Error::IncompleteJendMarker; // 33
+        return false;
+    }
+    if (parserUInt32(&data[pos]) != RAGEPHOTO_MARKER_JEND) {
+        rp_view->error = RagePhoto::Error::IncorrectJendMarker; // 34
+        return false;
+    }
+
+    rp_view->error = RagePhoto::Error::NoError; // 255
+    return true;
 }
 
-uint32_t ragephoto_getphotoformat(ragephoto_t instance)
+bool ragephoto::photo_view::load(const char *data, size_t length, RagePhotoView *rp_view)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->format();
+    if (!loadView(data, length, rp_view))
+        return false;
+    if (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN) {
+        rp_view->jpegSign = (UINT64_C(0x100000000000000) | joaatFromInitial(rp_view->jpeg, rp_view->jpegSize, signInitial(rp_view->photoFormat)));
+        rp_view->signFormat = rp_view->photoFormat;
+    }
+    return true;
 }
 
-const char* ragephoto_getphotojpeg(ragephoto_t instance)
+bool ragephoto::photo_view::load(const char *data, size_t size)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->jpegData();
+    const bool isLoaded = load(data, size, &m_view);
+    // Decoded once here, so reading the header of a const view writes nothing
+    char photoHeader[512];
+    if (decodeHeader(m_view.header, photoHeader, sizeof(photoHeader)))
+        m_header = photoHeader;
+    else
+        m_header.clear();
+    return isLoaded;
 }
 
-const char* ragephoto_getphotojson(ragephoto_t instance)
+bool ragephoto::photo_view::load(const std::string &data)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->json();
+    return load(data.data(), data.size());
 }
 
-const char* ragephoto_getphotoheader(ragephoto_t instance)
+const RagePhotoView* ragephoto::photo_view::data() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->header();
+    return &m_view;
 }
 
-uint64_t ragephoto_getphotosign(ragephoto_t instance)
+int32_t ragephoto::photo_view::error() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->jpegSign();
+    return m_view.error;
 }
 
-uint64_t ragephoto_getphotosignf(ragephoto_t instance, uint32_t photoFormat)
+uint32_t ragephoto::photo_view::format() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->jpegSign(photoFormat);
+    return m_view.photoFormat;
 }
 
-void ragephoto_getphotosigns(ragephoto_t instance, char *data, size_t size)
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+const std::string_view ragephoto::photo_view::jpeg_view() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    snprintf(data, size, "%" PRIu64, ragePhoto->jpegSign());
+    if (m_view.jpeg)
+        return std::string_view(m_view.jpeg, m_view.jpegSize);
+    return std::string_view();
 }
+#endif
 
-void ragephoto_getphotosignsf(ragephoto_t instance, char *data, size_t size, uint32_t photoFormat)
+const char* ragephoto::photo_view::jpegData() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    snprintf(data, size, "%" PRIu64, ragePhoto->jpegSign(photoFormat));
+    if (m_view.jpeg)
+        return m_view.jpeg;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
 }
 
-uint64_t ragephotodata_getphotosign(RagePhotoData *rp_data)
+uint64_t ragephoto::photo_view::jpegSign(uint32_t photoFormat, const RagePhotoView *rp_view)
 {
-    return RagePhoto::jpegSign(rp_data);
+    if (rp_view->jpeg) {
+        if (rp_view->signFormat != 0 && rp_view->signFormat == photoFormat)
+            return rp_view->jpegSign;
+        else if (photoFormat == RagePhoto::PhotoFormat::GTA5)
+            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_view->jpeg, rp_view->jpegSize, RagePhoto::SignInitials::SIGTA5));
+        else if (photoFormat == RagePhoto::PhotoFormat::RDR2)
+            return (UINT64_C(0x100000000000000) | joaatFromInitial(rp_view->jpeg, rp_view->jpegSize, RagePhoto::SignInitials::SIRDR2));
+    }
+    return 0;
 }
 
-uint64_t ragephotodata_getphotosignf(RagePhotoData *rp_data, uint32_t photoFormat)
+uint64_t ragephoto::photo_view::jpegSign(uint32_t photoFormat) const
 {
-    return RagePhoto::jpegSign(photoFormat, rp_data);
+    return jpegSign(photoFormat, &m_view);
 }
 
-uint32_t ragephoto_getphotosize(ragephoto_t instance)
+uint64_t ragephoto::photo_view::jpegSign() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->jpegSize();
+    return jpegSign(m_view.photoFormat, &m_view);
 }
 
-const char* ragephoto_getphototitle(ragephoto_t instance)
+uint32_t ragephoto::photo_view::jpegSize() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->title();
+    if (m_view.jpeg)
+        return m_view.jpegSize;
+    return 0;
 }
 
-size_t ragephoto_getsavesize(ragephoto_t instance)
+const char* ragephoto::photo_view::description() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->saveSize();
+    if (m_view.description)
+        return m_view.description;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
 }
 
-size_t ragephotodata_getsavesize(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser)
+size_t ragephoto::photo_view::descriptionSize() const
 {
-    return RagePhoto::saveSize(rp_data, rp_parser);
+    if (!m_view.description)
+        return 0;
+    const void *end = memchr(m_view.description, '\0', m_view.descBuffer);
+    return end ? static_cast<const char*>(end) - m_view.description : m_view.descBuffer;
 }
 
-size_t ragephoto_getsavesizef(ragephoto_t instance, uint32_t photoFormat)
+bool ragephoto::photo_view::header(const RagePhotoView *rp_view, char *data, size_t size)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->saveSize(photoFormat);
+    return decodeHeader(rp_view->header, data, size);
 }
 
-size_t ragephotodata_getsavesizef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, uint32_t photoFormat)
+const char* ragephoto::photo_view::header() const
 {
-    return RagePhoto::saveSize(photoFormat, rp_data, rp_parser);
+    if (m_view.header)
+        return m_header.c_str();
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
 }
 
-bool ragephoto_save(ragephoto_t instance, char *data)
+const char* ragephoto::photo_view::json() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->save(data);
+    if (m_view.json)
+        return m_view.json;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
 }
 
-bool ragephotodata_save(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, char *data)
+size_t ragephoto::photo_view::jsonSize() const
 {
-    return RagePhoto::save(data, rp_data->photoFormat, rp_data, rp_parser);
+    if (!m_view.json)
+        return 0;
+    const void *end = memchr(m_view.json, '\0', m_view.jsonBuffer);
+    return end ? static_cast<const char*>(end) - m_view.json : m_view.jsonBuffer;
 }
 
-bool ragephoto_savef(ragephoto_t instance, char *data, uint32_t photoFormat)
+const char* ragephoto::photo_view::title() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->save(data, photoFormat);
+    if (m_view.title)
+        return m_view.title;
+    return (libraryflags & RAGEPHOTO_FLAG_LEGACY_NULL_RETURN) ? nullptr : nullchar;
 }
 
-bool ragephotodata_savef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, char *data, uint32_t photoFormat)
+size_t ragephoto::photo_view::titleSize() const
 {
-    return RagePhoto::save(data, photoFormat, rp_data, rp_parser);
+    if (!m_view.title)
+        return 0;
+    const void *end = memchr(m_view.title, '\0', m_view.titlBuffer);
+    return end ? static_cast<const char*>(end) - m_view.title : m_view.titlBuffer;
 }
 
-bool ragephoto_savefile(ragephoto_t instance, const char *filename)
+#ifdef LIBRAGEPHOTO_CXX_C
+bool ragephotoview_load(RagePhotoView *rp_view, const char *data, size_t size)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->saveFile(filename);
+    return ragephoto::photo_view::load(data, size, rp_view);
 }
 
-bool ragephoto_savefilef(ragephoto_t instance, const char *filename, uint32_t photoFormat)
+bool ragephotoview_getheader(const RagePhotoView *rp_view, char *data, size_t size)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->saveFile(filename, photoFormat);
+    return ragephoto::photo_view::header(rp_view, data, size);
 }
 
-void ragephoto_setbufferdefault(ragephoto_t instance)
+uint64_t ragephotoview_getphotosign(const RagePhotoView *rp_view)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setBufferDefault();
+    return ragephoto::photo_view::jpegSign(rp_view->photoFormat, rp_view);
 }
 
-void ragephotodata_setbufferdefault(RagePhotoData *rp_data)
+uint64_t ragephotoview_getphotosignf(const RagePhotoView *rp_view, uint32_t photoFormat)
 {
-    RagePhoto::setBufferDefault(rp_data);
+    return ragephoto::photo_view::jpegSign(photoFormat, rp_view);
 }
+#endif
+/* END OF RAGEPHOTO VIEW CLASS */
 
-void ragephoto_setbufferoffsets(ragephoto_t instance)
+/* BEGIN OF RAGEPHOTO PARSER CLASS */
+ragephoto::photo_parser::photo_parser(photo *ragePhoto, uint8_t sections)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setBufferOffsets();
+    init(ragePhoto->data(), sections, &m_parser);
 }
 
-void ragephotodata_setbufferoffsets(RagePhotoData *rp_data)
+ragephoto::photo_parser::photo_parser(RagePhotoData *rp_data, uint8_t sections)
 {
-    RagePhoto::setBufferOffsets(rp_data);
+    init(rp_data, sections, &m_parser);
 }
 
-void ragephoto_setlibraryflag(RagePhotoLibraryFlag flag, bool state)
+void ragephoto::photo_parser::init(RagePhotoData *rp_data, uint8_t sections, RagePhotoParser *rp_stream)
 {
-    RagePhoto::setLibraryFlag(flag, state);
+    // Avoid data conflicts
+    if (libraryflags & RAGEPHOTO_FLAG_RETAIN_CAPACITY)
+        RagePhoto::reset(rp_data);
+    else
+        RagePhoto::clear(rp_data);
+
+    memset(rp_stream, 0, sizeof(RagePhotoParser));
+    rp_stream->data = rp_data;
+    rp_stream->fieldSize = 4;
+    rp_stream->sections = (sections | Section::Header) & Section::All;
+    rp_stream->signing = (libraryflags & RAGEPHOTO_FLAG_LOAD_SIGN) && (rp_stream->sections & Section::Jpeg);
+    rp_stream->state = PARSER_STATE_FORMAT;
 }
 
-bool ragephoto_setphotodata(ragephoto_t instance, RagePhotoData *rp_data)
+ragephoto::photo_parser::Status ragephoto::photo_parser::feed(const char *data, size_t size, RagePhotoParser *rp_stream)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->setData(rp_data, false);
+    size_t pos = 0;
+    while (rp_stream->state < PARSER_STATE_FINISHED) {
+        if (rp_stream->fieldPos != rp_stream->fieldSize) {
+            if (pos == size)
+                return Status::Continue;
+            size_t chunkSize = rp_stream->fieldSize - rp_stream->fieldPos;
+            if (chunkSize > size - pos)
+                chunkSize = size - pos;
+            char *target = parserTarget(rp_stream);
+            if (target && rp_stream->signing && rp_stream->state == PARSER_STATE_JPEG)
+                rp_stream->data->jpegSign = joaatCopy(static_cast<uint32_t>(rp_stream->data->jpegSign), &target[rp_stream->fieldPos], &data[pos], chunkSize);
+            else if (target)
+                memcpy(&target[rp_stream->fieldPos], &data[pos], chunkSize);
+            pos += chunkSize;
+            rp_stream->fieldPos += static_cast<uint32_t>(chunkSize);
+            if (rp_stream->fieldPos != rp_stream->fieldSize)
+                return Status::Continue;
+        }
+        if (!parserNext(rp_stream)) {
+            rp_stream->state = PARSER_STATE_ERROR;
+            return Status::Error;
+        }
+    }
+    return (rp_stream->state == PARSER_STATE_FINISHED) ? Status::Finished : Status::Error;
 }
 
-bool ragephoto_setphotodatac(ragephoto_t instance, RagePhotoData *rp_data)
+ragephoto::photo_parser::Status ragephoto::photo_parser::feed(const char *data, size_t size)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->setData(rp_data, true);
+    return feed(data, size, &m_parser);
 }
 
-void ragephoto_setphotodesc(ragephoto_t instance, const char *description, uint32_t bufferSize)
+ragephoto::photo_parser::Status ragephoto::photo_parser::feed(const std::string &data)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setDescription(description, bufferSize);
+    return feed(data.data(), data.size(), &m_parser);
 }
 
-void ragephoto_setphotoformat(ragephoto_t instance, uint32_t photoFormat)
+bool ragephoto::photo_parser::finish(RagePhotoParser *rp_stream)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setFormat(photoFormat);
+    if (rp_stream->state == PARSER_STATE_FINISHED)
+        return true;
+    else if (rp_stream->state == PARSER_STATE_ERROR)
+        return false;
+
+    RagePhotoData *rp_data = rp_stream->data;
+    char **section = nullptr;
+    uint32_t *capacity = nullptr;
+    if (rp_stream->state == PARSER_STATE_JPEG) {
+        section = &rp_data->jpeg;
+        capacity = &rp_data->jpegCapacity;
+    }
+    else if (rp_stream->state == PARSER_STATE_JSON) {
+        section = &rp_data->json;
+        capacity = &rp_data->jsonCapacity;
+    }
+    else if (rp_stream->state == PARSER_STATE_TITLE) {
+        section = &rp_data->title;
+        capacity = &rp_data->titlCapacity;
+    }
+    else if (rp_stream->state == PARSER_STATE_DESC) {
+        section = &rp_data->description;
+        capacity = &rp_data->descCapacity;
+    }
+    if (section) {
+        freeBuffer(rp_data, *section);
+        *section = nullptr;
+        *capacity = 0;
+    }
+    rp_data->error = parserIncompleteError[rp_stream->state];
+    rp_stream->state = PARSER_STATE_ERROR;
+    return false;
 }
 
-bool ragephoto_setphotojpeg(ragephoto_t instance, const char *data, uint32_t size, uint32_t bufferSize)
+bool ragephoto::photo_parser::finish()
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    return ragePhoto->setJpeg(data, size, bufferSize);
+    return finish(&m_parser);
 }
 
-void ragephoto_setphotojson(ragephoto_t instance, const char *json, uint32_t bufferSize)
+uint8_t ragephoto::photo_parser::completed() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setJson(json, bufferSize);
+    return m_parser.completed;
 }
 
-void ragephoto_setphotoheader(ragephoto_t instance, const char *header, uint32_t headerSum)
+const RagePhotoParser* ragephoto::photo_parser::data() const
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setHeader(header, headerSum);
+    return &m_parser;
 }
 
-void ragephoto_setphotoheader2(ragephoto_t instance, const char *header, uint32_t headerSum, uint32_t headerSum2)
+#ifdef LIBRAGEPHOTO_CXX_C
+void ragephoto_parser_init(RagePhotoParser *rp_stream, ragephoto_t instance, uint8_t sections)
 {
     RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setHeader(header, headerSum, headerSum2);
+    ragephoto::photo_parser::init(ragePhoto->data(), sections, rp_stream);
 }
 
-void ragephoto_setphototitle(ragephoto_t instance, const char *title, uint32_t bufferSize)
+void ragephotodata_parser_init(RagePhotoParser *rp_stream, RagePhotoData *rp_data, uint8_t sections)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    ragePhoto->setTitle(title, bufferSize);
+    ragephoto::photo_parser::init(rp_data, sections, rp_stream);
 }
 
-void ragephoto_close(ragephoto_t instance)
+RagePhotoParserStatus ragephoto_parser_feed(RagePhotoParser *rp_stream, const char *data, size_t size)
 {
-    RagePhoto *ragePhoto = reinterpret_cast<RagePhoto*>(instance);
-    delete ragePhoto;
+    return static_cast<RagePhotoParserStatus>(ragephoto::photo_parser::feed(data, size, rp_stream));
 }
 
-const char* ragephoto_version()
+bool ragephoto_parser_finish(RagePhotoParser *rp_stream)
 {
-    return RAGEPHOTO_VERSION;
+    return ragephoto::photo_parser::finish(rp_stream);
 }
 #endif
-/* END OF RAGEPHOTO CLASS */
+/* END OF RAGEPHOTO PARSER CLASS */
+
+/* BEGIN OF RAGEPHOTO BATCH FUNCTIONS */
+std::vector<std::unique_ptr<ragephoto::photo>> ragephoto::batch_load(const std::vector<std::string> &filenames, const RagePhotoBatchOptions &options)
+{
+    std::vector<std::unique_ptr<photo>> photos;
+    std::vector<photo*> photoPointers;
+    std::vector<const char*> filenamePointers;
+    photos.reserve(filenames.size());
+    photoPointers.reserve(filenames.size());
+    filenamePointers.reserve(filenames.size());
+    for (const std::string &filename : filenames) {
+        photos.emplace_back(new photo);
+        photoPointers.push_back(photos.back().get());
+        filenamePointers.push_back(filename.c_str());
+    }
+    loadBatch(photoPointers.data(), filenamePointers.data(), filenames.size(), options);
+    return photos;
+}
+
+#ifdef LIBRAGEPHOTO_CXX_C
+size_t ragephoto_loadmany(ragephoto_t *instances, const char **filenames, size_t count, const RagePhotoBatchOptions *options)
+{
+    const RagePhotoBatchOptions defaultOptions = RagePhotoBatchOptions();
+    return loadBatch(reinterpret_cast<RagePhoto**>(instances), filenames, count, options ? *options : defaultOptions);
+}
+#endif
+/* END OF RAGEPHOTO BATCH FUNCTIONS */
@@ -53,6 +53,24 @@ LIBRAGEPHOTO_C_PUBLIC ragephoto_t ragephoto_open();
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_addparser(ragephoto_t instance, RagePhotoFormatParser *rp_parser);
 
+/** Registers a custom defined RagePhotoFormatParser for all instances.
+*
+* Parsers added to an instance take precedence, the GTA V and RDR 2 formats can't be overridden.
+* Registering a Photo Format again replaces its parser, lookups are lock-free.
+* Replaced registry tables are freed by the first register or unregister call that runs while no lookup is running.
+* \relates RagePhotoInstance
+* \param rp_parser Parser to register
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_registerparser(const RagePhotoFormatParser *rp_parser);
+
+/** Unregisters the custom defined RagePhotoFormatParser of a Photo Format.
+*
+* Replaced registry tables are freed as with ragephoto_registerparser().
+* \relates RagePhotoInstance
+* \param photoFormat Photo Format to unregister
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_unregisterparser(uint32_t photoFormat);
+
 /** Resets the Data object to default values.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -65,6 +83,22 @@ LIBRAGEPHOTO_C_PUBLIC void ragephoto_clear(ragephoto_t instance);
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephotodata_clear(RagePhotoData *rp_data);
 
+/** Resets the Data object to default values, keeping the section buffers for the next load.
+*
+* Kept section buffers are hidden until the next load reuses them, the sections are empty as in a new object, see #RAGEPHOTO_FLAG_RETAIN_CAPACITY.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_reset(ragephoto_t instance);
+
+/** Resets the Data object to default values, keeping the section buffers for the next load.
+*
+* Kept section buffers are hidden until the next load reuses them, the sections are empty as in a new object, see #RAGEPHOTO_FLAG_RETAIN_CAPACITY.
+* \memberof RagePhotoData
+* \param rp_data Data object
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephotodata_reset(RagePhotoData *rp_data);
+
 /** Loads a Photo from a const char*.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -82,13 +116,80 @@ LIBRAGEPHOTO_C_PUBLIC bool ragephoto_load(ragephoto_t instance, const char *data
 */
 LIBRAGEPHOTO_C_PUBLIC bool ragephotodata_load(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t size);
 
+/** Loads the metadata of a Photo from a const char*.
+*
+* The JPEG marker and sizes are validated but the JPEG data is skipped, only \p jpegSize is recorded.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param data Photo data
+* \param size Photo data size
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_loadmeta(ragephoto_t instance, const char *data, size_t size);
+
+/** Loads the metadata of a Photo from a const char*.
+*
+* The JPEG marker and sizes are validated but the JPEG data is skipped, only \p jpegSize is recorded.
+* \memberof RagePhotoData
+* \param rp_data Data object
+* \param rp_parser Parser array
+* \param data Photo data
+* \param size Photo data size
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephotodata_loadmeta(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, const char *data, size_t size);
+
 /** Loads a Photo from a file.
+*
+* On POSIX systems the file is memory-mapped, see #RAGEPHOTO_FLAG_DISABLE_MMAP.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
 * \param filename File to load
 */
 LIBRAGEPHOTO_C_PUBLIC bool ragephoto_loadfile(ragephoto_t instance, const char *filename);
 
+/** Loads the metadata of a Photo from a file.
+*
+* Only the header and the JSON, Title and Description sections are read from the file, the JPEG data is skipped.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param filename File to load
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_loadmetafile(ragephoto_t instance, const char *filename);
+
+/** Loads the metadata of a Photo from a file descriptor.
+*
+* Only the header and the JSON, Title and Description sections up to the End Of File offset are read, the JPEG data is skipped.
+* On POSIX systems the sections are read with pread and the file position is kept, the descriptor stays open.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param fd File descriptor to load from
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_loadmetafd(ragephoto_t instance, int fd);
+
+/** Validates the structure of a Photo without allocating.
+*
+* Every marker and buffer length is checked like when loading, the header offsets are compared with the section layout.
+* The header is decoded into a stack buffer like ragephotoview_getheader() does.
+* Returns true when the Photo is readable and no inconsistencies were found.
+* \param data Photo data
+* \param size Photo data size
+* \param rp_validation Validation report
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_validate(const char *data, size_t size, RagePhotoValidation *rp_validation);
+
+/** Loads multiple Photos from files in parallel.
+*
+* The files are distributed over a pool of worker threads, each worker reuses one read buffer for all files it loads.
+* On Linux each worker keeps multiple opens and reads in flight with io_uring when available, see #RAGEPHOTO_FLAG_DISABLE_IO_URING.
+* Errors are reported per file, a file which can't be accessed sets #RAGEPHOTO_ERROR_UNINITIALISED.
+* \memberof RagePhotoInstance
+* \param instances \p ragephoto_t instance array, one instance for each file
+* \param filenames File array to load
+* \param count File count
+* \param options Batch load options, NULL for the defaults
+* \return Count of Photos loaded successfully
+*/
+LIBRAGEPHOTO_C_PUBLIC size_t ragephoto_loadmany(ragephoto_t *instances, const char **filenames, size_t count, const RagePhotoBatchOptions *options);
+
 /** Returns the last error occurred.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -121,6 +222,16 @@ LIBRAGEPHOTO_C_PUBLIC uint32_t ragephoto_format_rdr2();
 */
 LIBRAGEPHOTO_C_PUBLIC RagePhotoData* ragephoto_getphotodata(ragephoto_t instance);
 
+/** Releases ownership of the internal Data object and replaces it with an empty one.
+*
+* The released object is allocated with malloc, pass it to ragephoto_setphotodata() or free it
+* with ragephotodata_clear() and free().
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \return Released Data object, NULL when the replacement can't be allocated
+*/
+LIBRAGEPHOTO_C_PUBLIC RagePhotoData* ragephoto_releasephotodata(ragephoto_t instance);
+
 /** Returns the Photo description.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -152,12 +263,16 @@ LIBRAGEPHOTO_C_PUBLIC const char* ragephoto_getphotojson(ragephoto_t instance);
 LIBRAGEPHOTO_C_PUBLIC const char* ragephoto_getphotoheader(ragephoto_t instance);
 
 /** Returns the Photo JPEG sign.
+*
+* The sign is cached per Photo Format until the JPEG is changed, writing the cache makes concurrent calls on the same Photo unsafe.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
 */
 LIBRAGEPHOTO_C_PUBLIC uint64_t ragephoto_getphotosign(ragephoto_t instance);
 
 /** Returns the Photo JPEG sign.
+*
+* The sign is cached per Photo Format until the JPEG is changed, writing the cache makes concurrent calls on the same Photo unsafe.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
 * \param photoFormat Photo Format (GTA V or RDR 2)
@@ -182,18 +297,43 @@ LIBRAGEPHOTO_C_PUBLIC void ragephoto_getphotosigns(ragephoto_t instance, char *d
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_getphotosignsf(ragephoto_t instance, char *data, size_t size, uint32_t photoFormat);
 
 /** Returns the Photo JPEG sign.
+*
+* The sign is cached per Photo Format until the JPEG is changed, writing the cache makes concurrent calls on the same Photo unsafe.
 * \memberof RagePhotoData
 * \param rp_data Data object
 */
 LIBRAGEPHOTO_C_PUBLIC uint64_t ragephotodata_getphotosign(RagePhotoData *rp_data);
 
 /** Returns the Photo JPEG sign.
+*
+* The sign is cached per Photo Format until the JPEG is changed, writing the cache makes concurrent calls on the same Photo unsafe.
 * \memberof RagePhotoData
 * \param rp_data Data object
 * \param photoFormat Photo Format (GTA V or RDR 2)
 */
 LIBRAGEPHOTO_C_PUBLIC uint64_t ragephotodata_getphotosignf(RagePhotoData *rp_data, uint32_t photoFormat);
 
+/** Returns the Photo JPEG signs of multiple Photos.
+*
+* The JPEG data of multiple Photos is hashed at once in parallel SIMD lanes, each Photo is signed with its own Photo Format.
+* Photos without JPEG data or with an unknown Photo Format return 0, the signs are cached like with ragephotodata_getphotosignf().
+* \memberof RagePhotoData
+* \param rp_data Data object array
+* \param count Data object count
+* \param signs Sign array, receives one sign for each Data object
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephotodata_getphotosignmany(RagePhotoData **rp_data, size_t count, uint64_t *signs);
+
+/** Returns the Photo JPEG signs of multiple instances.
+*
+* See ragephotodata_getphotosignmany().
+* \memberof RagePhotoInstance
+* \param instances \p ragephoto_t instance array
+* \param count Instance count
+* \param signs Sign array, receives one sign for each instance
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_getphotosignmany(ragephoto_t *instances, size_t count, uint64_t *signs);
+
 /** Returns the Photo JPEG data size.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -266,6 +406,50 @@ LIBRAGEPHOTO_C_PUBLIC bool ragephoto_savef(ragephoto_t instance, char *data, uin
 */
 LIBRAGEPHOTO_C_PUBLIC bool ragephotodata_savef(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, char *data, uint32_t photoFormat);
 
+/** Saves a Photo as scatter-gather entries for writev() without copying the sections.
+*
+* Entries point into \p buffer, the Photo sections and a shared zero page, which all have to stay unchanged until written.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param iov Entries to fill
+* \param count Number of entries available in \p iov
+* \param buffer Buffer of #RAGEPHOTO_SAVEIOV_BUFFERSIZE bytes for the serialized header pieces
+* \return Number of entries of the Photo, 0 on error, only the first \p count entries are filled when it exceeds \p count
+*/
+LIBRAGEPHOTO_C_PUBLIC size_t ragephoto_saveiov(ragephoto_t instance, RagePhotoIovec *iov, size_t count, char *buffer);
+
+/** Saves a Photo as scatter-gather entries for writev() without copying the sections.
+* \memberof RagePhotoData
+* \param rp_data Data object
+* \param iov Entries to fill
+* \param count Number of entries available in \p iov
+* \param buffer Buffer of #RAGEPHOTO_SAVEIOV_BUFFERSIZE bytes for the serialized header pieces
+* \return Number of entries of the Photo, 0 on error, only the first \p count entries are filled when it exceeds \p count
+*/
+LIBRAGEPHOTO_C_PUBLIC size_t ragephotodata_saveiov(RagePhotoData *rp_data, RagePhotoIovec *iov, size_t count, char *buffer);
+
+/** Saves a Photo as scatter-gather entries for writev() without copying the sections.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param iov Entries to fill
+* \param count Number of entries available in \p iov
+* \param buffer Buffer of #RAGEPHOTO_SAVEIOV_BUFFERSIZE bytes for the serialized header pieces
+* \param photoFormat Photo Format (GTA V, RDR 2 or JPEG)
+* \return Number of entries of the Photo, 0 on error, only the first \p count entries are filled when it exceeds \p count
+*/
+LIBRAGEPHOTO_C_PUBLIC size_t ragephoto_saveiovf(ragephoto_t instance, RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat);
+
+/** Saves a Photo as scatter-gather entries for writev() without copying the sections.
+* \memberof RagePhotoData
+* \param rp_data Data object
+* \param iov Entries to fill
+* \param count Number of entries available in \p iov
+* \param buffer Buffer of #RAGEPHOTO_SAVEIOV_BUFFERSIZE bytes for the serialized header pieces
+* \param photoFormat Photo Format (GTA V, RDR 2 or JPEG)
+* \return Number of entries of the Photo, 0 on error, only the first \p count entries are filled when it exceeds \p count
+*/
+LIBRAGEPHOTO_C_PUBLIC size_t ragephotodata_saveiovf(RagePhotoData *rp_data, RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat);
+
 /** Saves a Photo to a file.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -312,7 +496,42 @@ LIBRAGEPHOTO_C_PUBLIC void ragephotodata_setbufferoffsets(RagePhotoData *rp_data
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_setlibraryflag(RagePhotoLibraryFlag flag, bool state);
 
+/** Sets the section size limits applied when loading.
+*
+* All limits default to UINT32_MAX, loading always checks the section sizes against the remaining input before allocating.
+* \relates RagePhotoInstance
+* \param limits Section size limits, NULL restores the defaults
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_setsizelimits(const RagePhotoSizeLimits *limits);
+
+/** Returns the section size limits applied when loading.
+* \relates RagePhotoInstance
+* \param limits Section size limits
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_getsizelimits(RagePhotoSizeLimits *limits);
+
+/** Sets the allocator used for Photo buffers.
+*
+* Buffers are requested with #RAGEPHOTO_BUFFER_ALIGNMENT, the JPEG in arena storage keeps the alignment of the storage.
+* The allocator has to be set before any Photo is loaded, buffers are always freed with the current allocator.
+* Section buffers set directly or by custom parsers have to be allocated with the same allocator.
+* \relates RagePhotoInstance
+* \param allocator Allocator, NULL restores malloc, realloc and free
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_setlibraryallocator(const RagePhotoAllocator *allocator);
+
+/** Sets the allocator used for the Photo buffers of a \p ragephoto_t instance.
+*
+* The Photo is cleared before the allocator is changed, the allocator is not copied and has to outlive the instance.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param allocator Allocator, NULL uses the library allocator
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_setallocator(ragephoto_t instance, const RagePhotoAllocator *allocator);
+
 /** Sets the internal RagePhotoData object.
+*
+* The instance takes ownership of \p rp_data, it has to be allocated with malloc.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
 * \param rp_data Data object used to replace
@@ -320,12 +539,25 @@ LIBRAGEPHOTO_C_PUBLIC void ragephoto_setlibraryflag(RagePhotoLibraryFlag flag, b
 LIBRAGEPHOTO_C_PUBLIC bool ragephoto_setphotodata(ragephoto_t instance, RagePhotoData *rp_data);
 
 /** Copies RagePhotoData object to internal RagePhotoData object.
+*
+* Only the sections and fields up to titlOffset are read from \p rp_data, the sections are always copied.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
 * \param rp_data Data object used to copy
 */
 LIBRAGEPHOTO_C_PUBLIC bool ragephoto_setphotodatac(ragephoto_t instance, RagePhotoData *rp_data);
 
+/** Copies the Photo of another instance to the internal RagePhotoData object.
+*
+* Sections loaded with #RAGEPHOTO_FLAG_ARENA_STORAGE are shared instead of copied when both instances use the same allocator,
+* a shared section is copied when it is changed with one of the ragephoto_setphoto functions. Writing to the section
+* pointers directly changes all instances sharing them.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param source \p ragephoto_t instance used to copy
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_copyphotodata(ragephoto_t instance, ragephoto_t source);
+
 /** Sets the Photo description.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -336,6 +568,17 @@ LIBRAGEPHOTO_C_PUBLIC bool ragephoto_setphotodatac(ragephoto_t instance, RagePho
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphotodesc(ragephoto_t instance, const char *description, uint32_t bufferSize);
 
+/** Sets the Photo description with a known length.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param description Description, doesn't need to be null-terminated
+* \param length Description length without null terminator
+* \param bufferSize Description buffer size
+*
+* Default bufferSize: 256UL
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphotodescl(ragephoto_t instance, const char *description, size_t length, uint32_t bufferSize);
+
 /** Sets the Photo Format (GTA V or RDR 2).
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -354,6 +597,19 @@ LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphotoformat(ragephoto_t instance, uint32
 */
 LIBRAGEPHOTO_C_PUBLIC bool ragephoto_setphotojpeg(ragephoto_t instance, const char *data, uint32_t size, uint32_t bufferSize);
 
+/** Sets the Photo JPEG data without copying it.
+*
+* The instance takes ownership of \p data, it has to be allocated with the allocator of the instance.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param data JPEG data
+* \param size JPEG data size
+* \param bufferSize JPEG buffer size
+*
+* Default bufferSize: ragephoto_defpbuf_gta5() or ragephoto_defpbuf_rdr2()
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_adoptphotojpeg(ragephoto_t instance, char *data, uint32_t size, uint32_t bufferSize);
+
 /** Sets the Photo JSON data.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
@@ -364,6 +620,29 @@ LIBRAGEPHOTO_C_PUBLIC bool ragephoto_setphotojpeg(ragephoto_t instance, const ch
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphotojson(ragephoto_t instance, const char *json, uint32_t bufferSize);
 
+/** Sets the Photo JSON data with a known length.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param json JSON data, doesn't need to be null-terminated
+* \param length JSON data length without null terminator
+* \param bufferSize JSON data buffer size
+*
+* Default bufferSize: 3072UL
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphotojsonl(ragephoto_t instance, const char *json, size_t length, uint32_t bufferSize);
+
+/** Sets the Photo JSON data without copying it.
+*
+* The instance takes ownership of \p json, it has to be null-terminated and allocated with the allocator of the instance.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param json JSON data
+* \param bufferSize JSON data buffer size
+*
+* Default bufferSize: 3072UL
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_adoptphotojson(ragephoto_t instance, char *json, uint32_t bufferSize);
+
 /** Sets the Photo header.
 * \memberof RagePhotoInstance
 */
@@ -384,17 +663,108 @@ LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphotoheader2(ragephoto_t instance, const
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphototitle(ragephoto_t instance, const char *title, uint32_t bufferSize);
 
+/** Sets the Photo title with a known length.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+* \param title Title, doesn't need to be null-terminated
+* \param length Title length without null terminator
+* \param bufferSize Title buffer size
+*
+* Default bufferSize: 256UL
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_setphototitlel(ragephoto_t instance, const char *title, size_t length, uint32_t bufferSize);
+
 /** Closes a \p ragephoto_t instance.
 * \memberof RagePhotoInstance
 * \param instance \p ragephoto_t instance
 */
 LIBRAGEPHOTO_C_PUBLIC void ragephoto_close(ragephoto_t instance);
 
+/** Takes a \p ragephoto_t instance from the pool, a new instance is opened when the pool is empty.
+* \relates RagePhotoInstance
+*/
+LIBRAGEPHOTO_C_PUBLIC ragephoto_t ragephoto_acquire();
+
+/** Resets a \p ragephoto_t instance and returns it to the pool, the instance is closed when the pool is full.
+*
+* Custom parsers added to the instance are removed, the section buffers are kept for the next load.
+* Instances with an allocator set by ragephoto_setallocator() are always closed.
+* \memberof RagePhotoInstance
+* \param instance \p ragephoto_t instance
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_release(ragephoto_t instance);
+
 /** Returns the library version.
 * \relates RagePhotoInstance
 */
 LIBRAGEPHOTO_C_PUBLIC const char* ragephoto_version();
 
+/** Loads a Photo view from a const char* without copying.
+* \memberof RagePhotoView
+* \param rp_view View object
+* \param data Photo data, has to outlive the view
+* \param size Photo data size
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephotoview_load(RagePhotoView *rp_view, const char *data, size_t size);
+
+/** Decodes the Photo header of a view.
+* \memberof RagePhotoView
+* \param rp_view View object
+* \param data String data
+* \param size String size
+* \return true when decoded, false when the header is malformed or doesn't fit
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephotoview_getheader(const RagePhotoView *rp_view, char *data, size_t size);
+
+/** Returns the Photo JPEG sign of a view.
+* \memberof RagePhotoView
+* \param rp_view View object
+*/
+LIBRAGEPHOTO_C_PUBLIC uint64_t ragephotoview_getphotosign(const RagePhotoView *rp_view);
+
+/** Returns the Photo JPEG sign of a view.
+* \memberof RagePhotoView
+* \param rp_view View object
+* \param photoFormat Photo Format (GTA V or RDR 2)
+*/
+LIBRAGEPHOTO_C_PUBLIC uint64_t ragephotoview_getphotosignf(const RagePhotoView *rp_view, uint32_t photoFormat);
+
+/** Initialises a push parser for loading a Photo into a \p ragephoto_t instance.
+* \memberof RagePhotoParser
+* \param rp_stream Push parser object
+* \param instance \p ragephoto_t instance
+* \param sections Sections to load, see #RagePhotoSection
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephoto_parser_init(RagePhotoParser *rp_stream, ragephoto_t instance, uint8_t sections);
+
+/** Initialises a push parser for loading a Photo into a Data object.
+* \memberof RagePhotoParser
+* \param rp_stream Push parser object
+* \param rp_data Data object
+* \param sections Sections to load, see #RagePhotoSection
+*/
+LIBRAGEPHOTO_C_PUBLIC void ragephotodata_parser_init(RagePhotoParser *rp_stream, RagePhotoData *rp_data, uint8_t sections);
+
+/** Feeds a chunk of Photo data to a push parser.
+* \memberof RagePhotoParser
+* \param rp_stream Push parser object
+* \param data Photo data chunk
+* \param size Photo data chunk size
+*
+* Chunks can have any size, sections not requested are skipped without being stored.
+* Data following the last requested section is not consumed.
+* Only GTA V and RDR 2 Photos can be parsed, custom format parsers need the complete buffer.
+*/
+LIBRAGEPHOTO_C_PUBLIC RagePhotoParserStatus ragephoto_parser_feed(RagePhotoParser *rp_stream, const char *data, size_t size);
+
+/** Finishes a push parser at the end of input.
+* \memberof RagePhotoParser
+* \param rp_stream Push parser object
+*
+* Sets the same error as loading the truncated Photo when requested sections are still incomplete.
+*/
+LIBRAGEPHOTO_C_PUBLIC bool ragephoto_parser_finish(RagePhotoParser *rp_stream);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
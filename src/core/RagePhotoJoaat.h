@@ -0,0 +1,349 @@
+/*****************************************************************************
+* libragephoto RAGE Photo Parser
+* Copyright (C) 2025 Syping
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* This software is provided as-is, no warranties are given to you, we are not
+* responsible for anything with use of the software, you are self responsible.
+*****************************************************************************/
+
+#ifndef RAGEPHOTOJOAAT_H
+#define RAGEPHOTOJOAAT_H
+
+/* Internal JOAAT (Jenkins one-at-a-time) hash functions, not part of the public API */
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JOAAT_AVX2
+#define JOAAT_LANES 16
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JOAAT_SSE2
+#define JOAAT_LANES 8
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define JOAAT_NEON
+#define JOAAT_LANES 8
+#else
+#define JOAAT_LANES 4
+#endif
+
+#define JOAAT_BLOCK 16 /**< Bytes hashed per lane and block */
+#define JOAAT_CHUNK 64 /**< Buffers collected on the stack per joaatMany() call */
+#define JOAAT_COPYCHUNK 4096 /**< Bytes copied per step of joaatCopy(), small enough to stay in L1 cache */
+
+/* The hash adds every byte as char, so the bytes are sign-extended where char is signed */
+#if CHAR_MIN < 0
+#define JOAAT_SSE2_EXTEND(x) _mm_srai_epi32(x, 24)
+#define JOAAT_AVX2_EXTEND(x) _mm256_srai_epi32(x, 24)
+#else
+#define JOAAT_SSE2_EXTEND(x) _mm_srli_epi32(x, 24)
+#define JOAAT_AVX2_EXTEND(x) _mm256_srli_epi32(x, 24)
+#endif
+
+static inline uint32_t joaatUpdate(uint32_t val, const char *data, size_t size)
+{
+    for (size_t i = 0; i != size; i++) {
+        val += data[i];
+        val += val << 10;
+        val ^= val >> 6;
+    }
+    return val;
+}
+
+static inline uint32_t joaatFinish(uint32_t val)
+{
+    val += val << 3;
+    val ^= val >> 11;
+    val += val << 15;
+    return val;
+}
+
+/* Copies and hashes in one pass over the source, each chunk is hashed from the copy while it is still cached */
+static inline uint32_t joaatCopy(uint32_t val, char *output, const char *input, size_t size)
+{
+    while (size) {
+        const size_t chunkSize = (size > JOAAT_COPYCHUNK) ? JOAAT_COPYCHUNK : size;
+        memcpy(output, input, chunkSize);
+        val = joaatUpdate(val, output, chunkSize);
+        output += chunkSize;
+        input += chunkSize;
+        size -= chunkSize;
+    }
+    return val;
+}
+
+/* Scalar reference, every multi-lane result has to match it */
+static inline uint32_t joaatFromInitial(const char *data, size_t size, uint32_t init_val)
+{
+    return joaatFinish(joaatUpdate(init_val, data, size));
+}
+
+#if defined(JOAAT_SSE2)
+static inline __m128i joaatRoundSse2(__m128i val, __m128i bytes)
+{
+    val = _mm_add_epi32(val, bytes);
+    val = _mm_add_epi32(val, _mm_slli_epi32(val, 10));
+    return _mm_xor_si128(val, _mm_srli_epi32(val, 6));
+}
+
+/* Hashes one block of 4 lanes, the lane bytes are transposed into one 32-bit element per lane */
+static inline __m128i joaatBlockSse2(__m128i val, const char *const *ptr)
+{
+    const __m128i a = _mm_loadu_si128((const __m128i*)ptr[0]);
+    const __m128i b = _mm_loadu_si128((const __m128i*)ptr[1]);
+    const __m128i c = _mm_loadu_si128((const __m128i*)ptr[2]);
+    const __m128i d = _mm_loadu_si128((const __m128i*)ptr[3]);
+    const __m128i abLow = _mm_unpacklo_epi8(a, b);
+    const __m128i cdLow = _mm_unpacklo_epi8(c, d);
+    const __m128i abHigh = _mm_unpackhi_epi8(a, b);
+    const __m128i cdHigh = _mm_unpackhi_epi8(c, d);
+    __m128i quads[4];
+    quads[0] = _mm_unpacklo_epi16(abLow, cdLow);
+    quads[1] = _mm_unpackhi_epi16(abLow, cdLow);
+    quads[2] = _mm_unpacklo_epi16(abHigh, cdHigh);
+    quads[3] = _mm_unpackhi_epi16(abHigh, cdHigh);
+    for (int i = 0; i < 4; i++) {
+        const __m128i low = _mm_unpacklo_epi8(quads[i], quads[i]);
+        const __m128i high = _mm_unpackhi_epi8(quads[i], quads[i]);
+        val = joaatRoundSse2(val, JOAAT_SSE2_EXTEND(_mm_unpacklo_epi16(low, low)));
+        val = joaatRoundSse2(val, JOAAT_SSE2_EXTEND(_mm_unpackhi_epi16(low, low)));
+        val = joaatRoundSse2(val, JOAAT_SSE2_EXTEND(_mm_unpacklo_epi16(high, high)));
+        val = joaatRoundSse2(val, JOAAT_SSE2_EXTEND(_mm_unpackhi_epi16(high, high)));
+    }
+    return val;
+}
+
+static inline void joaatBlocks(uint32_t *state, const char **ptr, size_t blocks)
+{
+    __m128i val0 = _mm_loadu_si128((const __m128i*)&state[0]);
+    __m128i val1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    for (size_t i = 0; i < blocks; i++) {
+        val0 = joaatBlockSse2(val0, &ptr[0]);
+        val1 = joaatBlockSse2(val1, &ptr[4]);
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++)
+            ptr[lane] += JOAAT_BLOCK;
+    }
+    _mm_storeu_si128((__m128i*)&state[0], val0);
+    _mm_storeu_si128((__m128i*)&state[4], val1);
+}
+#elif defined(JOAAT_AVX2)
+static inline __m256i joaatRoundAvx2(__m256i val, __m256i bytes)
+{
+    val = _mm256_add_epi32(val, bytes);
+    val = _mm256_add_epi32(val, _mm256_slli_epi32(val, 10));
+    return _mm256_xor_si256(val, _mm256_srli_epi32(val, 6));
+}
+
+static inline __m256i joaatLoadAvx2(const char *low, const char *high)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)low)), _mm_loadu_si128((const __m128i*)high), 1);
+}
+
+/* Hashes one block of 8 lanes, the 128-bit halves transpose lanes 0-3 and 4-7 like joaatBlockSse2() */
+static inline __m256i joaatBlockAvx2(__m256i val, const char *const *ptr)
+{
+    const __m256i a = joaatLoadAvx2(ptr[0], ptr[4]);
+    const __m256i b = joaatLoadAvx2(ptr[1], ptr[5]);
+    const __m256i c = joaatLoadAvx2(ptr[2], ptr[6]);
+    const __m256i d = joaatLoadAvx2(ptr[3], ptr[7]);
+    const __m256i abLow = _mm256_unpacklo_epi8(a, b);
+    const __m256i cdLow = _mm256_unpacklo_epi8(c, d);
+    const __m256i abHigh = _mm256_unpackhi_epi8(a, b);
+    const __m256i cdHigh = _mm256_unpackhi_epi8(c, d);
+    __m256i quads[4];
+    quads[0] = _mm256_unpacklo_epi16(abLow, cdLow);
+    quads[1] = _mm256_unpackhi_epi16(abLow, cdLow);
+    quads[2] = _mm256_unpacklo_epi16(abHigh, cdHigh);
+    quads[3] = _mm256_unpackhi_epi16(abHigh, cdHigh);
+    for (int i = 0; i < 4; i++) {
+        const __m256i low = _mm256_unpacklo_epi8(quads[i], quads[i]);
+        const __m256i high = _mm256_unpackhi_epi8(quads[i], quads[i]);
+        val = joaatRoundAvx2(val, JOAAT_AVX2_EXTEND(_mm256_unpacklo_epi16(low, low)));
+        val = joaatRoundAvx2(val, JOAAT_AVX2_EXTEND(_mm256_unpackhi_epi16(low, low)));
+        val = joaatRoundAvx2(val, JOAAT_AVX2_EXTEND(_mm256_unpacklo_epi16(high, high)));
+        val = joaatRoundAvx2(val, JOAAT_AVX2_EXTEND(_mm256_unpackhi_epi16(high, high)));
+    }
+    return val;
+}
+
+static inline void joaatBlocks(uint32_t *state, const char **ptr, size_t blocks)
+{
+    __m256i val0 = _mm256_loadu_si256((const __m256i*)&state[0]);
+    __m256i val1 = _mm256_loadu_si256((const __m256i*)&state[8]);
+    for (size_t i = 0; i < blocks; i++) {
+        val0 = joaatBlockAvx2(val0, &ptr[0]);
+        val1 = joaatBlockAvx2(val1, &ptr[8]);
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++)
+            ptr[lane] += JOAAT_BLOCK;
+    }
+    _mm256_storeu_si256((__m256i*)&state[0], val0);
+    _mm256_storeu_si256((__m256i*)&state[8], val1);
+}
+#elif defined(JOAAT_NEON)
+static inline uint32x4_t joaatRoundNeon(uint32x4_t val, uint32x4_t bytes)
+{
+    val = vaddq_u32(val, bytes);
+    val = vaddq_u32(val, vshlq_n_u32(val, 10));
+    return veorq_u32(val, vshrq_n_u32(val, 6));
+}
+
+#if CHAR_MIN < 0
+static inline void joaatExtendNeon(uint8x16_t quad, uint32x4_t *bytes)
+{
+    const int16x8_t low = vmovl_s8(vget_low_s8(vreinterpretq_s8_u8(quad)));
+    const int16x8_t high = vmovl_s8(vget_high_s8(vreinterpretq_s8_u8(quad)));
+    bytes[0] = vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(low)));
+    bytes[1] = vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(low)));
+    bytes[2] = vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(high)));
+    bytes[3] = vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(high)));
+}
+#else
+static inline void joaatExtendNeon(uint8x16_t quad, uint32x4_t *bytes)
+{
+    const uint16x8_t low = vmovl_u8(vget_low_u8(quad));
+    const uint16x8_t high = vmovl_u8(vget_high_u8(quad));
+    bytes[0] = vmovl_u16(vget_low_u16(low));
+    bytes[1] = vmovl_u16(vget_high_u16(low));
+    bytes[2] = vmovl_u16(vget_low_u16(high));
+    bytes[3] = vmovl_u16(vget_high_u16(high));
+}
+#endif
+
+/* Hashes one block of 4 lanes, the lane bytes are transposed into one 32-bit element per lane */
+static inline uint32x4_t joaatBlockNeon(uint32x4_t val, const char *const *ptr)
+{
+    const uint8x16_t a = vld1q_u8((const uint8_t*)ptr[0]);
+    const uint8x16_t b = vld1q_u8((const uint8_t*)ptr[1]);
+    const uint8x16_t c = vld1q_u8((const uint8_t*)ptr[2]);
+    const uint8x16_t d = vld1q_u8((const uint8_t*)ptr[3]);
+    const uint16x8_t abLow = vreinterpretq_u16_u8(vzip1q_u8(a, b));
+    const uint16x8_t cdLow = vreinterpretq_u16_u8(vzip1q_u8(c, d));
+    const uint16x8_t abHigh = vreinterpretq_u16_u8(vzip2q_u8(a, b));
+    const uint16x8_t cdHigh = vreinterpretq_u16_u8(vzip2q_u8(c, d));
+    uint8x16_t quads[4];
+    quads[0] = vreinterpretq_u8_u16(vzip1q_u16(abLow, cdLow));
+    quads[1] = vreinterpretq_u8_u16(vzip2q_u16(abLow, cdLow));
+    quads[2] = vreinterpretq_u8_u16(vzip1q_u16(abHigh, cdHigh));
+    quads[3] = vreinterpretq_u8_u16(vzip2q_u16(abHigh, cdHigh));
+    for (int i = 0; i < 4; i++) {
+        uint32x4_t bytes[4];
+        joaatExtendNeon(quads[i], bytes);
+        val = joaatRoundNeon(val, bytes[0]);
+        val = joaatRoundNeon(val, bytes[1]);
+        val = joaatRoundNeon(val, bytes[2]);
+        val = joaatRoundNeon(val, bytes[3]);
+    }
+    return val;
+}
+
+static inline void joaatBlocks(uint32_t *state, const char **ptr, size_t blocks)
+{
+    uint32x4_t val0 = vld1q_u32(&state[0]);
+    uint32x4_t val1 = vld1q_u32(&state[4]);
+    for (size_t i = 0; i < blocks; i++) {
+        val0 = joaatBlockNeon(val0, &ptr[0]);
+        val1 = joaatBlockNeon(val1, &ptr[4]);
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++)
+            ptr[lane] += JOAAT_BLOCK;
+    }
+    vst1q_u32(&state[0], val0);
+    vst1q_u32(&state[4], val1);
+}
+#else
+/* Interleaves independent scalar lanes, the CPU overlaps their dependency chains */
+static inline void joaatBlocks(uint32_t *state, const char **ptr, size_t blocks)
+{
+    for (size_t i = 0; i < blocks; i++) {
+        for (size_t pos = 0; pos < JOAAT_BLOCK; pos++) {
+            for (size_t lane = 0; lane < JOAAT_LANES; lane++) {
+                uint32_t val = state[lane] + ptr[lane][pos];
+                val += val << 10;
+                state[lane] = val ^ (val >> 6);
+            }
+        }
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++)
+            ptr[lane] += JOAAT_BLOCK;
+    }
+}
+#endif
+
+/* Hashes multiple buffers at once, one buffer per lane.
+* Finished lanes are refilled with the next buffer, so lanes stay busy with buffers of different sizes. */
+static inline void joaatMany(const char *const *data, const size_t *size, const uint32_t *init_val, uint32_t *hash, size_t count)
+{
+    uint32_t state[JOAAT_LANES];
+    const char *ptr[JOAAT_LANES];
+    size_t left[JOAAT_LANES];
+    size_t job[JOAAT_LANES];
+    size_t next = 0;
+    size_t active = 0;
+    for (size_t lane = 0; lane < JOAAT_LANES; lane++) {
+        state[lane] = 0;
+        ptr[lane] = NULL;
+        left[lane] = SIZE_MAX;
+        job[lane] = SIZE_MAX;
+        if (next < count) {
+            state[lane] = init_val[next];
+            ptr[lane] = data[next];
+            left[lane] = size[next];
+            job[lane] = next++;
+            active++;
+        }
+    }
+    while (active) {
+        // Lanes with less than one block left are finished with the scalar routine
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++) {
+            while (job[lane] != SIZE_MAX && left[lane] < JOAAT_BLOCK) {
+                hash[job[lane]] = joaatFinish(joaatUpdate(state[lane], ptr[lane], left[lane]));
+                if (next < count) {
+                    state[lane] = init_val[next];
+                    ptr[lane] = data[next];
+                    left[lane] = size[next];
+                    job[lane] = next++;
+                }
+                else {
+                    left[lane] = SIZE_MAX;
+                    job[lane] = SIZE_MAX;
+                    active--;
+                }
+            }
+        }
+        if (!active)
+            break;
+        size_t blocks = SIZE_MAX;
+        const char *fill = NULL;
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++) {
+            if (job[lane] != SIZE_MAX && left[lane] / JOAAT_BLOCK < blocks) {
+                blocks = left[lane] / JOAAT_BLOCK;
+                fill = ptr[lane];
+            }
+        }
+        // Idle lanes hash the shortest active buffer, their state is discarded
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++) {
+            if (job[lane] == SIZE_MAX)
+                ptr[lane] = fill;
+        }
+        joaatBlocks(state, ptr, blocks);
+        for (size_t lane = 0; lane < JOAAT_LANES; lane++) {
+            if (job[lane] != SIZE_MAX)
+                left[lane] -= blocks * JOAAT_BLOCK;
+        }
+    }
+}
+
+#endif // RAGEPHOTOJOAAT_H
@@ -27,7 +27,32 @@
 extern "C" {
 #endif // __cplusplus
 
-/** RagePhoto data struct for storing internal data. */
+/** RagePhoto malloc function typedef, \p alignment is #RAGEPHOTO_BUFFER_ALIGNMENT. */
+typedef void* (*ragephoto_mallocfunc_t)(size_t size, size_t alignment, void *context);
+
+/** RagePhoto realloc function typedef, \p alignment is #RAGEPHOTO_BUFFER_ALIGNMENT. */
+typedef void* (*ragephoto_reallocfunc_t)(void *data, size_t size, size_t alignment, void *context);
+
+/** RagePhoto free function typedef. */
+typedef void (*ragephoto_freefunc_t)(void *data, void *context);
+
+/** RagePhoto allocator struct for routing the allocations of Photo buffers.
+*
+* An allocator without malloc function uses malloc, realloc and free.
+* Without realloc function buffers are resized by allocating a new buffer, without free function buffers are never freed.
+*/
+typedef struct RagePhotoAllocator {
+    ragephoto_mallocfunc_t funcMalloc; /**< Pointer to malloc function */
+    ragephoto_reallocfunc_t funcRealloc; /**< Pointer to realloc function, can be NULL */
+    ragephoto_freefunc_t funcFree; /**< Pointer to free function, can be NULL */
+    void* context; /**< Context passed to the allocator functions */
+} RagePhotoAllocator;
+
+/** RagePhoto data struct for storing internal data.
+*
+* Fields following titlOffset are library state appended in 0.9.0, data objects not created by the library have to be zero-initialised.
+* Copies only read the fields up to titlOffset from the copied object.
+*/
 typedef struct RagePhotoData {
     char* jpeg; /**< Pointer for internal JPEG buffer */
     char* description; /**< Pointer for internal Description buffer */
@@ -47,8 +72,147 @@ typedef struct RagePhotoData {
     uint32_t photoFormat; /**< Photo file format magic */
     uint32_t titlBuffer; /**< Title buffer length */
     uint32_t titlOffset; /**< Title buffer offset */
+    void* storage; /**< Pointer for internal single allocation storage, see #RAGEPHOTO_FLAG_ARENA_STORAGE */
+    const RagePhotoAllocator* allocator; /**< Allocator of the internal buffers, NULL for the library allocator */
+    uint64_t jpegSign; /**< Cached JPEG sign, valid when signFormat is set */
+    uint32_t descCapacity; /**< Allocated length of the internal Description buffer, 0 when unknown, reset it after replacing the buffer directly */
+    uint32_t headerCapacity; /**< Allocated length of the internal Header buffer, 0 when unknown, reset it after replacing the buffer directly */
+    uint32_t jpegCapacity; /**< Allocated length of the internal JPEG buffer, 0 when unknown, reset it after replacing the buffer directly */
+    uint32_t jsonCapacity; /**< Allocated length of the internal JSON buffer, 0 when unknown, reset it after replacing the buffer directly */
+    uint32_t signFormat; /**< Photo Format of the cached JPEG sign, 0 when no sign is cached, reset it after changing the JPEG directly */
+    uint32_t titlCapacity; /**< Allocated length of the internal Title buffer, 0 when unknown, reset it after replacing the buffer directly */
+    char* descRetained; /**< Description buffer kept by ragephotodata_reset(), library state */
+    char* headerRetained; /**< Header buffer kept by ragephotodata_reset(), library state */
+    char* jpegRetained; /**< JPEG buffer kept by ragephotodata_reset(), library state */
+    char* jsonRetained; /**< JSON buffer kept by ragephotodata_reset(), library state */
+    char* titlRetained; /**< Title buffer kept by ragephotodata_reset(), library state */
+    uint32_t descRetainedCapacity; /**< Allocated length of the kept Description buffer, library state */
+    uint32_t headerRetainedCapacity; /**< Allocated length of the kept Header buffer, library state */
+    uint32_t jpegRetainedCapacity; /**< Allocated length of the kept JPEG buffer, library state */
+    uint32_t jsonRetainedCapacity; /**< Allocated length of the kept JSON buffer, library state */
+    uint32_t titlRetainedCapacity; /**< Allocated length of the kept Title buffer, library state */
 } RagePhotoData;
 
+/** RagePhoto view struct for borrowing sections from a Photo buffer.
+*
+* All pointers are slices of the buffer passed to the load function, the buffer has to outlive the view.
+*/
+typedef struct RagePhotoView {
+    const char* jpeg; /**< Pointer to JPEG data in borrowed buffer */
+    const char* description; /**< Pointer to Description buffer in borrowed buffer */
+    const char* json; /**< Pointer to JSON buffer in borrowed buffer */
+    const char* header; /**< Pointer to UTF-16LE Header in borrowed buffer */
+    const char* title; /**< Pointer to Title buffer in borrowed buffer */
+    uint64_t jpegSign; /**< Cached JPEG sign, valid when signFormat is set */
+    int32_t error; /**< RagePhoto error code */
+    uint32_t descBuffer; /**< Description buffer length */
+    uint32_t descOffset; /**< Description buffer offset */
+    uint32_t endOfFile; /**< End Of File offset */
+    uint32_t headerSum; /**< Checksum of the header 1 */
+    uint32_t headerSum2; /**< Checksum of the header 2 (RDR 2 only) */
+    uint32_t jpegBuffer; /**< JPEG buffer length */
+    uint32_t jpegSize; /**< Size of JPEG */
+    uint32_t jsonBuffer; /**< JSON buffer length */
+    uint32_t jsonOffset; /**< JSON buffer offset */
+    uint32_t photoFormat; /**< Photo file format magic */
+    uint32_t signFormat; /**< Photo Format of the cached JPEG sign, 0 when no sign is cached */
+    uint32_t titlBuffer; /**< Title buffer length */
+    uint32_t titlOffset; /**< Title buffer offset */
+} RagePhotoView;
+
+/** RagePhoto validation report, filled by ragephoto_validate().
+*
+* Fields of sections which were not reached because of a structural error are zero.
+*/
+typedef struct RagePhotoValidation {
+    size_t descPos; /**< Position of the Description buffer in the validated buffer */
+    size_t jpegPos; /**< Position of the JPEG data in the validated buffer */
+    size_t jsonPos; /**< Position of the JSON buffer in the validated buffer */
+    size_t photoSize; /**< Size of the Photo including the JEND marker, data beyond it is ignored when loading */
+    size_t titlPos; /**< Position of the Title buffer in the validated buffer */
+    int32_t error; /**< RagePhoto error code of the first structural error, #RAGEPHOTO_ERROR_NOERROR when all sections are readable */
+    uint32_t issues; /**< Inconsistencies found, see #RagePhotoValidationIssue */
+    uint32_t descBuffer; /**< Description buffer length */
+    uint32_t descOffset; /**< Description buffer offset */
+    uint32_t endOfFile; /**< End Of File offset */
+    uint32_t jpegBuffer; /**< JPEG buffer length */
+    uint32_t jpegSize; /**< Size of JPEG */
+    uint32_t jsonBuffer; /**< JSON buffer length */
+    uint32_t jsonOffset; /**< JSON buffer offset */
+    uint32_t photoFormat; /**< Photo file format magic */
+    uint32_t titlBuffer; /**< Title buffer length */
+    uint32_t titlOffset; /**< Title buffer offset */
+} RagePhotoValidation;
+
+/** RagePhoto validation issues, inconsistencies found besides structural errors. */
+typedef enum RagePhotoValidationIssue {
+    RAGEPHOTO_ISSUE_JPEGSIZE = 1 << 0, /**< JPEG size exceeds the JPEG buffer length */
+    RAGEPHOTO_ISSUE_JPEGMARKER = 1 << 1, /**< JPEG data doesn't start with a JPEG SOI marker */
+    RAGEPHOTO_ISSUE_JSONOFFSET = 1 << 2, /**< JSON offset doesn't match the JPEG buffer length */
+    RAGEPHOTO_ISSUE_TITLEOFFSET = 1 << 3, /**< Title offset doesn't match the JSON offset and buffer length */
+    RAGEPHOTO_ISSUE_DESCOFFSET = 1 << 4, /**< Description offset doesn't match the Title offset and buffer length */
+    RAGEPHOTO_ISSUE_ENDOFFILE = 1 << 5, /**< End Of File offset doesn't match the Description offset and buffer length */
+    RAGEPHOTO_ISSUE_JSONSTRING = 1 << 6, /**< JSON buffer is not null-terminated */
+    RAGEPHOTO_ISSUE_TITLESTRING = 1 << 7, /**< Title buffer is not null-terminated */
+    RAGEPHOTO_ISSUE_DESCSTRING = 1 << 8, /**< Description buffer is not null-terminated */
+    RAGEPHOTO_ISSUE_HEADERUNICODE = 1 << 9 /**< Header can't be decoded from UTF-16LE, loading fails with #RAGEPHOTO_ERROR_UNICODEHEADERERROR */
+} RagePhotoValidationIssue;
+
+/** RagePhoto push parser struct for loading a Photo from chunked input.
+*
+* All fields besides \p completed are internal state, initialise with ragephotodata_parser_init().
+*/
+typedef struct RagePhotoParser {
+    RagePhotoData *data; /**< Pointer to the Data object being loaded */
+    char buffer[256]; /**< Internal buffer for fields split across chunks */
+    uint32_t fieldPos; /**< Internal position in the current field */
+    uint32_t fieldSize; /**< Internal size of the current field */
+    uint8_t completed; /**< Completed sections, see #RagePhotoSection */
+    uint8_t sections; /**< Requested sections, see #RagePhotoSection */
+    uint8_t signing; /**< Internal flag, the JPEG sign is computed while loading, see #RAGEPHOTO_FLAG_LOAD_SIGN */
+    uint8_t state; /**< Internal parser state */
+} RagePhotoParser;
+
+/** RagePhoto push parser sections. */
+typedef enum RagePhotoSection {
+    RAGEPHOTO_SECTION_HEADER = 1 << 0, /**< Header, checksums and offsets, always loaded */
+    RAGEPHOTO_SECTION_JPEG = 1 << 1, /**< JPEG section */
+    RAGEPHOTO_SECTION_JSON = 1 << 2, /**< JSON section */
+    RAGEPHOTO_SECTION_TITLE = 1 << 3, /**< Title section */
+    RAGEPHOTO_SECTION_DESC = 1 << 4, /**< Description section, completes with the JEND marker */
+    RAGEPHOTO_SECTION_ALL = 0x1F /**< All sections */
+} RagePhotoSection;
+
+/** RagePhoto push parser status. */
+typedef enum RagePhotoParserStatus {
+    RAGEPHOTO_PARSER_ERROR = 0, /**< Parsing failed, see RagePhotoData::error */
+    RAGEPHOTO_PARSER_CONTINUE = 1, /**< More data is required */
+    RAGEPHOTO_PARSER_FINISHED = 2 /**< All requested sections are loaded */
+} RagePhotoParserStatus;
+
+/** RagePhoto batch load options, zero initialised for the defaults. */
+typedef struct RagePhotoBatchOptions {
+    size_t threads; /**< Worker thread count, 0 uses one worker per hardware thread */
+    bool metadata; /**< Load only the metadata sections and skip the JPEG, see ragephoto_loadmeta() */
+} RagePhotoBatchOptions;
+
+/** RagePhoto section size limits, checked before a section is allocated when loading.
+*
+* A section exceeding its limit fails with the allocation error of the section, UINT32_MAX disables a limit.
+*/
+typedef struct RagePhotoSizeLimits {
+    uint32_t descBuffer; /**< Maximum Description buffer length */
+    uint32_t jpegSize; /**< Maximum JPEG size */
+    uint32_t jsonBuffer; /**< Maximum JSON buffer length */
+    uint32_t titlBuffer; /**< Maximum Title buffer length */
+} RagePhotoSizeLimits;
+
+/** RagePhoto scatter-gather save entry, laid out like struct iovec on POSIX systems. */
+typedef struct RagePhotoIovec {
+    void* iov_base; /**< Pointer to the entry data, must not be written through */
+    size_t iov_len; /**< Length of the entry data */
+} RagePhotoIovec;
+
 /** RagePhoto load function typedef. */
 typedef bool (*ragephoto_loadfunc_t)(RagePhotoData*, const char*, size_t);
 
@@ -75,12 +239,21 @@ typedef struct RagePhotoFormatParser {
 */
 typedef struct RagePhotoInstance {
     RagePhotoData *data; /**< Pointer for internal data */
-    RagePhotoFormatParser *parser; /**< Pointer for internal format parser */
+    RagePhotoFormatParser *parser; /**< Pointer for internal format parser, NULL until a custom parser is added */
 } RagePhotoInstance;
 
 /** RagePhoto library flags. */
 typedef enum RagePhotoLibraryFlag {
-    RAGEPHOTO_FLAG_LEGACY_NULL_RETURN = 1 << 0 /**< Flag to enable legacy NULL return */
+    RAGEPHOTO_FLAG_LEGACY_NULL_RETURN = 1 << 0, /**< Flag to enable legacy NULL return */
+    RAGEPHOTO_FLAG_DISABLE_MMAP = 1 << 1, /**< Flag to disable memory-mapped file loading */
+    RAGEPHOTO_FLAG_MMAP_POPULATE = 1 << 2, /**< Flag to prefault memory-mapped files (MAP_POPULATE) */
+    RAGEPHOTO_FLAG_MMAP_SEQUENTIAL = 1 << 3, /**< Flag to advise sequential access on memory-mapped files (MADV_SEQUENTIAL) */
+    RAGEPHOTO_FLAG_ARENA_STORAGE = 1 << 4, /**< Flag to load all Photo sections into a single allocation shared by copies of the Photo, section pointers must not be freed individually */
+    RAGEPHOTO_FLAG_DISABLE_IO_URING = 1 << 5, /**< Flag to disable io_uring batch loading on Linux */
+    RAGEPHOTO_FLAG_LOAD_SIGN = 1 << 6, /**< Flag to compute the JPEG sign while loading the JPEG and cache it */
+    RAGEPHOTO_FLAG_RETAIN_CAPACITY = 1 << 7, /**< Flag to reset instead of clear before loading, section buffers are kept and only grown */
+    RAGEPHOTO_FLAG_DISABLE_DIRECT_SAVE = 1 << 8, /**< Flag to disable direct saving with preallocated data and sparse padding on Linux */
+    RAGEPHOTO_FLAG_ATOMIC_SAVE = 1 << 9 /**< Flag to save through a temporary file renamed over the target, symbolic links are kept and their target is replaced, Linux direct saving only */
 } RagePhotoLibraryFlag;
 
 /* RagePhoto default sizes */
@@ -91,6 +264,9 @@ typedef enum RagePhotoLibraryFlag {
 #define RAGEPHOTO_DEFAULT_TITLBUFFER UINT32_C(256) /**< Default Title Buffer Size */
 #define RAGEPHOTO_GTA5_HEADERSIZE UINT32_C(264) /**< GTA V Header Size */
 #define RAGEPHOTO_RDR2_HEADERSIZE UINT32_C(272) /**< RDR 2 Header Size */
+#define RAGEPHOTO_BUFFER_ALIGNMENT 64 /**< Alignment of Photo buffers and arena storage sections, requested from allocators and used without one on POSIX systems */
+#define RAGEPHOTO_SAVEIOV_BUFFERSIZE 328 /**< Size of the buffer for the serialized header pieces of a scatter-gather save */
+#define RAGEPHOTO_SAVEIOV_ZEROSIZE 65536 /**< Size of the shared zero page of a scatter-gather save, longer padding spans multiple entries */
 
 /* RagePhoto error codes */
 #define RAGEPHOTO_ERROR_DESCBUFFERTIGHT INT32_C(39) /**< Description Buffer is too tight */
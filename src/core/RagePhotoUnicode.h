@@ -0,0 +1,207 @@
+/*****************************************************************************
+* libragephoto RAGE Photo Parser
+* Copyright (C) 2025 Syping
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* This software is provided as-is, no warranties are given to you, we are not
+* responsible for anything with use of the software, you are self responsible.
+*****************************************************************************/
+
+#ifndef RAGEPHOTOUNICODE_H
+#define RAGEPHOTOUNICODE_H
+
+/* Internal builtin UTF-16LE <-> UTF-8 transcoder, not part of the public API */
+
+#include "RagePhotoLibrary.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UNICODE_BUILTIN_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON) && defined(LIBRAGEPHOTO_LITTLE_ENDIAN)
+#include <arm_neon.h>
+#define UNICODE_BUILTIN_NEON
+#endif
+
+#define UNICODE_BUILTIN_INVALID ((size_t)-1) /**< Input is not valid UTF-8 or UTF-16LE */
+#define UNICODE_BUILTIN_TIGHT ((size_t)-2) /**< Output buffer is too tight */
+
+/* Converts UTF-16LE to NUL-terminated UTF-8, stops at the first NUL character.
+* Returns the UTF-8 length without terminator. */
+static inline size_t convertUtf16LeToUtf8(const char *input, size_t inputUnits, char *output, size_t outputLen)
+{
+    const unsigned char *src = (const unsigned char*)input;
+    unsigned char *dst = (unsigned char*)output;
+    size_t pos = 0;
+    size_t outputPos = 0;
+    if (outputLen == 0)
+        return UNICODE_BUILTIN_TIGHT;
+    while (pos < inputUnits) {
+#if defined(UNICODE_BUILTIN_SSE2)
+        if (inputUnits - pos >= 8 && outputLen - outputPos > 8) {
+            const __m128i units = _mm_loadu_si128((const __m128i*)&src[pos * 2]);
+            const __m128i nonAscii = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16((short)0xFF80)), _mm_setzero_si128());
+            const __m128i nul = _mm_cmpeq_epi16(units, _mm_setzero_si128());
+            if (_mm_movemask_epi8(_mm_andnot_si128(nul, nonAscii)) == 0xFFFF) {
+                _mm_storel_epi64((__m128i*)&dst[outputPos], _mm_packus_epi16(units, units));
+                pos += 8;
+                outputPos += 8;
+                continue;
+            }
+        }
+#elif defined(UNICODE_BUILTIN_NEON)
+        if (inputUnits - pos >= 8 && outputLen - outputPos > 8) {
+            const uint16x8_t units = vreinterpretq_u16_u8(vld1q_u8(&src[pos * 2]));
+            if (vmaxvq_u16(units) < 0x80 && vminvq_u16(units) != 0) {
+                vst1_u8(&dst[outputPos], vmovn_u16(units));
+                pos += 8;
+                outputPos += 8;
+                continue;
+            }
+        }
+#endif
+        uint32_t codePoint = src[pos * 2] | (uint32_t)src[pos * 2 + 1] << 8;
+        if (codePoint == 0)
+            break;
+        pos++;
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+            if (pos == inputUnits)
+                return UNICODE_BUILTIN_INVALID;
+            const uint32_t lowSurrogate = src[pos * 2] | (uint32_t)src[pos * 2 + 1] << 8;
+            if (lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+                return UNICODE_BUILTIN_INVALID;
+            pos++;
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+        }
+        else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+            return UNICODE_BUILTIN_INVALID;
+        }
+        const size_t length = codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+        if (outputLen - outputPos <= length)
+            return UNICODE_BUILTIN_TIGHT;
+        switch (length) {
+        case 1:
+            dst[outputPos] = (unsigned char)codePoint;
+            break;
+        case 2:
+            dst[outputPos] = (unsigned char)(0xC0 | codePoint >> 6);
+            dst[outputPos + 1] = (unsigned char)(0x80 | (codePoint & 0x3F));
+            break;
+        case 3:
+            dst[outputPos] = (unsigned char)(0xE0 | codePoint >> 12);
+            dst[outputPos + 1] = (unsigned char)(0x80 | (codePoint >> 6 & 0x3F));
+            dst[outputPos + 2] = (unsigned char)(0x80 | (codePoint & 0x3F));
+            break;
+        default:
+            dst[outputPos] = (unsigned char)(0xF0 | codePoint >> 18);
+            dst[outputPos + 1] = (unsigned char)(0x80 | (codePoint >> 12 & 0x3F));
+            dst[outputPos + 2] = (unsigned char)(0x80 | (codePoint >> 6 & 0x3F));
+            dst[outputPos + 3] = (unsigned char)(0x80 | (codePoint & 0x3F));
+        }
+        outputPos += length;
+    }
+    dst[outputPos] = '\0';
+    return outputPos;
+}
+
+/* Converts UTF-8 to UTF-16LE without terminator.
+* Returns the UTF-16LE size in bytes. */
+static inline size_t convertUtf8ToUtf16Le(const char *input, size_t inputLen, char *output, size_t outputLen)
+{
+    const unsigned char *src = (const unsigned char*)input;
+    unsigned char *dst = (unsigned char*)output;
+    size_t pos = 0;
+    size_t outputPos = 0;
+    while (pos < inputLen) {
+#if defined(UNICODE_BUILTIN_SSE2)
+        if (inputLen - pos >= 16 && outputLen - outputPos >= 32) {
+            const __m128i bytes = _mm_loadu_si128((const __m128i*)&src[pos]);
+            if (_mm_movemask_epi8(bytes) == 0) {
+                _mm_storeu_si128((__m128i*)&dst[outputPos], _mm_unpacklo_epi8(bytes, _mm_setzero_si128()));
+                _mm_storeu_si128((__m128i*)&dst[outputPos + 16], _mm_unpackhi_epi8(bytes, _mm_setzero_si128()));
+                pos += 16;
+                outputPos += 32;
+                continue;
+            }
+        }
+#elif defined(UNICODE_BUILTIN_NEON)
+        if (inputLen - pos >= 16 && outputLen - outputPos >= 32) {
+            const uint8x16_t bytes = vld1q_u8(&src[pos]);
+            if (vmaxvq_u8(bytes) < 0x80) {
+                vst1q_u8(&dst[outputPos], vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(bytes))));
+                vst1q_u8(&dst[outputPos + 16], vreinterpretq_u8_u16(vmovl_u8(vget_high_u8(bytes))));
+                pos += 16;
+                outputPos += 32;
+                continue;
+            }
+        }
+#endif
+        uint32_t codePoint = src[pos];
+        size_t length;
+        uint32_t minCodePoint;
+        if (codePoint < 0x80) {
+            length = 1;
+            minCodePoint = 0;
+        }
+        else if ((codePoint & 0xE0) == 0xC0) {
+            length = 2;
+            minCodePoint = 0x80;
+            codePoint &= 0x1F;
+        }
+        else if ((codePoint & 0xF0) == 0xE0) {
+            length = 3;
+            minCodePoint = 0x800;
+            codePoint &= 0x0F;
+        }
+        else if ((codePoint & 0xF8) == 0xF0) {
+            length = 4;
+            minCodePoint = 0x10000;
+            codePoint &= 0x07;
+        }
+        else {
+            return UNICODE_BUILTIN_INVALID;
+        }
+        if (inputLen - pos < length)
+            return UNICODE_BUILTIN_INVALID;
+        for (size_t i = 1; i < length; i++) {
+            if ((src[pos + i] & 0xC0) != 0x80)
+                return UNICODE_BUILTIN_INVALID;
+            codePoint = codePoint << 6 | (src[pos + i] & 0x3F);
+        }
+        if (codePoint < minCodePoint || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+            return UNICODE_BUILTIN_INVALID;
+        pos += length;
+        if (codePoint >= 0x10000) {
+            if (outputLen - outputPos < 4)
+                return UNICODE_BUILTIN_TIGHT;
+            const uint32_t highSurrogate = 0xD800 + ((codePoint - 0x10000) >> 10);
+            const uint32_t lowSurrogate = 0xDC00 + ((codePoint - 0x10000) & 0x3FF);
+            dst[outputPos] = (unsigned char)highSurrogate;
+            dst[outputPos + 1] = (unsigned char)(highSurrogate >> 8);
+            dst[outputPos + 2] = (unsigned char)lowSurrogate;
+            dst[outputPos + 3] = (unsigned char)(lowSurrogate >> 8);
+            outputPos += 4;
+        }
+        else {
+            if (outputLen - outputPos < 2)
+                return UNICODE_BUILTIN_TIGHT;
+            dst[outputPos] = (unsigned char)codePoint;
+            dst[outputPos + 1] = (unsigned char)(codePoint >> 8);
+            outputPos += 2;
+        }
+    }
+    return outputPos;
+}
+
+#endif // RAGEPHOTOUNICODE_H
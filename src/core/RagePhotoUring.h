@@ -0,0 +1,196 @@
+/*****************************************************************************
+* libragephoto RAGE Photo Parser
+* Copyright (C) 2025 Syping
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* This software is provided as-is, no warranties are given to you, we are not
+* responsible for anything with use of the software, you are self responsible.
+*****************************************************************************/
+
+#ifndef RAGEPHOTOURING_H
+#define RAGEPHOTOURING_H
+
+/* Internal io_uring ring using raw syscalls, not part of the public API */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+typedef struct RagePhotoUring {
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    void *sqRing;
+    void *cqRing;
+    size_t sqRingSize;
+    size_t cqRingSize;
+    size_t sqesSize;
+    unsigned sqEntries;
+    unsigned sqeTail;
+    int fd;
+} RagePhotoUring;
+
+/* Sets up a ring with at least \p entries submission entries.
+* Returns false when io_uring is unavailable, e.g. old kernel or blocked by seccomp. */
+static inline bool uringInit(RagePhotoUring *ring, unsigned entries)
+{
+    struct io_uring_params params;
+    memset(ring, 0, sizeof(RagePhotoUring));
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0)
+        return false;
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cqRingSize > ring->sqRingSize)
+            ring->sqRingSize = ring->cqRingSize;
+        ring->cqRingSize = ring->sqRingSize;
+    }
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        close(ring->fd);
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cqRing = ring->sqRing;
+    }
+    else {
+        ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cqRing == MAP_FAILED) {
+            munmap(ring->sqRing, ring->sqRingSize);
+            close(ring->fd);
+            return false;
+        }
+    }
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        if (ring->cqRing != ring->sqRing)
+            munmap(ring->cqRing, ring->cqRingSize);
+        munmap(ring->sqRing, ring->sqRingSize);
+        close(ring->fd);
+        return false;
+    }
+    char *sqRing = (char*)ring->sqRing;
+    char *cqRing = (char*)ring->cqRing;
+    ring->sqes = (struct io_uring_sqe*)sqes;
+    ring->sqHead = (unsigned*)(sqRing + params.sq_off.head);
+    ring->sqTail = (unsigned*)(sqRing + params.sq_off.tail);
+    ring->sqMask = (unsigned*)(sqRing + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned*)(sqRing + params.sq_off.array);
+    ring->cqHead = (unsigned*)(cqRing + params.cq_off.head);
+    ring->cqTail = (unsigned*)(cqRing + params.cq_off.tail);
+    ring->cqMask = (unsigned*)(cqRing + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cqRing + params.cq_off.cqes);
+    ring->sqEntries = params.sq_entries;
+    ring->sqeTail = *ring->sqTail;
+    return true;
+}
+
+static inline void uringClose(RagePhotoUring *ring)
+{
+    munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqRing != ring->sqRing)
+        munmap(ring->cqRing, ring->cqRingSize);
+    munmap(ring->sqRing, ring->sqRingSize);
+    close(ring->fd);
+}
+
+/* Returns a zeroed submission entry, NULL when the submission queue is full. */
+static inline struct io_uring_sqe* uringGetSqe(RagePhotoUring *ring)
+{
+    const unsigned head = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    if (ring->sqeTail - head >= ring->sqEntries)
+        return NULL;
+    const unsigned index = ring->sqeTail & *ring->sqMask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sqArray[index] = index;
+    ring->sqeTail++;
+    return sqe;
+}
+
+static inline void uringPrepOpen(struct io_uring_sqe *sqe, const char *filename, uint64_t userData)
+{
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)filename;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe->user_data = userData;
+}
+
+static inline void uringPrepRead(struct io_uring_sqe *sqe, int fd, char *buffer, uint32_t length, uint64_t offset, uint64_t userData)
+{
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buffer;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = userData;
+}
+
+/* Submits all prepared entries and waits for at least \p waitCount completions. */
+static inline int uringSubmitAndWait(RagePhotoUring *ring, unsigned waitCount)
+{
+    const unsigned submitCount = ring->sqeTail - *ring->sqTail;
+    __atomic_store_n(ring->sqTail, ring->sqeTail, __ATOMIC_RELEASE);
+    int result;
+    do {
+        result = (int)syscall(__NR_io_uring_enter, ring->fd, submitCount, waitCount, IORING_ENTER_GETEVENTS, NULL, 0);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
+
+/* Waits for at least \p waitCount completions without submitting entries. */
+static inline int uringWait(RagePhotoUring *ring, unsigned waitCount)
+{
+    int result;
+    do {
+        result = (int)syscall(__NR_io_uring_enter, ring->fd, 0, waitCount, IORING_ENTER_GETEVENTS, NULL, 0);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
+
+/* Returns the number of prepared entries the kernel hasn't taken from the submission queue. */
+static inline unsigned uringUnconsumed(RagePhotoUring *ring)
+{
+    return ring->sqeTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+}
+
+/* Pops the next completion, returns false when the completion queue is empty. */
+static inline bool uringPopCqe(RagePhotoUring *ring, uint64_t *userData, int32_t *result)
+{
+    const unsigned head = *ring->cqHead;
+    if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE))
+        return false;
+    const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+    *userData = cqe->user_data;
+    *result = cqe->res;
+    __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+#endif // RAGEPHOTOURING_H
@@ -0,0 +1,711 @@
+/*****************************************************************************
+* libragephoto RAGE Photo Parser
+* Copyright (C) 2021-2025 Syping
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* This software is provided as-is, no warranties are given to you, we are not
+* responsible for anything with use of the software, you are self responsible.
+*****************************************************************************/
+
+#ifndef RAGEPHOTO_BASIC_HPP
+#define RAGEPHOTO_BASIC_HPP
+
+#ifdef __cplusplus
+#include "RagePhoto.hpp"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace ragephoto {
+
+/** Sections kept by the storage of a basic_photo. */
+enum basic_section : size_t {
+    BASIC_SECTION_HEADER = 0, /**< Raw UTF-16LE header, always 256 bytes */
+    BASIC_SECTION_JPEG = 1, /**< JPEG data */
+    BASIC_SECTION_JSON = 2, /**< JSON data */
+    BASIC_SECTION_TITLE = 3, /**< Title data */
+    BASIC_SECTION_DESC = 4, /**< Description data */
+    BASIC_SECTION_COUNT = 5 /**< Number of sections */
+};
+
+/**
+* \brief Compile-time layout of a Photo format.
+*
+* Specialized for RagePhoto::PhotoFormat::GTA5 and RagePhoto::PhotoFormat::RDR2.
+*/
+template<uint32_t PhotoFormat>
+struct format_traits;
+
+/** GTA V Photo layout. */
+template<>
+struct format_traits<RagePhoto::PhotoFormat::GTA5>
+{
+    static constexpr uint32_t photoFormat = RagePhoto::PhotoFormat::GTA5; /**< Format identifier */
+    static constexpr uint32_t headerSize = RagePhoto::GTA5_HEADERSIZE; /**< Header size, offset of the EOF field */
+    static constexpr uint32_t signInitial = RagePhoto::SignInitials::SIGTA5; /**< JPEG sign initial */
+    static constexpr uint32_t photoBuffer = RagePhoto::DEFAULT_GTA5_PHOTOBUFFER; /**< Default Photo Buffer Size */
+    static constexpr uint32_t jsonBuffer = RagePhoto::DEFAULT_JSONBUFFER; /**< Default JSON Buffer Size */
+    static constexpr uint32_t titlBuffer = RagePhoto::DEFAULT_TITLBUFFER; /**< Default Title Buffer Size */
+    static constexpr uint32_t descBuffer = RagePhoto::DEFAULT_DESCBUFFER; /**< Default Description Buffer Size */
+    static constexpr bool headerSum2 = false; /**< Second header checksum present */
+};
+
+/** RDR 2 Photo layout. */
+template<>
+struct format_traits<RagePhoto::PhotoFormat::RDR2>
+{
+    static constexpr uint32_t photoFormat = RagePhoto::PhotoFormat::RDR2; /**< Format identifier */
+    static constexpr uint32_t headerSize = RagePhoto::RDR2_HEADERSIZE; /**< Header size, offset of the EOF field */
+    static constexpr uint32_t signInitial = RagePhoto::SignInitials::SIRDR2; /**< JPEG sign initial */
+    static constexpr uint32_t photoBuffer = RagePhoto::DEFAULT_RDR2_PHOTOBUFFER; /**< Default Photo Buffer Size */
+    static constexpr uint32_t jsonBuffer = RagePhoto::DEFAULT_JSONBUFFER; /**< Default JSON Buffer Size */
+    static constexpr uint32_t titlBuffer = RagePhoto::DEFAULT_TITLBUFFER; /**< Default Title Buffer Size */
+    static constexpr uint32_t descBuffer = RagePhoto::DEFAULT_DESCBUFFER; /**< Default Description Buffer Size */
+    static constexpr bool headerSum2 = true; /**< Second header checksum present */
+};
+
+/**
+* \brief Storage owning its sections, allocated with the Allocator of the basic_photo.
+*
+* Section buffers are kept on clear and only grown by later loads.
+*/
+struct owning_storage
+{
+    /** Sections of a basic_photo. */
+    template<typename Allocator>
+    class sections
+    {
+    public:
+        /** Allocator used for the section buffers. */
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<char> allocator_type;
+        /** Constructs empty sections. */
+        explicit sections(const Allocator &allocator = Allocator()) :
+            m_allocator(allocator), m_data(), m_size(), m_capacity() {
+        }
+        sections(const sections&) = delete;
+        sections& operator=(const sections&) = delete;
+        ~sections() {
+            for (size_t i = 0; i < BASIC_SECTION_COUNT; i++) {
+                if (m_data[i])
+                    std::allocator_traits<allocator_type>::deallocate(m_allocator, m_data[i], m_capacity[i]);
+            }
+        }
+        /** Copies a section, returns false when it can't be allocated. */
+        bool assign(size_t section, const char *data, uint32_t size) {
+            if (size > m_capacity[section]) {
+                char *buffer;
+                try {
+                    buffer = std::allocator_traits<allocator_type>::allocate(m_allocator, size);
+                }
+                catch (const std::bad_alloc&) {
+                    return false;
+                }
+                if (m_data[section])
+                    std::allocator_traits<allocator_type>::deallocate(m_allocator, m_data[section], m_capacity[section]);
+                m_data[section] = buffer;
+                m_capacity[section] = size;
+            }
+            if (size)
+                std::memcpy(m_data[section], data, size);
+            m_size[section] = size;
+            return true;
+        }
+        /** Empties all sections. */
+        void clear() {
+            for (size_t i = 0; i < BASIC_SECTION_COUNT; i++)
+                m_size[i] = 0;
+        }
+        /** Returns the section data, nullptr when empty. */
+        const char* data(size_t section) const {
+            return m_size[section] ? m_data[section] : nullptr;
+        }
+        /** Returns the section size. */
+        uint32_t size(size_t section) const {
+            return m_size[section];
+        }
+        /** Returns the largest section buffer size, unbounded. */
+        static uint32_t max_size(size_t) {
+            return UINT32_MAX;
+        }
+
+    private:
+        allocator_type m_allocator;
+        char *m_data[BASIC_SECTION_COUNT];
+        uint32_t m_size[BASIC_SECTION_COUNT];
+        uint32_t m_capacity[BASIC_SECTION_COUNT];
+    };
+};
+
+/**
+* \brief Storage borrowing its sections from the loaded data, nothing is copied.
+*
+* Loaded and set data must outlive the basic_photo or its next load.
+*/
+struct view_storage
+{
+    /** Sections of a basic_photo. */
+    template<typename Allocator>
+    class sections
+    {
+    public:
+        /** Constructs empty sections, the allocator is unused. */
+        explicit sections(const Allocator& = Allocator()) :
+            m_data(), m_size() {
+        }
+        /** Borrows a section, always succeeds. */
+        bool assign(size_t section, const char *data, uint32_t size) {
+            m_data[section] = data;
+            m_size[section] = size;
+            return true;
+        }
+        /** Empties all sections. */
+        void clear() {
+            for (size_t i = 0; i < BASIC_SECTION_COUNT; i++)
+                m_size[i] = 0;
+        }
+        /** Returns the section data, nullptr when empty. */
+        const char* data(size_t section) const {
+            return m_size[section] ? m_data[section] : nullptr;
+        }
+        /** Returns the section size. */
+        uint32_t size(size_t section) const {
+            return m_size[section];
+        }
+        /** Returns the largest section buffer size, unbounded. */
+        static uint32_t max_size(size_t) {
+            return UINT32_MAX;
+        }
+
+    private:
+        const char *m_data[BASIC_SECTION_COUNT];
+        uint32_t m_size[BASIC_SECTION_COUNT];
+    };
+};
+
+/**
+* \brief Storage keeping its sections inline with fixed capacities, nothing is allocated.
+*
+* Sections or section buffers larger than their capacity fail to load or set with the malloc error of the section,
+* which bounds the work of load, save and saveSize() by the capacities.
+*/
+template<uint32_t JpegCapacity = RagePhoto::DEFAULT_RDR2_PHOTOBUFFER, uint32_t JsonCapacity = RagePhoto::DEFAULT_JSONBUFFER,
+         uint32_t TitlCapacity = RagePhoto::DEFAULT_TITLBUFFER, uint32_t DescCapacity = RagePhoto::DEFAULT_DESCBUFFER>
+struct fixed_storage
+{
+    static_assert(JpegCapacity && JsonCapacity && TitlCapacity && DescCapacity, "fixed_storage capacities must not be zero");
+
+    /** Sections of a basic_photo. */
+    template<typename Allocator>
+    class sections
+    {
+    public:
+        /** Constructs empty sections, the allocator is unused. */
+        explicit sections(const Allocator& = Allocator()) :
+            m_size() {
+        }
+        /** Copies a section, returns false when it exceeds the capacity. */
+        bool assign(size_t section, const char *data, uint32_t size) {
+            if (size > max_size(section))
+                return false;
+            if (size)
+                std::memcpy(buffer(section), data, size);
+            m_size[section] = size;
+            return true;
+        }
+        /** Empties all sections. */
+        void clear() {
+            for (size_t i = 0; i < BASIC_SECTION_COUNT; i++)
+                m_size[i] = 0;
+        }
+        /** Returns the section data, nullptr when empty. */
+        const char* data(size_t section) const {
+            return m_size[section] ? const_cast<sections*>(this)->buffer(section) : nullptr;
+        }
+        /** Returns the section size. */
+        uint32_t size(size_t section) const {
+            return m_size[section];
+        }
+        /** Returns the largest section buffer size, the section capacity. */
+        static uint32_t max_size(size_t section) {
+            switch (section) {
+            case BASIC_SECTION_HEADER:
+                return 256;
+            case BASIC_SECTION_JPEG:
+                return JpegCapacity;
+            case BASIC_SECTION_JSON:
+                return JsonCapacity;
+            case BASIC_SECTION_TITLE:
+                return TitlCapacity;
+            default:
+                return DescCapacity;
+            }
+        }
+
+    private:
+        char* buffer(size_t section) {
+            switch (section) {
+            case BASIC_SECTION_HEADER:
+                return m_header;
+            case BASIC_SECTION_JPEG:
+                return m_jpeg;
+            case BASIC_SECTION_JSON:
+                return m_json;
+            case BASIC_SECTION_TITLE:
+                return m_title;
+            default:
+                return m_description;
+            }
+        }
+        uint32_t m_size[BASIC_SECTION_COUNT];
+        char m_header[256];
+        char m_json[JsonCapacity];
+        char m_title[TitlCapacity];
+        char m_description[DescCapacity];
+        char m_jpeg[JpegCapacity];
+    };
+};
+
+/**
+* \brief Header-only GTA V and RDR 2 Photo Parser with pluggable storage.
+* \class ragephoto::basic_photo ragephoto_basic.hpp ragephoto_basic
+*
+* Photos of a format known at compile time are parsed through load<PhotoFormat>() without branching on the format.
+* The header is kept as the raw 256 bytes of UTF-16LE, it is not converted to UTF-8.
+*/
+template<typename Storage = owning_storage, typename Allocator = std::allocator<char>>
+class basic_photo
+{
+public:
+    /** Storage of the sections. */
+    typedef typename Storage::template sections<Allocator> storage_type;
+
+    /** Constructs an empty GTA V Photo. */
+    basic_photo() : m_storage() {
+        clear();
+    }
+    /** Constructs an empty GTA V Photo with an allocator for the storage. */
+    explicit basic_photo(const Allocator &allocator) : m_storage(allocator) {
+        clear();
+    }
+    /** Resets the Photo to an empty GTA V Photo, the storage keeps its buffers. */
+    void clear() {
+        m_storage.clear();
+        m_photoFormat = RagePhoto::PhotoFormat::GTA5;
+        m_headerSum = 0;
+        m_headerSum2 = 0;
+        m_jpegBuffer = defaultBuffer(BASIC_SECTION_JPEG, format_traits<RagePhoto::PhotoFormat::GTA5>::photoBuffer);
+        m_jsonBuffer = defaultBuffer(BASIC_SECTION_JSON, format_traits<RagePhoto::PhotoFormat::GTA5>::jsonBuffer);
+        m_titlBuffer = defaultBuffer(BASIC_SECTION_TITLE, format_traits<RagePhoto::PhotoFormat::GTA5>::titlBuffer);
+        m_descBuffer = defaultBuffer(BASIC_SECTION_DESC, format_traits<RagePhoto::PhotoFormat::GTA5>::descBuffer);
+        m_error = RagePhoto::Error::Uninitialised;
+    }
+    /** Loads a Photo of a format known at compile time.
+    * \param data Photo data
+    * \param size Photo data size
+    */
+    template<uint32_t PhotoFormat>
+    bool load(const char *data, size_t size) {
+        typedef format_traits<PhotoFormat> traits;
+        clear();
+        if (size < traits::headerSize + 28)
+            return fail(incompleteError<PhotoFormat>(data, size));
+        if (readUInt32(data) != PhotoFormat)
+            return fail(RagePhoto::Error::IncompatibleFormat); // 2
+        if (traits::headerSum2 && readUInt32(&data[260 + 4]) != 0)
+            return fail(RagePhoto::Error::IncompatibleFormat); // 2
+        if (readUInt32(&data[traits::headerSize + 16]) != MARKER_JPEG)
+            return fail(RagePhoto::Error::IncorrectJpegMarker); // 13
+        m_photoFormat = PhotoFormat;
+        m_headerSum = readUInt32(&data[260]);
+        m_headerSum2 = traits::headerSum2 ? readUInt32(&data[260 + 8]) : 0;
+        const uint32_t jpegBuffer = readUInt32(&data[traits::headerSize + 20]);
+        const uint32_t jpegSize = readUInt32(&data[traits::headerSize + 24]);
+        if (!m_storage.assign(BASIC_SECTION_HEADER, &data[4], 256))
+            return fail(RagePhoto::Error::HeaderMallocError); // 4
+
+        size_t pos = traits::headerSize + 28;
+        if (size - pos < jpegSize)
+            return fail(RagePhoto::Error::PhotoReadError); // 17
+        // Buffers are only taken over when the storage can hold them
+        if (jpegBuffer > storage_type::max_size(BASIC_SECTION_JPEG) || !m_storage.assign(BASIC_SECTION_JPEG, &data[pos], jpegSize))
+            return fail(RagePhoto::Error::PhotoMallocError); // 16
+        m_jpegBuffer = jpegBuffer;
+        pos += jpegSize;
+        pos += static_cast<uint32_t>(m_jpegBuffer - jpegSize);
+
+        uint32_t *buffers[3] = {&m_jsonBuffer, &m_titlBuffer, &m_descBuffer};
+        const uint32_t markers[3] = {MARKER_JSON, MARKER_TITL, MARKER_DESC};
+        const int32_t errors[3] = {RagePhoto::Error::IncompleteJsonMarker, RagePhoto::Error::IncompleteTitleMarker, RagePhoto::Error::IncompleteDescMarker}; // 18, 23, 28
+        for (size_t i = 0; i < 3; i++) {
+            // Errors follow the incomplete marker error: incorrect marker, incomplete buffer, malloc, read
+            const size_t remaining = (pos < size) ? size - pos : 0;
+            if (remaining < 4)
+                return fail(errors[i]);
+            if (readUInt32(&data[pos]) != markers[i])
+                return fail(errors[i] + 1);
+            if (remaining < 8)
+                return fail(errors[i] + 2);
+            const uint32_t buffer = readUInt32(&data[pos + 4]);
+            pos += 8;
+            if (size - pos < buffer)
+                return fail(errors[i] + 4);
+            if (!m_storage.assign(BASIC_SECTION_JSON + i, &data[pos], buffer))
+                return fail(errors[i] + 3);
+            *buffers[i] = buffer;
+            pos += buffer;
+        }
+
+        if (pos > size || size - pos < 4)
+            return fail(RagePhoto::Error::IncompleteJendMarker); // 33
+        if (readUInt32(&data[pos]) != MARKER_JEND)
+            return fail(RagePhoto::Error::IncorrectJendMarker); // 34
+        m_error = RagePhoto::Error::NoError; // 255
+        return true;
+    }
+    /** Loads a GTA V or RDR 2 Photo.
+    * \param data Photo data
+    * \param size Photo data size
+    */
+    bool load(const char *data, size_t size) {
+        if (size < 4) {
+            clear();
+            return fail(RagePhoto::Error::NoFormatIdentifier); // 1
+        }
+        switch (readUInt32(data)) {
+        case RagePhoto::PhotoFormat::GTA5:
+            return load<RagePhoto::PhotoFormat::GTA5>(data, size);
+        case RagePhoto::PhotoFormat::RDR2:
+            return load<RagePhoto::PhotoFormat::RDR2>(data, size);
+        default:
+            clear();
+            return fail(RagePhoto::Error::IncompatibleFormat); // 2
+        }
+    }
+    /** Saves the Photo in a format known at compile time.
+    * \param data Photo data, at least saveSize<PhotoFormat>() bytes
+    */
+    template<uint32_t PhotoFormat>
+    bool save(char *data) {
+        typedef format_traits<PhotoFormat> traits;
+        if (!m_storage.data(BASIC_SECTION_HEADER))
+            return fail(RagePhoto::Error::IncompleteHeader); // 3
+        const uint32_t jpegSize = m_storage.size(BASIC_SECTION_JPEG);
+        if (jpegSize > m_jpegBuffer)
+            return fail(RagePhoto::Error::PhotoBufferTight); // 36
+        const uint32_t buffers[3] = {m_jsonBuffer, m_titlBuffer, m_descBuffer};
+        const uint32_t markers[3] = {MARKER_JSON, MARKER_TITL, MARKER_DESC};
+        const int32_t errors[3] = {RagePhoto::Error::JsonBufferTight, RagePhoto::Error::TitleBufferTight, RagePhoto::Error::DescBufferTight}; // 37, 38, 39
+        size_t lengths[3];
+        for (size_t i = 0; i < 3; i++) {
+            lengths[i] = textSize(BASIC_SECTION_JSON + i);
+            if (lengths[i] > buffers[i])
+                return fail(errors[i]);
+        }
+
+        const uint32_t jsonOffset = m_jpegBuffer + UINT32_C(28);
+        const uint32_t titlOffset = jsonOffset + m_jsonBuffer + UINT32_C(8);
+        const uint32_t descOffset = titlOffset + m_titlBuffer + UINT32_C(8);
+        const uint32_t endOfFile = descOffset + m_descBuffer + UINT32_C(12);
+        writeUInt32(PhotoFormat, &data[0]);
+        std::memcpy(&data[4], m_storage.data(BASIC_SECTION_HEADER), 256);
+        writeUInt32(m_headerSum, &data[260]);
+        if (traits::headerSum2) {
+            writeUInt32(0, &data[260 + 4]);
+            writeUInt32(m_headerSum2, &data[260 + 8]);
+        }
+        writeUInt32(endOfFile, &data[traits::headerSize]);
+        writeUInt32(jsonOffset, &data[traits::headerSize + 4]);
+        writeUInt32(titlOffset, &data[traits::headerSize + 8]);
+        writeUInt32(descOffset, &data[traits::headerSize + 12]);
+        writeUInt32(MARKER_JPEG, &data[traits::headerSize + 16]);
+        writeUInt32(m_jpegBuffer, &data[traits::headerSize + 20]);
+        writeUInt32(jpegSize, &data[traits::headerSize + 24]);
+
+        size_t pos = traits::headerSize + 28;
+        pos = writeSection(data, pos, m_storage.data(BASIC_SECTION_JPEG), jpegSize, m_jpegBuffer);
+        for (size_t i = 0; i < 3; i++) {
+            writeUInt32(markers[i], &data[pos]);
+            writeUInt32(buffers[i], &data[pos + 4]);
+            pos = writeSection(data, pos + 8, m_storage.data(BASIC_SECTION_JSON + i), lengths[i], buffers[i]);
+        }
+        writeUInt32(MARKER_JEND, &data[pos]);
+        m_error = RagePhoto::Error::NoError; // 255
+        return true;
+    }
+    /** Saves the Photo in its format.
+    * \param data Photo data, at least saveSize() bytes
+    */
+    bool save(char *data) {
+        switch (m_photoFormat) {
+        case RagePhoto::PhotoFormat::GTA5:
+            return save<RagePhoto::PhotoFormat::GTA5>(data);
+        case RagePhoto::PhotoFormat::RDR2:
+            return save<RagePhoto::PhotoFormat::RDR2>(data);
+        default:
+            return fail(RagePhoto::Error::IncompatibleFormat); // 2
+        }
+    }
+    /** Returns the save size of the Photo in a format known at compile time. */
+    template<uint32_t PhotoFormat>
+    size_t saveSize() const {
+        return static_cast<size_t>(format_traits<PhotoFormat>::headerSize) + 56 +
+                m_jpegBuffer + m_jsonBuffer + m_titlBuffer + m_descBuffer;
+    }
+    /** Returns the save size of the Photo in its format. */
+    size_t saveSize() const {
+        return (m_photoFormat == RagePhoto::PhotoFormat::RDR2) ? saveSize<RagePhoto::PhotoFormat::RDR2>() : saveSize<RagePhoto::PhotoFormat::GTA5>();
+    }
+    /** Returns the last error occurred. */
+    int32_t error() const {
+        return m_error;
+    }
+    /** Returns the Photo Format (GTA V or RDR 2). */
+    uint32_t format() const {
+        return m_photoFormat;
+    }
+    /** Returns the raw UTF-16LE Photo header, 256 bytes or nullptr. */
+    const char* header() const {
+        return m_storage.data(BASIC_SECTION_HEADER);
+    }
+    /** Returns the header checksum. */
+    uint32_t headerSum() const {
+        return m_headerSum;
+    }
+    /** Returns the header checksum 2 (RDR 2 only). */
+    uint32_t headerSum2() const {
+        return m_headerSum2;
+    }
+    /** Returns the Photo JPEG data. */
+    const char* jpegData() const {
+        return m_storage.data(BASIC_SECTION_JPEG);
+    }
+    /** Returns the Photo JPEG data size. */
+    uint32_t jpegSize() const {
+        return m_storage.size(BASIC_SECTION_JPEG);
+    }
+    /** Returns the Photo JPEG buffer size. */
+    uint32_t jpegBuffer() const {
+        return m_jpegBuffer;
+    }
+    /** Returns the Photo JPEG sign for a format known at compile time. */
+    template<uint32_t PhotoFormat>
+    uint64_t jpegSign() const {
+        const char *jpeg = m_storage.data(BASIC_SECTION_JPEG);
+        if (!jpeg)
+            return 0;
+        uint32_t val = format_traits<PhotoFormat>::signInitial;
+        const uint32_t size = m_storage.size(BASIC_SECTION_JPEG);
+        for (uint32_t i = 0; i != size; i++) {
+            val += jpeg[i];
+            val += val << 10;
+            val ^= val >> 6;
+        }
+        val += val << 3;
+        val ^= val >> 11;
+        val += val << 15;
+        return (UINT64_C(0x100000000000000) | val);
+    }
+    /** Returns the Photo JPEG sign. */
+    uint64_t jpegSign() const {
+        return (m_photoFormat == RagePhoto::PhotoFormat::RDR2) ? jpegSign<RagePhoto::PhotoFormat::RDR2>() : jpegSign<RagePhoto::PhotoFormat::GTA5>();
+    }
+    /** Returns the Photo JSON data, up to jsonBuffer() bytes. */
+    const char* json() const {
+        return m_storage.data(BASIC_SECTION_JSON);
+    }
+    /** Returns the Photo JSON buffer size. */
+    uint32_t jsonBuffer() const {
+        return m_jsonBuffer;
+    }
+    /** Returns the Photo title, up to titleBuffer() bytes. */
+    const char* title() const {
+        return m_storage.data(BASIC_SECTION_TITLE);
+    }
+    /** Returns the Photo title buffer size. */
+    uint32_t titleBuffer() const {
+        return m_titlBuffer;
+    }
+    /** Returns the Photo description, up to descriptionBuffer() bytes. */
+    const char* description() const {
+        return m_storage.data(BASIC_SECTION_DESC);
+    }
+    /** Returns the Photo description buffer size. */
+    uint32_t descriptionBuffer() const {
+        return m_descBuffer;
+    }
+    /** Returns the section storage. */
+    const storage_type& storage() const {
+        return m_storage;
+    }
+    /** Sets the Photo Format (GTA V or RDR 2). */
+    void setFormat(uint32_t photoFormat) {
+        m_photoFormat = photoFormat;
+    }
+    /** Sets the raw UTF-16LE Photo header.
+    * \param header Header data, 256 bytes
+    * \param headerSum Header checksum
+    * \param headerSum2 Header checksum 2 (RDR 2 only)
+    */
+    bool setHeader(const char *header, uint32_t headerSum, uint32_t headerSum2 = 0) {
+        if (!m_storage.assign(BASIC_SECTION_HEADER, header, 256))
+            return fail(RagePhoto::Error::HeaderMallocError); // 4
+        m_headerSum = headerSum;
+        m_headerSum2 = headerSum2;
+        m_error = RagePhoto::Error::NoError; // 255
+        return true;
+    }
+    /** Sets the Photo JPEG data.
+    * \param data JPEG data
+    * \param size JPEG data size
+    * \param bufferSize JPEG buffer size, 0 keeps the current one
+    */
+    bool setJpeg(const char *data, uint32_t size, uint32_t bufferSize = 0) {
+        return setSection(BASIC_SECTION_JPEG, data, size, &m_jpegBuffer, bufferSize, RagePhoto::Error::PhotoMallocError); // 16
+    }
+    /** Sets the Photo JSON data.
+    * \param json JSON data, null-terminated
+    * \param bufferSize JSON buffer size, 0 keeps the current one
+    */
+    bool setJson(const char *json, uint32_t bufferSize = 0) {
+        return setSection(BASIC_SECTION_JSON, json, stringSize(json), &m_jsonBuffer, bufferSize, RagePhoto::Error::JsonMallocError); // 21
+    }
+    /** Sets the Photo title.
+    * \param title Title, null-terminated
+    * \param bufferSize Title buffer size, 0 keeps the current one
+    */
+    bool setTitle(const char *title, uint32_t bufferSize = 0) {
+        return setSection(BASIC_SECTION_TITLE, title, stringSize(title), &m_titlBuffer, bufferSize, RagePhoto::Error::TitleMallocError); // 26
+    }
+    /** Sets the Photo description.
+    * \param description Description, null-terminated
+    * \param bufferSize Description buffer size, 0 keeps the current one
+    */
+    bool setDescription(const char *description, uint32_t bufferSize = 0) {
+        return setSection(BASIC_SECTION_DESC, description, stringSize(description), &m_descBuffer, bufferSize, RagePhoto::Error::DescMallocError); // 31
+    }
+
+private:
+    static constexpr uint32_t MARKER_JPEG = UINT32_C(0x4745504A);
+    static constexpr uint32_t MARKER_JSON = UINT32_C(0x4E4F534A);
+    static constexpr uint32_t MARKER_TITL = UINT32_C(0x4C544954);
+    static constexpr uint32_t MARKER_DESC = UINT32_C(0x43534544);
+    static constexpr uint32_t MARKER_JEND = UINT32_C(0x444E454A);
+
+    bool fail(int32_t error) {
+        m_error = error;
+        return false;
+    }
+    template<uint32_t PhotoFormat>
+    static int32_t incompleteError(const char *data, size_t size) {
+        // Walks the fixed fields in file order, only reached when the Photo ends before them
+        typedef format_traits<PhotoFormat> traits;
+        if (size < 4)
+            return RagePhoto::Error::NoFormatIdentifier; // 1
+        if (readUInt32(data) != PhotoFormat)
+            return RagePhoto::Error::IncompatibleFormat; // 2
+        if (size < 260)
+            return RagePhoto::Error::IncompleteHeader; // 3
+        if (traits::headerSum2) {
+            if (size < 260 + 8)
+                return RagePhoto::Error::IncompleteChecksum; // 7
+            if (readUInt32(&data[260 + 4]) != 0)
+                return RagePhoto::Error::IncompatibleFormat; // 2
+        }
+        if (size < traits::headerSize)
+            return RagePhoto::Error::IncompleteChecksum; // 7
+        if (size < traits::headerSize + 4)
+            return RagePhoto::Error::IncompleteEOF; // 8
+        if (size < traits::headerSize + 8)
+            return RagePhoto::Error::IncompleteJsonOffset; // 9
+        if (size < traits::headerSize + 12)
+            return RagePhoto::Error::IncompleteTitleOffset; // 10
+        if (size < traits::headerSize + 16)
+            return RagePhoto::Error::IncompleteDescOffset; // 11
+        if (size < traits::headerSize + 20)
+            return RagePhoto::Error::IncompleteJpegMarker; // 12
+        if (readUInt32(&data[traits::headerSize + 16]) != MARKER_JPEG)
+            return RagePhoto::Error::IncorrectJpegMarker; // 13
+        if (size < traits::headerSize + 24)
+            return RagePhoto::Error::IncompletePhotoBuffer; // 14
+        return RagePhoto::Error::IncompletePhotoSize; // 15
+    }
+    bool setSection(size_t section, const char *data, uint32_t size, uint32_t *buffer, uint32_t bufferSize, int32_t error) {
+        if (bufferSize > storage_type::max_size(section) || !m_storage.assign(section, data, size))
+            return fail(error);
+        if (bufferSize != 0)
+            *buffer = bufferSize;
+        m_error = RagePhoto::Error::NoError; // 255
+        return true;
+    }
+    static uint32_t defaultBuffer(size_t section, uint32_t bufferSize) {
+        // Default buffers are capped by the storage, so an empty Photo always saves within it
+        const uint32_t maxSize = storage_type::max_size(section);
+        return (bufferSize > maxSize) ? maxSize : bufferSize;
+    }
+    static uint32_t stringSize(const char *data) {
+        return data ? static_cast<uint32_t>(std::strlen(data) + 1) : 0;
+    }
+    size_t textSize(size_t section) const {
+        // Text sections are saved up to their terminator like the RagePhoto strings
+        const char *data = m_storage.data(section);
+        if (!data)
+            return 0;
+        const uint32_t size = m_storage.size(section);
+        const void *terminator = std::memchr(data, '\0', size);
+        return terminator ? static_cast<size_t>(static_cast<const char*>(terminator) - data) + 1 : static_cast<size_t>(size) + 1;
+    }
+    static size_t writeSection(char *output, size_t pos, const char *data, size_t size, uint32_t buffer) {
+        if (size)
+            std::memcpy(&output[pos], data, size);
+        std::memset(&output[pos + size], 0, buffer - size);
+        return pos + buffer;
+    }
+    static uint32_t readUInt32(const char *data) {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+        return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+                static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+    }
+    static void writeUInt32(uint32_t value, char *output) {
+        unsigned char *bytes = reinterpret_cast<unsigned char*>(output);
+        bytes[0] = static_cast<unsigned char>(value);
+        bytes[1] = static_cast<unsigned char>(value >> 8);
+        bytes[2] = static_cast<unsigned char>(value >> 16);
+        bytes[3] = static_cast<unsigned char>(value >> 24);
+    }
+    storage_type m_storage;
+    uint32_t m_photoFormat;
+    uint32_t m_headerSum;
+    uint32_t m_headerSum2;
+    uint32_t m_jpegBuffer;
+    uint32_t m_jsonBuffer;
+    uint32_t m_titlBuffer;
+    uint32_t m_descBuffer;
+    int32_t m_error;
+};
+
+/**
+* \brief Heap-free GTA V and RDR 2 Photo Parser with inline section storage.
+*
+* The default capacities fit every Photo with default buffer sizes, about 1 MiB is kept inline,
+* so the Photo is best placed in static storage or in an object owned by the caller rather than on the stack.
+* Constructing, loading and saving never allocate.
+*/
+template<uint32_t JpegCapacity = RagePhoto::DEFAULT_RDR2_PHOTOBUFFER, uint32_t JsonCapacity = RagePhoto::DEFAULT_JSONBUFFER,
+         uint32_t TitlCapacity = RagePhoto::DEFAULT_TITLBUFFER, uint32_t DescCapacity = RagePhoto::DEFAULT_DESCBUFFER>
+using fixed_photo = basic_photo<fixed_storage<JpegCapacity, JsonCapacity, TitlCapacity, DescCapacity>>;
+
+} // ragephoto
+
+#endif // __cplusplus
+
+#endif // RAGEPHOTO_BASIC_HPP
@@ -22,7 +22,11 @@
 #ifdef __cplusplus
 #include "RagePhoto.h"
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace ragephoto_c {
 
@@ -103,13 +107,41 @@ public:
         if (!instance)
             throw std::runtime_error("ragephoto_t instance can't be allocated");
     }
+    photo(const photo&) = delete;
+    /** Takes over the sections of a RagePhoto object, the moved-from object can only be assigned or destroyed. */
+    photo(photo &&ragePhoto) noexcept {
+        instance = ragePhoto.instance;
+        ragePhoto.instance = nullptr;
+    }
     ~photo() {
-        ragephoto_close(instance);
+        // Moved-from objects own no instance
+        if (instance)
+            ragephoto_close(instance);
+    }
+    photo& operator=(const photo&) = delete;
+    /** Swaps the sections with a RagePhoto object. */
+    photo& operator=(photo &&ragePhoto) noexcept {
+        swap(ragePhoto);
+        return *this;
     }
     /** Add a custom defined RagePhotoFormatParser. */
     void addParser(RagePhotoFormatParser *rp_parser) {
         ragephoto_addparser(instance, rp_parser);
     }
+    /** Takes ownership of a malloc allocated RagePhotoData object, the counterpart of releaseData(). */
+    bool adoptData(RagePhotoData *rp_data) {
+        if (!rp_data)
+            return false;
+        return ragephoto_setphotodata(instance, rp_data);
+    }
+    /** Registers a custom defined RagePhotoFormatParser for all instances. */
+    static bool registerParser(const RagePhotoFormatParser *rp_parser) {
+        return ragephoto_registerparser(rp_parser);
+    }
+    /** Unregisters the custom defined RagePhotoFormatParser of a Photo Format. */
+    static bool unregisterParser(uint32_t photoFormat) {
+        return ragephoto_unregisterparser(photoFormat);
+    }
     /** Resets the RagePhotoData object to default values. */
     static void clear(RagePhotoData *rp_data) {
         ragephotodata_clear(rp_data);
@@ -118,10 +150,26 @@ public:
     void clear() {
         ragephoto_clear(instance);
     }
+    /** Copies the sections of a RagePhoto object, arena storage sections are shared until they are changed. */
+    bool copyData(const photo &ragePhoto) {
+        return ragephoto_copyphotodata(instance, ragePhoto.instance);
+    }
+    /** Resets the RagePhotoData object to default values, keeping the section buffers for the next load. */
+    static void reset(RagePhotoData *rp_data) {
+        ragephotodata_reset(rp_data);
+    }
+    /** Resets the RagePhotoData object to default values, keeping the section buffers for the next load. */
+    void reset() {
+        ragephoto_reset(instance);
+    }
     /** Returns the internal RagePhotoData object. */
     RagePhotoData* data() {
         return ragephoto_getphotodata(instance);
     }
+    /** Releases ownership of the internal RagePhotoData object and replaces it with an empty one, nullptr when it can't be allocated. */
+    RagePhotoData* releaseData() {
+        return ragephoto_releasephotodata(instance);
+    }
     /** Loads a Photo from a const char*. */
     static bool load(const char *data, size_t size, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser) {
         return ragephotodata_load(rp_data, rp_parser, data, size);
@@ -145,6 +193,45 @@ public:
     bool loadFile(const char *filename) {
         return ragephoto_loadfile(instance, filename);
     }
+    /** Loads the metadata of a Photo from a const char*, skipping the JPEG data. */
+    static bool loadMeta(const char *data, size_t size, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser) {
+        return ragephotodata_loadmeta(rp_data, rp_parser, data, size);
+    }
+    /** Loads the metadata of a Photo from a const char*, skipping the JPEG data.
+    * \param data Photo data
+    * \param size Photo data size
+    */
+    bool loadMeta(const char *data, size_t size) {
+        return ragephoto_loadmeta(instance, data, size);
+    }
+    /** Loads the metadata of a Photo from a std::string, skipping the JPEG data.
+    * \param data Photo data
+    */
+    bool loadMeta(const std::string &data) {
+        return ragephoto_loadmeta(instance, data.data(), data.size());
+    }
+    /** Loads the metadata of a Photo from a file, only the header and metadata sections are read.
+    * \param filename File to load
+    */
+    bool loadMetaFile(const char *filename) {
+        return ragephoto_loadmetafile(instance, filename);
+    }
+    /** Loads the metadata of a Photo from a file descriptor, only the header and metadata sections are read.
+    *
+    * On POSIX systems the sections are read with pread and the file position is kept, the descriptor stays open.
+    * \param fd File descriptor to load from
+    */
+    bool loadMetaFd(int fd) {
+        return ragephoto_loadmetafd(instance, fd);
+    }
+    /** Validates the structure of a Photo without allocating, the header is decoded into a stack buffer.
+    * \param data Photo data
+    * \param size Photo data size
+    * \param rp_validation Validation report
+    */
+    static bool validate(const char *data, size_t size, RagePhotoValidation *rp_validation) {
+        return ragephoto_validate(data, size, rp_validation);
+    }
     /** Returns the last error occurred. */
     int32_t error() const {
         return ragephoto_error(instance);
@@ -183,14 +270,33 @@ public:
     static uint64_t jpegSign(RagePhotoData *rp_data) {
         return ragephotodata_getphotosign(rp_data);
     }
-    /** Returns the Photo JPEG sign. */
+    /** Returns the Photo JPEG sign, the cache is only read and a missing sign is computed without storing it. */
     uint64_t jpegSign(uint32_t photoFormat) const {
+        // Signed through a view of the data, a view never writes the cache of the Photo
+        const RagePhotoData *rp_data = ragephoto_getphotodata(instance);
+        RagePhotoView rp_view = {};
+        rp_view.jpeg = rp_data->jpeg;
+        rp_view.jpegSize = rp_data->jpegSize;
+        rp_view.jpegSign = rp_data->jpegSign;
+        rp_view.signFormat = rp_data->signFormat;
+        return ragephotoview_getphotosignf(&rp_view, photoFormat);
+    }
+    /** Returns the Photo JPEG sign, the cache is only read and a missing sign is computed without storing it. */
+    uint64_t jpegSign() const {
+        return jpegSign(format());
+    }
+    /** Returns the Photo JPEG sign, cached per Photo Format until the JPEG is changed. */
+    uint64_t jpegSign(uint32_t photoFormat) {
         return ragephoto_getphotosignf(instance, photoFormat);
     }
-    /** Returns the Photo JPEG sign. */
-    uint64_t jpegSign() const {
+    /** Returns the Photo JPEG sign, cached per Photo Format until the JPEG is changed. */
+    uint64_t jpegSign() {
         return ragephoto_getphotosign(instance);
     }
+    /** Returns the Photo JPEG signs of multiple Photos, hashed in parallel lanes. */
+    static void jpegSignMany(RagePhotoData **rp_data, size_t count, uint64_t *signs) {
+        ragephotodata_getphotosignmany(rp_data, count, signs);
+    }
     /** Returns the Photo JPEG data size. */
     uint32_t jpegSize() const {
         return ragephoto_getphotosize(instance);
@@ -236,6 +342,25 @@ public:
     bool save(char *data) {
         return ragephoto_save(instance, data);
     }
+    /** Saves a Photo as scatter-gather entries for writev() without copying the sections.
+    * \param iov Entries to fill
+    * \param count Number of entries available in \p iov
+    * \param buffer Buffer of #RAGEPHOTO_SAVEIOV_BUFFERSIZE bytes for the serialized header pieces
+    * \param photoFormat Photo Format (GTA V, RDR 2 or JPEG)
+    * \param rp_data Data object
+    * \return Number of entries of the Photo, 0 on error, only the first \p count entries are filled when it exceeds \p count
+    */
+    static size_t saveIov(RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat, RagePhotoData *rp_data) {
+        return ragephotodata_saveiovf(rp_data, iov, count, buffer, photoFormat);
+    }
+    /** Saves a Photo as scatter-gather entries. */
+    size_t saveIov(RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat) {
+        return ragephoto_saveiovf(instance, iov, count, buffer, photoFormat);
+    }
+    /** Saves a Photo as scatter-gather entries. */
+    size_t saveIov(RagePhotoIovec *iov, size_t count, char *buffer) {
+        return ragephoto_saveiov(instance, iov, count, buffer);
+    }
     /** Saves a Photo to a std::string.
     * \param photoFormat Photo Format (GTA V or RDR 2)
     * \param ok \p true when saved successfully
@@ -284,6 +409,10 @@ public:
     size_t saveSize() {
         return ragephoto_getsavesize(instance);
     }
+    /** Clears the Photo and sets the allocator used for its buffers, nullptr uses the library allocator. */
+    void setAllocator(const RagePhotoAllocator *allocator) {
+        ragephoto_setallocator(instance, allocator);
+    }
     /** Sets all cross-format Buffer to default size. */
     static void setBufferDefault(RagePhotoData *rp_data) {
         ragephotodata_setbufferdefault(rp_data);
@@ -300,7 +429,7 @@ public:
     void setBufferOffsets() {
         ragephoto_setbufferoffsets(instance);
     }
-    /** Sets the internal RagePhotoData object. */
+    /** Sets the internal RagePhotoData object, copies only read the sections of \p ragePhotoData. */
     bool setData(RagePhotoData *ragePhotoData, bool takeCopy = true) {
         if (takeCopy)
             return ragephoto_setphotodatac(instance, ragePhotoData);
@@ -311,6 +440,16 @@ public:
     void setDescription(const char *description, uint32_t bufferSize = 0) {
         ragephoto_setphotodesc(instance, description, bufferSize);
     }
+    /** Sets the Photo description with a known length. */
+    void setDescription(const char *description, size_t length, uint32_t bufferSize) {
+        ragephoto_setphotodescl(instance, description, length, bufferSize);
+    }
+#if (__cplusplus >= 201703L)
+    /** Sets the Photo description. */
+    void setDescription(std::string_view description, uint32_t bufferSize = 0) {
+        ragephoto_setphotodescl(instance, description.data(), description.size(), bufferSize);
+    }
+#endif
     /** Sets the Photo Format (GTA V or RDR 2). */
     void setFormat(uint32_t photoFormat) {
         ragephoto_setphotoformat(instance, photoFormat);
@@ -334,23 +473,283 @@ public:
     bool setJpeg(const std::string &data, uint32_t bufferSize = 0) {
         return ragephoto_setphotojpeg(instance, data.data(), static_cast<uint32_t>(data.size()), bufferSize);
     }
+    /** Sets the Photo JPEG data without copying it.
+    * \param data JPEG data, allocated with the allocator of the Photo
+    * \param size JPEG data size
+    * \param bufferSize JPEG buffer size
+    */
+    void adoptJpeg(char *data, uint32_t size, uint32_t bufferSize = 0) {
+        ragephoto_adoptphotojpeg(instance, data, size, bufferSize);
+    }
     /** Sets the Photo JSON data. */
     void setJson(const char *json, uint32_t bufferSize = 0) {
         ragephoto_setphotojson(instance, json, bufferSize);
     }
+    /** Sets the Photo JSON data with a known length. */
+    void setJson(const char *json, size_t length, uint32_t bufferSize) {
+        ragephoto_setphotojsonl(instance, json, length, bufferSize);
+    }
+#if (__cplusplus >= 201703L)
+    /** Sets the Photo JSON data. */
+    void setJson(std::string_view json, uint32_t bufferSize = 0) {
+        ragephoto_setphotojsonl(instance, json.data(), json.size(), bufferSize);
+    }
+#endif
+    /** Sets the Photo JSON data without copying it, the null-terminated buffer has to be allocated with the allocator of the Photo. */
+    void adoptJson(char *json, uint32_t bufferSize = 0) {
+        ragephoto_adoptphotojson(instance, json, bufferSize);
+    }
+    /** Sets the default allocator for Photo buffers, nullptr restores malloc. */
+    static void setLibraryAllocator(const RagePhotoAllocator *allocator) {
+        ragephoto_setlibraryallocator(allocator);
+    }
     /** Sets a library flag. */
     static void setLibraryFlag(RagePhotoLibraryFlag flag, bool state = true) {
         ragephoto_setlibraryflag(flag, state);
     }
+    /** Sets the section size limits applied when loading, nullptr restores the defaults. */
+    static void setSizeLimits(const RagePhotoSizeLimits *limits) {
+        ragephoto_setsizelimits(limits);
+    }
+    /** Returns the section size limits applied when loading. */
+    static void sizeLimits(RagePhotoSizeLimits *limits) {
+        ragephoto_getsizelimits(limits);
+    }
     /** Sets the Photo title. */
     void setTitle(const char *title, uint32_t bufferSize = 0) {
         ragephoto_setphototitle(instance, title, bufferSize);
     }
+    /** Sets the Photo title with a known length. */
+    void setTitle(const char *title, size_t length, uint32_t bufferSize) {
+        ragephoto_setphototitlel(instance, title, length, bufferSize);
+    }
+#if (__cplusplus >= 201703L)
+    /** Sets the Photo title. */
+    void setTitle(std::string_view title, uint32_t bufferSize = 0) {
+        ragephoto_setphototitlel(instance, title.data(), title.size(), bufferSize);
+    }
+#endif
+    /** Swaps the sections and parsers with a RagePhoto object. */
+    void swap(photo &ragePhoto) noexcept {
+        ragephoto_t t_instance = instance;
+        instance = ragePhoto.instance;
+        ragePhoto.instance = t_instance;
+    }
 
 private:
+    friend std::vector<std::unique_ptr<photo>> batch_load(const std::vector<std::string> &filenames, const RagePhotoBatchOptions &options);
     ragephoto_t instance;
 };
 
+/** Swaps the sections and parsers of two RagePhoto objects. */
+inline void swap(photo &ragePhoto, photo &ragePhoto2) noexcept
+{
+    ragePhoto.swap(ragePhoto2);
+}
+
+/** Loads multiple Photos from files in parallel.
+*
+* The files are distributed over a pool of worker threads, each worker reuses one read buffer for all files it loads.
+* \param filenames Files to load
+* \param options Batch load options
+* \return Photos in the order of \p filenames, errors are reported per Photo with photo::error()
+*/
+inline std::vector<std::unique_ptr<photo>> batch_load(const std::vector<std::string> &filenames, const RagePhotoBatchOptions &options = RagePhotoBatchOptions())
+{
+    std::vector<std::unique_ptr<photo>> photos;
+    std::vector<ragephoto_t> instances;
+    std::vector<const char*> filenamePointers;
+    photos.reserve(filenames.size());
+    instances.reserve(filenames.size());
+    filenamePointers.reserve(filenames.size());
+    for (const std::string &filename : filenames) {
+        photos.emplace_back(new photo);
+        instances.push_back(photos.back()->instance);
+        filenamePointers.push_back(filename.c_str());
+    }
+    ragephoto_loadmany(instances.data(), filenamePointers.data(), filenames.size(), &options);
+    return photos;
+}
+
+/**
+* \brief GTA V and RDR 2 Photo View, borrows all sections from the loaded buffer (C API wrapper).
+* \class ragephoto_c::photo_view RagePhoto.hpp RagePhoto
+*/
+class photo_view
+{
+public:
+    photo_view() {
+        memset(&m_view, 0, sizeof(RagePhotoView));
+        m_header[0] = '\0';
+    }
+    /** Loads a Photo view from a const char*. */
+    static bool load(const char *data, size_t size, RagePhotoView *rp_view) {
+        return ragephotoview_load(rp_view, data, size);
+    }
+    /** Loads a Photo view from a const char*.
+    * \param data Photo data, has to outlive the view
+    * \param size Photo data size
+    */
+    bool load(const char *data, size_t size) {
+        const bool isLoaded = ragephotoview_load(&m_view, data, size);
+        // Decoded once here, so reading the header of a const view writes nothing
+        if (!ragephotoview_getheader(&m_view, m_header, sizeof(m_header)))
+            m_header[0] = '\0';
+        return isLoaded;
+    }
+    /** Loads a Photo view from a std::string.
+    * \param data Photo data, has to outlive the view
+    */
+    bool load(const std::string &data) {
+        return load(data.data(), data.size());
+    }
+    /** Returns the internal RagePhotoView object. */
+    const RagePhotoView* data() const {
+        return &m_view;
+    }
+    /** Returns the last error occurred. */
+    int32_t error() const {
+        return m_view.error;
+    }
+    /** Returns the Photo Format (GTA V or RDR 2). */
+    uint32_t format() const {
+        return m_view.photoFormat;
+    }
+#if (__cplusplus >= 201703L)
+    /** Returns the Photo JPEG data. */
+    const std::string_view jpeg_view() const {
+        if (m_view.jpeg)
+            return std::string_view(m_view.jpeg, m_view.jpegSize);
+        else
+            return std::string_view();
+    }
+#endif
+    /** Returns the Photo JPEG data. */
+    const char* jpegData() const {
+        return m_view.jpeg;
+    }
+    /** Returns the Photo JPEG sign. */
+    static uint64_t jpegSign(uint32_t photoFormat, const RagePhotoView *rp_view) {
+        return ragephotoview_getphotosignf(rp_view, photoFormat);
+    }
+    /** Returns the Photo JPEG sign. */
+    uint64_t jpegSign(uint32_t photoFormat) const {
+        return ragephotoview_getphotosignf(&m_view, photoFormat);
+    }
+    /** Returns the Photo JPEG sign. */
+    uint64_t jpegSign() const {
+        return ragephotoview_getphotosign(&m_view);
+    }
+    /** Returns the Photo JPEG data size. */
+    uint32_t jpegSize() const {
+        return m_view.jpeg ? m_view.jpegSize : 0;
+    }
+    /** Returns the Photo description. */
+    const char* description() const {
+        return m_view.description;
+    }
+    /** Returns the Photo description size. */
+    size_t descriptionSize() const {
+        return sectionSize(m_view.description, m_view.descBuffer);
+    }
+    /** Returns the Photo header, decoded when loading. */
+    const char* header() const {
+        return m_header;
+    }
+    /** Returns the Photo JSON data. */
+    const char* json() const {
+        return m_view.json;
+    }
+    /** Returns the Photo JSON data size. */
+    size_t jsonSize() const {
+        return sectionSize(m_view.json, m_view.jsonBuffer);
+    }
+    /** Returns the Photo title. */
+    const char* title() const {
+        return m_view.title;
+    }
+    /** Returns the Photo title size. */
+    size_t titleSize() const {
+        return sectionSize(m_view.title, m_view.titlBuffer);
+    }
+
+private:
+    static size_t sectionSize(const char *section, uint32_t bufferSize) {
+        if (!section)
+            return 0;
+        const void *end = memchr(section, '\0', bufferSize);
+        return end ? static_cast<const char*>(end) - section : bufferSize;
+    }
+    RagePhotoView m_view;
+    char m_header[512];
+};
+
+/**
+* \brief GTA V and RDR 2 Photo push parser, loads a Photo from chunked input (C API wrapper).
+* \class ragephoto_c::photo_parser RagePhoto.hpp RagePhoto
+*/
+class photo_parser
+{
+public:
+    /** Photo sections */
+    enum Section : uint8_t {
+        Header = RAGEPHOTO_SECTION_HEADER, /**< Header, checksums and offsets, always loaded */
+        Jpeg = RAGEPHOTO_SECTION_JPEG, /**< JPEG section */
+        Json = RAGEPHOTO_SECTION_JSON, /**< JSON section */
+        Title = RAGEPHOTO_SECTION_TITLE, /**< Title section */
+        Description = RAGEPHOTO_SECTION_DESC, /**< Description section, completes with the JEND marker */
+        All = RAGEPHOTO_SECTION_ALL /**< All sections */
+    };
+    /** Push parser status */
+    enum Status : int32_t {
+        Error = RAGEPHOTO_PARSER_ERROR, /**< Parsing failed, see RagePhotoData::error */
+        Continue = RAGEPHOTO_PARSER_CONTINUE, /**< More data is required */
+        Finished = RAGEPHOTO_PARSER_FINISHED /**< All requested sections are loaded */
+    };
+    /** Initialises a push parser for loading a Photo.
+    * \param ragePhoto Photo object
+    * \param sections Sections to load
+    */
+    photo_parser(photo *ragePhoto, uint8_t sections = All) {
+        ragephotodata_parser_init(&m_parser, ragePhoto->data(), sections);
+    }
+    /** Initialises a push parser for loading a Photo.
+    * \param rp_data Data object
+    * \param sections Sections to load
+    */
+    photo_parser(RagePhotoData *rp_data, uint8_t sections = All) {
+        ragephotodata_parser_init(&m_parser, rp_data, sections);
+    }
+    /** Feeds a chunk of Photo data.
+    * \param data Photo data chunk
+    * \param size Photo data chunk size
+    */
+    Status feed(const char *data, size_t size) {
+        return static_cast<Status>(ragephoto_parser_feed(&m_parser, data, size));
+    }
+    /** Feeds a chunk of Photo data from a std::string.
+    * \param data Photo data chunk
+    */
+    Status feed(const std::string &data) {
+        return feed(data.data(), data.size());
+    }
+    /** Finishes the push parser at the end of input. */
+    bool finish() {
+        return ragephoto_parser_finish(&m_parser);
+    }
+    /** Returns the completed sections. */
+    uint8_t completed() const {
+        return m_parser.completed;
+    }
+    /** Returns the internal RagePhotoParser object. */
+    const RagePhotoParser* data() const {
+        return &m_parser;
+    }
+
+private:
+    RagePhotoParser m_parser;
+};
+
 } // ragephoto_c
 #endif // __cplusplus
 
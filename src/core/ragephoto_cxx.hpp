@@ -26,6 +26,9 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace ragephoto {
 
@@ -102,11 +105,24 @@ public:
         SIRDR2 = RAGEPHOTO_SIGNINITIAL_RDR2 /**< RDR 2 Sign Initial */
     };
     photo();
+    photo(const photo&) = delete;
+    photo(photo &&ragePhoto) noexcept; /**< Takes over the sections of a RagePhoto object, the moved-from object can only be assigned or destroyed. */
     ~photo();
+    photo& operator=(const photo&) = delete;
+    photo& operator=(photo &&ragePhoto) noexcept; /**< Swaps the sections with a RagePhoto object. */
     void addParser(RagePhotoFormatParser *rp_parser); /**< Add a custom defined RagePhotoFormatParser. */
+    bool adoptData(RagePhotoData *rp_data); /**< Takes ownership of a malloc allocated RagePhotoData object, the counterpart of releaseData(). */
+    static bool registerParser(const RagePhotoFormatParser *rp_parser); /**< Registers a custom defined RagePhotoFormatParser for all instances. */
+    static bool unregisterParser(uint32_t photoFormat); /**< Unregisters the custom defined RagePhotoFormatParser of a Photo Format. */
     static void clear(RagePhotoData *rp_data); /**< Resets the RagePhotoData object to default values. */
     void clear(); /**< Resets the RagePhotoData object to default values. */
+    bool copyData(const photo &ragePhoto); /**< Copies the sections of a RagePhoto object, arena storage sections are shared until they are changed. */
+    static void reset(RagePhotoData *rp_data); /**< Resets the RagePhotoData object to default values, keeping the section buffers for the next load. */
+    void reset(); /**< Resets the RagePhotoData object to default values, keeping the section buffers for the next load. */
+    static photo* acquire(); /**< Returns a pooled RagePhoto object, a new object is created when the pool is empty. */
+    static void release(photo *ragePhoto); /**< Resets a RagePhoto object and returns it to the pool, the object is deleted when the pool is full or it has a custom allocator. */
     RagePhotoData* data(); /**< Returns the internal RagePhotoData object. */
+    RagePhotoData* releaseData(); /**< Releases ownership of the internal RagePhotoData object and replaces it with an empty one, nullptr when it can't be allocated. */
     static bool load(const char *data, size_t size, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser); /**< Loads a Photo from a const char*. */
     /** Loads a Photo from a const char*.
     * \param data Photo data
@@ -121,6 +137,32 @@ public:
     * \param filename File to load
     */
     bool loadFile(const char *filename);
+    static bool loadMeta(const char *data, size_t size, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser); /**< Loads the metadata of a Photo from a const char*, skipping the JPEG data. */
+    /** Loads the metadata of a Photo from a const char*, skipping the JPEG data.
+    * \param data Photo data
+    * \param size Photo data size
+    */
+    bool loadMeta(const char *data, size_t size);
+    /** Loads the metadata of a Photo from a std::string, skipping the JPEG data.
+    * \param data Photo data
+    */
+    bool loadMeta(const std::string &data);
+    /** Loads the metadata of a Photo from a file, only the header and metadata sections are read.
+    * \param filename File to load
+    */
+    bool loadMetaFile(const char *filename);
+    /** Loads the metadata of a Photo from a file descriptor, only the header and metadata sections are read.
+    *
+    * On POSIX systems the sections are read with pread and the file position is kept, the descriptor stays open.
+    * \param fd File descriptor to load from
+    */
+    bool loadMetaFd(int fd);
+    /** Validates the structure of a Photo without allocating, the header is decoded into a stack buffer.
+    * \param data Photo data
+    * \param size Photo data size
+    * \param rp_validation Validation report
+    */
+    static bool validate(const char *data, size_t size, RagePhotoValidation *rp_validation);
     int32_t error() const; /**< Returns the last error occurred. */
     uint32_t format() const; /**< Returns the Photo Format (GTA V or RDR 2). */
     const std::string jpeg() const; /**< Returns the Photo JPEG data. */
@@ -128,10 +170,13 @@ public:
     const std::string_view jpeg_view() const; /**< Returns the Photo JPEG data. */
 #endif
     const char* jpegData() const; /**< Returns the Photo JPEG data. */
-    static uint64_t jpegSign(uint32_t photoFormat, RagePhotoData *rp_data); /**< Returns the Photo JPEG sign. */
-    static uint64_t jpegSign(RagePhotoData *rp_data); /**< Returns the Photo JPEG sign. */
-    uint64_t jpegSign(uint32_t photoFormat) const; /**< Returns the Photo JPEG sign. */
-    uint64_t jpegSign() const; /**< Returns the Photo JPEG sign. */
+    static uint64_t jpegSign(uint32_t photoFormat, RagePhotoData *rp_data); /**< Returns the Photo JPEG sign, cached per Photo Format until the JPEG is changed. */
+    static uint64_t jpegSign(RagePhotoData *rp_data); /**< Returns the Photo JPEG sign, cached per Photo Format until the JPEG is changed. */
+    uint64_t jpegSign(uint32_t photoFormat) const; /**< Returns the Photo JPEG sign, the cache is only read and a missing sign is computed without storing it. */
+    uint64_t jpegSign() const; /**< Returns the Photo JPEG sign, the cache is only read and a missing sign is computed without storing it. */
+    uint64_t jpegSign(uint32_t photoFormat); /**< Returns the Photo JPEG sign, cached per Photo Format until the JPEG is changed. */
+    uint64_t jpegSign(); /**< Returns the Photo JPEG sign, cached per Photo Format until the JPEG is changed. */
+    static void jpegSignMany(RagePhotoData **rp_data, size_t count, uint64_t *signs); /**< Returns the Photo JPEG signs of multiple Photos, hashed in parallel lanes. */
     uint32_t jpegSize() const; /**< Returns the Photo JPEG data size. */
     const char* description() const; /**< Returns the Photo description. */
     const char* header() const; /**< Returns the Photo header. */
@@ -149,6 +194,17 @@ public:
     * \param data Photo data
     */
     bool save(char *data);
+    /** Saves a Photo as scatter-gather entries for writev() without copying the sections.
+    * \param iov Entries to fill
+    * \param count Number of entries available in \p iov
+    * \param buffer Buffer of #RAGEPHOTO_SAVEIOV_BUFFERSIZE bytes for the serialized header pieces
+    * \param photoFormat Photo Format (GTA V, RDR 2 or JPEG)
+    * \param rp_data Data object
+    * \return Number of entries of the Photo, 0 on error, only the first \p count entries are filled when it exceeds \p count
+    */
+    static size_t saveIov(RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat, RagePhotoData *rp_data);
+    size_t saveIov(RagePhotoIovec *iov, size_t count, char *buffer, uint32_t photoFormat); /**< Saves a Photo as scatter-gather entries. */
+    size_t saveIov(RagePhotoIovec *iov, size_t count, char *buffer); /**< Saves a Photo as scatter-gather entries. */
     /** Saves a Photo to a std::string.
     * \param photoFormat Photo Format (GTA V or RDR 2)
     * \param ok \p true when saved successfully
@@ -164,12 +220,17 @@ public:
     static size_t saveSize(RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser); /**< Returns the Photo save file size. */
     size_t saveSize(uint32_t photoFormat); /**< Returns the Photo save file size. */
     size_t saveSize(); /**< Returns the Photo save file size. */
+    void setAllocator(const RagePhotoAllocator *allocator); /**< Clears the Photo and sets the allocator used for its buffers, nullptr uses the library allocator. */
     static void setBufferDefault(RagePhotoData *rp_data); /**< Sets all cross-format Buffer to default size. */
     void setBufferDefault(); /**< Sets all cross-format Buffer to default size. */
     static void setBufferOffsets(RagePhotoData *rp_data); /**< Moves all Buffer offsets to correct position. */
     void setBufferOffsets(); /**< Moves all Buffer offsets to correct position. */
-    bool setData(RagePhotoData *rp_data, bool takeCopy = true); /**< Sets the internal RagePhotoData object. */
+    bool setData(RagePhotoData *rp_data, bool takeCopy = true); /**< Sets the internal RagePhotoData object, copies only read the sections of \p rp_data. */
     void setDescription(const char *description, uint32_t bufferSize = 0); /**< Sets the Photo description. */
+    void setDescription(const char *description, size_t length, uint32_t bufferSize); /**< Sets the Photo description with a known length. */
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+    void setDescription(std::string_view description, uint32_t bufferSize = 0); /**< Sets the Photo description. */
+#endif
     void setFormat(uint32_t photoFormat); /**< Sets the Photo Format (GTA V or RDR 2). */
     void setHeader(const char *header, uint32_t headerSum, uint32_t headerSum2 = 0); /**< Sets the Photo header. */
     /** Sets the Photo JPEG data.
@@ -183,15 +244,145 @@ public:
     * \param bufferSize JPEG buffer size
     */
     bool setJpeg(const std::string &data, uint32_t bufferSize = 0);
+    /** Sets the Photo JPEG data without copying it.
+    * \param data JPEG data, allocated with the allocator of the Photo
+    * \param size JPEG data size
+    * \param bufferSize JPEG buffer size
+    */
+    void adoptJpeg(char *data, uint32_t size, uint32_t bufferSize = 0);
     void setJson(const char *json, uint32_t bufferSize = 0); /**< Sets the Photo JSON data. */
+    void setJson(const char *json, size_t length, uint32_t bufferSize); /**< Sets the Photo JSON data with a known length. */
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+    void setJson(std::string_view json, uint32_t bufferSize = 0); /**< Sets the Photo JSON data. */
+#endif
+    void adoptJson(char *json, uint32_t bufferSize = 0); /**< Sets the Photo JSON data without copying it, the null-terminated buffer has to be allocated with the allocator of the Photo. */
+    static void setLibraryAllocator(const RagePhotoAllocator *allocator); /**< Sets the default allocator for Photo buffers, nullptr restores malloc. */
     static void setLibraryFlag(RagePhotoLibraryFlag flag, bool state = true); /**< Sets a library flag. */
+    static void setSizeLimits(const RagePhotoSizeLimits *limits); /**< Sets the section size limits applied when loading, nullptr restores the defaults. */
+    static void sizeLimits(RagePhotoSizeLimits *limits); /**< Returns the section size limits applied when loading. */
     void setTitle(const char *title, uint32_t bufferSize = 0); /**< Sets the Photo title. */
+    void setTitle(const char *title, size_t length, uint32_t bufferSize); /**< Sets the Photo title with a known length. */
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+    void setTitle(std::string_view title, uint32_t bufferSize = 0); /**< Sets the Photo title. */
+#endif
+    void swap(photo &ragePhoto) noexcept; /**< Swaps the sections and parsers with a RagePhoto object. */
 
 private:
+    static bool loadData(const char *data, size_t size, RagePhotoData *rp_data, RagePhotoFormatParser *rp_parser, bool loadJpeg);
     RagePhotoData *m_data;
     RagePhotoFormatParser *m_parser;
 };
 
+/** Swaps the sections and parsers of two RagePhoto objects. */
+inline void swap(photo &ragePhoto, photo &ragePhoto2) noexcept
+{
+    ragePhoto.swap(ragePhoto2);
+}
+
+/**
+* \brief GTA V and RDR 2 Photo View, borrows all sections from the loaded buffer.
+* \class ragephoto::photo_view RagePhoto.hpp RagePhoto
+*/
+class LIBRAGEPHOTO_CXX_PUBLIC photo_view
+{
+public:
+    photo_view();
+    static bool load(const char *data, size_t size, RagePhotoView *rp_view); /**< Loads a Photo view from a const char*. */
+    /** Loads a Photo view from a const char*.
+    * \param data Photo data, has to outlive the view
+    * \param size Photo data size
+    */
+    bool load(const char *data, size_t size);
+    /** Loads a Photo view from a std::string.
+    * \param data Photo data, has to outlive the view
+    */
+    bool load(const std::string &data);
+    const RagePhotoView* data() const; /**< Returns the internal RagePhotoView object. */
+    int32_t error() const; /**< Returns the last error occurred. */
+    uint32_t format() const; /**< Returns the Photo Format (GTA V or RDR 2). */
+#if (RAGEPHOTO_CXX_STD >= 17) && (__cplusplus >= 201703L)
+    const std::string_view jpeg_view() const; /**< Returns the Photo JPEG data. */
+#endif
+    const char* jpegData() const; /**< Returns the Photo JPEG data. */
+    static uint64_t jpegSign(uint32_t photoFormat, const RagePhotoView *rp_view); /**< Returns the Photo JPEG sign. */
+    uint64_t jpegSign(uint32_t photoFormat) const; /**< Returns the Photo JPEG sign. */
+    uint64_t jpegSign() const; /**< Returns the Photo JPEG sign. */
+    uint32_t jpegSize() const; /**< Returns the Photo JPEG data size. */
+    const char* description() const; /**< Returns the Photo description. */
+    size_t descriptionSize() const; /**< Returns the Photo description size. */
+    static bool header(const RagePhotoView *rp_view, char *data, size_t size); /**< Decodes the Photo header. */
+    const char* header() const; /**< Returns the Photo header, decoded when loading. */
+    const char* json() const; /**< Returns the Photo JSON data. */
+    size_t jsonSize() const; /**< Returns the Photo JSON data size. */
+    const char* title() const; /**< Returns the Photo title. */
+    size_t titleSize() const; /**< Returns the Photo title size. */
+
+private:
+    RagePhotoView m_view;
+    std::string m_header;
+};
+
+/**
+* \brief GTA V and RDR 2 Photo push parser, loads a Photo from chunked input.
+* \class ragephoto::photo_parser RagePhoto.hpp RagePhoto
+*/
+class LIBRAGEPHOTO_CXX_PUBLIC photo_parser
+{
+public:
+    /** Photo sections */
+    enum Section : uint8_t {
+        Header = RAGEPHOTO_SECTION_HEADER, /**< Header, checksums and offsets, always loaded */
+        Jpeg = RAGEPHOTO_SECTION_JPEG, /**< JPEG section */
+        Json = RAGEPHOTO_SECTION_JSON, /**< JSON section */
+        Title = RAGEPHOTO_SECTION_TITLE, /**< Title section */
+        Description = RAGEPHOTO_SECTION_DESC, /**< Description section, completes with the JEND marker */
+        All = RAGEPHOTO_SECTION_ALL /**< All sections */
+    };
+    /** Push parser status */
+    enum Status : int32_t {
+        Error = RAGEPHOTO_PARSER_ERROR, /**< Parsing failed, see RagePhotoData::error */
+        Continue = RAGEPHOTO_PARSER_CONTINUE, /**< More data is required */
+        Finished = RAGEPHOTO_PARSER_FINISHED /**< All requested sections are loaded */
+    };
+    /** Initialises a push parser for loading a Photo.
+    * \param ragePhoto Photo object
+    * \param sections Sections to load
+    */
+    photo_parser(photo *ragePhoto, uint8_t sections = All);
+    /** Initialises a push parser for loading a Photo.
+    * \param rp_data Data object
+    * \param sections Sections to load
+    */
+    photo_parser(RagePhotoData *rp_data, uint8_t sections = All);
+    static void init(RagePhotoData *rp_data, uint8_t sections, RagePhotoParser *rp_stream); /**< Initialises a push parser. */
+    static Status feed(const char *data, size_t size, RagePhotoParser *rp_stream); /**< Feeds a chunk of Photo data. */
+    /** Feeds a chunk of Photo data.
+    * \param data Photo data chunk
+    * \param size Photo data chunk size
+    */
+    Status feed(const char *data, size_t size);
+    /** Feeds a chunk of Photo data from a std::string.
+    * \param data Photo data chunk
+    */
+    Status feed(const std::string &data);
+    static bool finish(RagePhotoParser *rp_stream); /**< Finishes a push parser at the end of input. */
+    bool finish(); /**< Finishes the push parser at the end of input. */
+    uint8_t completed() const; /**< Returns the completed sections. */
+    const RagePhotoParser* data() const; /**< Returns the internal RagePhotoParser object. */
+
+private:
+    RagePhotoParser m_parser;
+};
+
+/** Loads multiple Photos from files in parallel.
+*
+* The files are distributed over a pool of worker threads, each worker reuses one read buffer for all files it loads.
+* \param filenames Files to load
+* \param options Batch load options
+* \return Photos in the order of \p filenames, errors are reported per Photo with photo::error()
+*/
+LIBRAGEPHOTO_CXX_PUBLIC std::vector<std::unique_ptr<photo>> batch_load(const std::vector<std::string> &filenames, const RagePhotoBatchOptions &options = RagePhotoBatchOptions());
+
 } // ragephoto
 #endif // __cplusplus
 
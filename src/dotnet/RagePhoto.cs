@@ -21,8 +21,14 @@ namespace RagePhoto {
         private static extern Boolean ragephoto_load(IntPtr instance, Byte[] data, UIntPtr size);
         [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
         [return: MarshalAs(UnmanagedType.I1)]
+        private static extern Boolean ragephoto_loadmeta(IntPtr instance, Byte[] data, UIntPtr size);
+        [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+        [return: MarshalAs(UnmanagedType.I1)]
         private static extern Boolean ragephoto_loadfile(IntPtr instance, [MarshalAs(UnmanagedType.LPUTF8Str)] String filename);
         [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern Boolean ragephoto_loadmetafile(IntPtr instance, [MarshalAs(UnmanagedType.LPUTF8Str)] String filename);
+        [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
         private static extern Int32 ragephoto_error(IntPtr instance);
         [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
         private static extern IntPtr ragephoto_getphotodata(IntPtr instance);
@@ -39,6 +45,8 @@ namespace RagePhoto {
         [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
         private static extern UInt64 ragephoto_getphotosign(IntPtr instance);
         [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+        private static extern UInt64 ragephoto_getphotosignf(IntPtr instance, UInt32 photoFormat);
+        [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
         private static extern UInt32 ragephoto_getphotosize(IntPtr instance);
         [DllImport(_library, CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
         private static extern IntPtr ragephoto_getphototitle(IntPtr instance);
@@ -130,11 +138,21 @@ namespace RagePhoto {
                 throw new RagePhotoException(this, "Failed to load Photo", Error);
         }
 
+        public void LoadMeta(Byte[] data) {
+            if (!ragephoto_loadmeta(_instance, data, (UIntPtr)data.LongLength))
+                throw new RagePhotoException(this, "Failed to load Photo", Error);
+        }
+
         public void LoadFile(String path) {
             if (!ragephoto_loadfile(_instance, path))
                 throw new RagePhotoException(this, "Failed to load Photo", Error);
         }
 
+        public void LoadMetaFile(String path) {
+            if (!ragephoto_loadmetafile(_instance, path))
+                throw new RagePhotoException(this, "Failed to load Photo", Error);
+        }
+
         public String Description {
             get => PtrToStringUTF8(ragephoto_getphotodesc(_instance));
             set => ragephoto_setphotodesc(_instance, value, (UInt32)DefaultSize.DEFAULT_DESCBUFFER);
@@ -205,6 +223,14 @@ namespace RagePhoto {
             return ragephoto_getsavesizef(_instance, (UInt32)photoFormat);
         }
 
+        public UInt64 GetSign() {
+            return ragephoto_getphotosign(_instance);
+        }
+
+        public UInt64 GetSign(PhotoFormat photoFormat) {
+            return ragephoto_getphotosignf(_instance, (UInt32)photoFormat);
+        }
+
         public Byte[] Save() {
             Byte[] photo = new Byte[Environment.Is64BitProcess ? (UInt64)GetSaveSize() : (UInt32)GetSaveSize()];
             if (!ragephoto_save(_instance, photo))
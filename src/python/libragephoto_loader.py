@@ -41,8 +41,12 @@ libragephoto.ragephoto_clear.argtypes = [c_void_p]
 libragephoto.ragephoto_close.argtypes = [c_void_p]
 libragephoto.ragephoto_load.argtypes = [c_void_p, POINTER(c_char), c_size_t]
 libragephoto.ragephoto_load.restype = c_bool
+libragephoto.ragephoto_loadmeta.argtypes = [c_void_p, POINTER(c_char), c_size_t]
+libragephoto.ragephoto_loadmeta.restype = c_bool
 libragephoto.ragephoto_loadfile.argtypes = [c_void_p, c_char_p]
 libragephoto.ragephoto_loadfile.restype = c_bool
+libragephoto.ragephoto_loadmetafile.argtypes = [c_void_p, c_char_p]
+libragephoto.ragephoto_loadmetafile.restype = c_bool
 libragephoto.ragephoto_error.argtypes = [c_void_p]
 libragephoto.ragephoto_error.restype = c_int32
 libragephoto.ragephoto_getphotodesc.argtypes = [c_void_p]
@@ -97,12 +97,21 @@ class RagePhoto:
   def load(self, data):
     return libragephoto.ragephoto_load(self.__instance, data, len(data))
 
+  def loadMeta(self, data):
+    return libragephoto.ragephoto_loadmeta(self.__instance, data, len(data))
+
   def loadFile(self, file):
     if isinstance(file, str):
       return libragephoto.ragephoto_loadfile(self.__instance, file.encode())
     else:
       return libragephoto.ragephoto_loadfile(self.__instance, file)
 
+  def loadMetaFile(self, file):
+    if isinstance(file, str):
+      return libragephoto.ragephoto_loadmetafile(self.__instance, file.encode())
+    else:
+      return libragephoto.ragephoto_loadmetafile(self.__instance, file)
+
   def error(self):
     return libragephoto.ragephoto_error(self.__instance)
 
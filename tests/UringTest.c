@@ -0,0 +1,31 @@
+/*****************************************************************************
+* libragephoto RAGE Photo Parser
+* Copyright (C) 2025 Syping
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* This software is provided as-is, no warranties are given to you, we are not
+* responsible for anything with use of the software, you are self responsible.
+*****************************************************************************/
+
+#include <string.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+int main(int argc, char *argv[])
+{
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_OPENAT;
+    sqe.open_flags = 0;
+    sqe.opcode = IORING_OP_READ;
+    return (__NR_io_uring_setup && __NR_io_uring_enter) ? 0 : 1;
+}